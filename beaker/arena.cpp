@@ -0,0 +1,100 @@
+#include "arena.hpp"
+
+#include <algorithm>
+
+namespace beaker
+{
+  /// The size of the blocks allocated by the arena. Larger requests are
+  /// given a block of their own.
+  static constexpr std::size_t block_size = 64 << 10;
+
+  /// The header of each block. The block's memory follows the header.
+  struct Arena::Block
+  {
+    Block* prev;
+  };
+
+  /// Records the destructor of an object in the arena.
+  struct Arena::Cleanup
+  {
+    Cleanup* prev;
+    void* obj;
+    void (*fn)(void*);
+  };
+
+  Arena::Arena()
+    : m_blocks(), m_cleanups(), m_next(), m_avail(0), m_size(0), m_capacity(0)
+  { }
+
+  Arena::~Arena()
+  {
+    for (Cleanup* c = m_cleanups; c; c = c->prev)
+      c->fn(c->obj);
+    while (m_blocks) {
+      Block* b = m_blocks;
+      m_blocks = b->prev;
+      ::operator delete(b);
+    }
+  }
+
+  /// Allocates a new block. A request that would not fit in an ordinary
+  /// block is given a block of its own, and the current block remains
+  /// available.
+  void*
+  Arena::allocate_slow(std::size_t n, std::size_t a)
+  {
+    std::size_t len = sizeof(Block) + n + a;
+    std::size_t size = std::max(len, block_size);
+    Block* b = static_cast<Block*>(::operator new(size));
+    b->prev = m_blocks;
+    m_blocks = b;
+    m_capacity += size;
+
+    char* p = reinterpret_cast<char*>(b + 1);
+    if (len > block_size) {
+      std::size_t pad = -reinterpret_cast<std::size_t>(p) & (a - 1);
+      m_size += n;
+      return p + pad;
+    }
+    m_next = p;
+    m_avail = size - sizeof(Block);
+    return allocate(n, a);
+  }
+
+  /// The blocks and destructors of `a` are linked in front of ours. The
+  /// order of destruction between the two arenas is unspecified, and the
+  /// current block of this arena remains available.
+  void
+  Arena::merge(Arena& a)
+  {
+    if (Block* b = a.m_blocks) {
+      while (b->prev)
+        b = b->prev;
+      b->prev = m_blocks;
+      m_blocks = a.m_blocks;
+    }
+    if (Cleanup* c = a.m_cleanups) {
+      while (c->prev)
+        c = c->prev;
+      c->prev = m_cleanups;
+      m_cleanups = a.m_cleanups;
+    }
+    m_size += a.m_size;
+    m_capacity += a.m_capacity;
+
+    a.m_blocks = nullptr;
+    a.m_cleanups = nullptr;
+    a.m_next = nullptr;
+    a.m_avail = 0;
+    a.m_size = 0;
+    a.m_capacity = 0;
+  }
+
+  void
+  Arena::add_cleanup(void* obj, void (*fn)(void*))
+  {
+    void* p = allocate(sizeof(Cleanup), alignof(Cleanup));
+    m_cleanups = new (p) Cleanup{m_cleanups, obj, fn};
+  }
+
+} // namespace beaker
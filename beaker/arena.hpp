@@ -0,0 +1,117 @@
+#pragma once
+
+#include <beaker/span.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace beaker
+{
+  /// Determines whether an object of type T must be destroyed when its
+  /// arena is released. This is specialized for polymorphic classes whose
+  /// destructors, though not trivial, have no effect.
+  template<typename T, typename = void>
+  struct Arena_destroy
+    : std::integral_constant<bool, !std::is_trivially_destructible<T>::value>
+  { };
+
+
+  /// A region of memory from which objects are allocated by incrementing a
+  /// pointer through large blocks. Objects are never freed individually;
+  /// all memory is released at once when the arena is destroyed.
+  ///
+  /// Objects that must be destroyed (see Arena_destroy) have their
+  /// destructors run when the arena is released, in reverse order of
+  /// creation. The record of those destructors is itself allocated in the
+  /// arena.
+  ///
+  /// Arenas are not thread-safe.
+  class Arena
+  {
+  public:
+    Arena();
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /// Returns `n` bytes of uninitialized memory aligned for `a`, which
+    /// must be a power of 2.
+    void* allocate(std::size_t n, std::size_t a)
+    {
+      std::size_t pad = -reinterpret_cast<std::size_t>(m_next) & (a - 1);
+      if (n + pad > m_avail)
+        return allocate_slow(n, a);
+      void* p = m_next + pad;
+      m_next += n + pad;
+      m_avail -= n + pad;
+      m_size += n;
+      return p;
+    }
+
+    /// Creates a new object of type T in the arena.
+    template<typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+      void* p = allocate(sizeof(T), alignof(T));
+      T* obj = new (p) T(std::forward<Args>(args)...);
+      if (Arena_destroy<T>::value)
+        add_cleanup(obj, [](void* q) { static_cast<T*>(q)->~T(); });
+      return obj;
+    }
+
+    /// Copies the objects in `v` into the arena and returns a span of the
+    /// copies. The objects must be trivially copyable, so that the copies
+    /// never need to be destroyed.
+    template<typename T>
+    Span<T> make_span(const std::vector<T>& v)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "cannot copy into a span");
+      if (v.empty())
+        return Span<T>();
+      void* p = allocate(sizeof(T) * v.size(), alignof(T));
+      std::memcpy(p, v.data(), sizeof(T) * v.size());
+      return Span<T>(static_cast<T*>(p), v.size());
+    }
+
+    /// Takes the objects of `a`, which is left empty. The objects are
+    /// released with this arena.
+    void merge(Arena& a);
+
+    /// Returns the number of bytes allocated for objects.
+    std::size_t size() const { return m_size; }
+
+    /// Returns the number of bytes reserved in blocks.
+    std::size_t capacity() const { return m_capacity; }
+
+  private:
+    struct Block;
+    struct Cleanup;
+
+    void* allocate_slow(std::size_t n, std::size_t a);
+    void add_cleanup(void* obj, void (*fn)(void*));
+
+    /// The most recently allocated block.
+    Block* m_blocks;
+
+    /// The most recently registered destructor.
+    Cleanup* m_cleanups;
+
+    /// The next free byte in the current block.
+    char* m_next;
+
+    /// The number of free bytes in the current block.
+    std::size_t m_avail;
+
+    /// The number of bytes allocated for objects.
+    std::size_t m_size;
+
+    /// The number of bytes reserved in blocks.
+    std::size_t m_capacity;
+  };
+
+} // namespace beaker
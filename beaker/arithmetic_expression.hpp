@@ -8,6 +8,8 @@ namespace beaker
   class Addition_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == add_kind; }
+
     Addition_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(add_kind, t, lhs, rhs, op)
     { }
@@ -18,6 +20,8 @@ namespace beaker
   class Subtraction_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == sub_kind; }
+
     Subtraction_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(sub_kind, t, lhs, rhs, op)
     { }
@@ -28,6 +32,8 @@ namespace beaker
   class Negation_expression : public Unary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == neg_kind; }
+
     Negation_expression(Type* t, Expression* e, const Token& op)
       : Unary_operator(neg_kind, t, e, op)
     { }
@@ -38,6 +44,8 @@ namespace beaker
   class Multiplication_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == mul_kind; }
+
     Multiplication_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(mul_kind, t, lhs, rhs, op)
     { }
@@ -48,6 +56,8 @@ namespace beaker
   class Quotient_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == quo_kind; }
+
     Quotient_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(quo_kind, t, lhs, rhs, op)
     { }
@@ -59,6 +69,8 @@ namespace beaker
   class Remainder_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == rem_kind; }
+
     Remainder_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(rem_kind, t, lhs, rhs, op)
     { }
@@ -73,6 +85,8 @@ namespace beaker
   class Division_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == div_kind; }
+
     Division_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(rem_kind, t, lhs, rhs, op)
     { }
@@ -83,6 +97,8 @@ namespace beaker
   class Reciprocal_expression : public Unary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == rec_kind; }
+
     Reciprocal_expression(Type* t, Expression* e, const Token& op)
       : Unary_operator(rec_kind, t, e, op)
     { }
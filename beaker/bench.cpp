@@ -0,0 +1,561 @@
+#include <beaker/context.hpp>
+#include <beaker/file.hpp>
+#include <beaker/lexer.hpp>
+#include <beaker/module_parser.hpp>
+#include <beaker/declaration.hpp>
+#include <beaker/snapshot.hpp>
+#include <beaker/type.hpp>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace beaker;
+
+using Clock = std::chrono::steady_clock;
+
+/// Options shared by all benchmarks.
+struct Options
+{
+  /// The number of times each benchmark is repeated. The fastest run is
+  /// reported.
+  int runs = 5;
+
+  /// The number of threads used to lex each file.
+  unsigned jobs = 1;
+
+  /// The approximate size of the generated input, in bytes.
+  std::size_t size = 4 << 20;
+
+  /// The input files. If empty, an input is generated.
+  std::vector<std::string> inputs;
+};
+
+/// Returns the number of seconds elapsed since `start`.
+static double
+get_seconds(Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// Receives the results of timed loops, so that they are not discarded.
+static volatile std::size_t sink;
+
+/// A generated input file, removed when the benchmark finishes.
+struct Generated_input
+{
+  Generated_input(std::size_t size);
+  ~Generated_input() { llvm::sys::fs::remove(path); }
+
+  std::string path;
+};
+
+/// Writes a program of roughly `size` bytes whose mix of keywords,
+/// identifiers, literals, and punctuation resembles ordinary source code.
+Generated_input::Generated_input(std::size_t size)
+{
+  int fd;
+  llvm::SmallString<128> tmp;
+  if (std::error_code ec = llvm::sys::fs::createTemporaryFile("beaker-bench", "bkr", fd, tmp))
+    throw std::runtime_error("cannot create input file: " + ec.message());
+  path = tmp.str().str();
+
+  llvm::raw_fd_ostream os(fd, true);
+  for (std::size_t n = 0; os.tell() < size; ++n) {
+    os << "# Computes a value from a and b (" << n << ").\n"
+       << "#\n"
+       << "# The result is reduced modulo 7 so that callers can combine the\n"
+       << "# results of several computations without overflowing.\n"
+       << "func compute_" << n << "(a : int, val b : int, ref c : bool) -> int\n"
+       << "{\n"
+       << "  var total : int = a + b * " << n % 97 << ";\n"
+       << "  var count : int = 0x" << n % 4096 << ";\n"
+       << "  if (c && total < 1000) {\n"
+       << "    return total;\n"
+       << "  }\n"
+       << "  else {\n"
+       << "    total = total - b;\n"
+       << "  }\n"
+       << "  while (count != 0 || false) {\n"
+       << "    count = count - 1;\n"
+       << "  }\n"
+       << "  assert(total >= 0);\n"
+       << "  return total % 7;\n"
+       << "}\n\n";
+  }
+}
+
+/// Returns the number of bytes in the inputs.
+static std::uint64_t
+get_input_size(const std::vector<const File*>& files)
+{
+  std::uint64_t n = 0;
+  for (const File* f : files)
+    n += f->get_text().size();
+  return n;
+}
+
+static void
+report(const char* what, double secs, std::uint64_t bytes, std::uint64_t items, const char* unit)
+{
+  std::cout << std::left << std::setw(24) << what << std::right
+            << std::fixed << std::setprecision(3)
+            << std::setw(10) << secs * 1000 << " ms"
+            << std::setw(10) << bytes / secs / (1 << 20) << " MiB/s"
+            << std::setw(10) << items / secs / 1e6 << " M" << unit << "/s\n";
+}
+
+/// Measures the throughput of the lexer, including the construction of the
+/// token buffer.
+static void
+bench_lex(Context& cxt, const Options& opts, const std::vector<const File*>& files)
+{
+  double best = 0;
+  std::uint64_t tokens = 0;
+  for (int i = 0; i < opts.runs; ++i) {
+    tokens = 0;
+    Clock::time_point start = Clock::now();
+    for (const File* f : files) {
+      Token_buffer toks = lex_file(cxt, *f, opts.jobs);
+      tokens += toks.size() - 1;
+    }
+    double secs = get_seconds(start);
+    if (i == 0 || secs < best)
+      best = secs;
+  }
+  report("lex", best, get_input_size(files), tokens, "tokens");
+}
+
+/// Returns the words (identifiers and keywords) in `files`.
+static std::vector<Text_view>
+get_words(const std::vector<const File*>& files)
+{
+  std::vector<Text_view> words;
+  for (const File* f : files) {
+    const char* p = f->get_text().begin();
+    const char* end = f->get_text().end();
+    while (p != end) {
+      if (*p == '#') {
+        p = std::find(p, end, '\n');
+        continue;
+      }
+      if (std::isalpha(*p) || *p == '_') {
+        const char* start = p;
+        while (p != end && (std::isalnum(*p) || *p == '_'))
+          ++p;
+        words.emplace_back(start, p);
+        continue;
+      }
+      if (std::isdigit(*p)) {
+        while (p != end && std::isalnum(*p))
+          ++p;
+        continue;
+      }
+      ++p;
+    }
+  }
+  return words;
+}
+
+/// Compares keyword classification by interning every word and probing a
+/// map of reserved symbols with classification by the perfect hash, which
+/// interns only identifiers.
+static void
+bench_keywords(Context& cxt, const Options& opts, const std::vector<const File*>& files)
+{
+  std::vector<Text_view> words = get_words(files);
+  std::uint64_t bytes = 0;
+  for (Text_view w : words)
+    bytes += w.size();
+
+  std::unordered_map<Symbol, Token::Name> reserved;
+  for (int n = Token::auto_kw; n <= Token::while_kw; ++n) {
+    Token::Name k = static_cast<Token::Name>(n);
+    reserved.emplace(cxt.get_symbol(Token::get_token_spelling(k)), k);
+  }
+
+  double map_time = 0;
+  double hash_time = 0;
+  std::size_t map_kws = 0;
+  std::size_t hash_kws = 0;
+  for (int i = 0; i < opts.runs; ++i) {
+    map_kws = 0;
+    Clock::time_point start = Clock::now();
+    for (Text_view w : words) {
+      Symbol sym = cxt.get_symbol(w.data(), w.size());
+      if (reserved.find(sym) != reserved.end())
+        ++map_kws;
+    }
+    double secs = get_seconds(start);
+    if (i == 0 || secs < map_time)
+      map_time = secs;
+
+    hash_kws = 0;
+    start = Clock::now();
+    for (Text_view w : words) {
+      if (get_keyword(w.begin(), w.end()) != Token::identifier)
+        ++hash_kws;
+      else
+        cxt.get_symbol(w.data(), w.size());
+    }
+    secs = get_seconds(start);
+    if (i == 0 || secs < hash_time)
+      hash_time = secs;
+  }
+  if (map_kws != hash_kws)
+    throw std::runtime_error("keyword classifications differ");
+
+  std::cout << words.size() << " words, " << hash_kws << " keywords\n";
+  report("intern + map", map_time, bytes, words.size(), "words");
+  report("perfect hash", hash_time, bytes, words.size(), "words");
+}
+
+/// A function signature: its parameter types and return type.
+using Signature = std::pair<Type_seq, Type*>;
+
+/// Returns the signatures whose parameters (at most `n`) and results are
+/// drawn from the builtin object types and references to them.
+static std::vector<Signature>
+get_signatures(Context& cxt, std::size_t n)
+{
+  std::vector<Type*> objs {
+    cxt.get_bool_type(), cxt.get_int_type(), cxt.get_float_type()
+  };
+  std::vector<Type*> parms = objs;
+  for (Type* t : objs)
+    parms.push_back(cxt.get_reference_type(t));
+  std::vector<Type*> rets = parms;
+  rets.push_back(cxt.get_unit_type());
+
+  std::vector<Signature> sigs;
+  std::vector<Type_seq> seqs {Type_seq()};
+  for (std::size_t i = 0; i <= n; ++i) {
+    std::vector<Type_seq> next;
+    for (const Type_seq& ts : seqs) {
+      for (Type* r : rets)
+        sigs.emplace_back(ts, r);
+      for (Type* p : parms) {
+        next.push_back(ts);
+        next.back().push_back(p);
+      }
+    }
+    seqs.swap(next);
+  }
+  return sigs;
+}
+
+/// Returns the function types of the signatures in get_signatures.
+static std::vector<const Type*>
+get_types(Context& cxt, std::size_t n)
+{
+  std::vector<const Type*> types;
+  for (const Signature& sig : get_signatures(cxt, n))
+    types.push_back(cxt.get_function_type(sig.first, sig.second));
+  return types;
+}
+
+/// Hashes the spelling of a symbol the way the symbol table does.
+template<typename H>
+static std::size_t
+hash_item(Text_view str)
+{
+  H h;
+  h(str.data(), str.size());
+  return (std::size_t)h;
+}
+
+/// Hashes the structure of a function type the way the type factory does.
+template<typename H>
+static std::size_t
+hash_item(const Type* t)
+{
+  const Function_type* f = static_cast<const Function_type*>(t);
+  const Type_seq& parms = f->get_parameter_types();
+  H h;
+  hash_append_function_type(h, parms.data(), parms.size(), f->get_return_type());
+  return (std::size_t)h;
+}
+
+/// Reports the throughput of `H` on the distinct `items` and the number of
+/// collisions, both among full hash codes and among the buckets of a table
+/// twice the size of `items` indexed by the low bits.
+template<typename H, typename T>
+static void
+bench_hasher(const char* what, const Options& opts, const std::vector<T>& items, std::uint64_t bytes)
+{
+  double best = 0;
+  std::size_t sum = 0;
+  for (int i = 0; i < opts.runs; ++i) {
+    Clock::time_point start = Clock::now();
+    for (const T& x : items)
+      sum += hash_item<H>(x);
+    double secs = get_seconds(start);
+    if (i == 0 || secs < best)
+      best = secs;
+  }
+
+  std::size_t buckets = 1;
+  while (buckets < items.size() * 2)
+    buckets *= 2;
+  std::unordered_set<std::size_t> codes;
+  std::vector<bool> used(buckets);
+  std::size_t full = 0;
+  std::size_t low = 0;
+  for (const T& x : items) {
+    std::size_t code = hash_item<H>(x);
+    if (!codes.insert(code).second)
+      ++full;
+    if (used[code & (buckets - 1)])
+      ++low;
+    used[code & (buckets - 1)] = true;
+  }
+
+  report(what, best, bytes, items.size(), "hashes");
+  std::cout << std::setw(24) << "" << "collisions: " << full << " full, "
+            << low << " in " << buckets << " buckets\n";
+
+  // Keep the timed hashes from being discarded.
+  sink = sum;
+}
+
+/// Compares the hash algorithms on the distinct spellings of the words in
+/// `files` and on a set of function types.
+static void
+bench_hash(Context& cxt, const Options& opts, const std::vector<const File*>& files)
+{
+  std::vector<Text_view> words = get_words(files);
+  std::unordered_set<std::string> seen;
+  std::vector<Text_view> syms;
+  std::uint64_t sym_bytes = 0;
+  for (Text_view w : words) {
+    if (seen.insert(std::string(w.data(), w.size())).second) {
+      syms.push_back(w);
+      sym_bytes += w.size();
+    }
+  }
+
+  std::vector<const Type*> types = get_types(cxt, 4);
+  // Count the bytes appended for each type: its kind, the identities of
+  // its parameter types and their number, and its return type.
+  std::uint64_t type_bytes = 0;
+  for (const Type* t : types) {
+    const Function_type* f = static_cast<const Function_type*>(t);
+    type_bytes += sizeof(Type::Kind) + sizeof(std::size_t) +
+                  sizeof(Type*) * (f->get_parameter_types().size() + 1);
+  }
+
+  std::cout << syms.size() << " symbols\n";
+  bench_hasher<Fnv1a_hasher>("fnv-1a", opts, syms, sym_bytes);
+  bench_hasher<Wy_hasher>("wy", opts, syms, sym_bytes);
+  std::cout << types.size() << " types\n";
+  bench_hasher<Fnv1a_hasher>("fnv-1a", opts, types, type_bytes);
+  bench_hasher<Wy_hasher>("wy", opts, types, type_bytes);
+}
+
+/// Measures the interning of function and reference types: first their
+/// creation, and then repeated lookups of existing types.
+static void
+bench_types(const Options& opts)
+{
+  double create_time = 0;
+  double lookup_time = 0;
+  double ref_time = 0;
+  std::size_t n = 0;
+  std::size_t sum = 0;
+  for (int i = 0; i < opts.runs; ++i) {
+    Context cxt;
+    std::vector<Signature> sigs = get_signatures(cxt, 5);
+    n = sigs.size();
+
+    Clock::time_point start = Clock::now();
+    for (const Signature& sig : sigs)
+      sum += (std::size_t)cxt.get_function_type(sig.first, sig.second);
+    double secs = get_seconds(start);
+    if (i == 0 || secs < create_time)
+      create_time = secs;
+
+    start = Clock::now();
+    for (const Signature& sig : sigs)
+      sum += (std::size_t)cxt.get_function_type(sig.first, sig.second);
+    secs = get_seconds(start);
+    if (i == 0 || secs < lookup_time)
+      lookup_time = secs;
+
+    start = Clock::now();
+    for (const Signature& sig : sigs)
+      sum += (std::size_t)cxt.get_reference_type(sig.second);
+    secs = get_seconds(start);
+    if (i == 0 || secs < ref_time)
+      ref_time = secs;
+  }
+
+  // Keep the lookups from being discarded.
+  sink = sum;
+
+  std::cout << n << " function types\n";
+  report("create function types", create_time, 0, n, "types");
+  report("find function types", lookup_time, 0, n, "types");
+  report("find reference types", ref_time, 0, n, "types");
+}
+
+/// Compares the time to parse and analyze each input with the time to
+/// load a snapshot of the result. Each run starts with a new context.
+static void
+bench_snapshot(const Options& opts)
+{
+  double parse_time = 0;
+  double load_time = 0;
+  std::uint64_t bytes = 0;
+  std::uint64_t size = 0;
+  std::size_t decls = 0;
+  for (const std::string& path : opts.inputs) {
+    llvm::SmallString<128> snap;
+    if (std::error_code ec = llvm::sys::fs::createTemporaryFile("beaker-bench", "bks", snap))
+      throw std::runtime_error("cannot create snapshot file: " + ec.message());
+    double parse_best = 0;
+    double load_best = 0;
+    for (int i = 0; i < opts.runs; ++i) {
+      Context cxt;
+      Clock::time_point start = Clock::now();
+      const File& f = cxt.get_source_manager().add_file(path);
+      Parse_context pc(cxt, f, opts.jobs);
+      Module_parser mp(pc);
+      Translation_unit* tu = static_cast<Translation_unit*>(mp.parse_module());
+      double secs = get_seconds(start);
+      if (i == 0 || secs < parse_best)
+        parse_best = secs;
+      if (i == 0) {
+        bytes += f.get_text().size();
+        decls += tu->get_declarations().size();
+        std::ofstream os(snap.c_str(), std::ios::binary);
+        write_snapshot(os, tu);
+        size += os.tellp();
+      }
+    }
+    for (int i = 0; i < opts.runs; ++i) {
+      Context cxt;
+      Clock::time_point start = Clock::now();
+      load_snapshot(cxt, snap.str().str());
+      double secs = get_seconds(start);
+      if (i == 0 || secs < load_best)
+        load_best = secs;
+    }
+    llvm::sys::fs::remove(snap);
+    parse_time += parse_best;
+    load_time += load_best;
+  }
+
+  std::cout << decls << " declarations, " << size << " bytes of snapshot\n";
+  report("parse and analyze", parse_time, bytes, decls, "decls");
+  report("load snapshot", load_time, bytes, decls, "decls");
+}
+
+static void
+usage()
+{
+  std::cerr << "usage: beaker-bench <benchmark> [options] [input-files]\n"
+            << "benchmarks:\n"
+            << "  lex        lexer throughput\n"
+            << "  keywords   keyword classification\n"
+            << "  hash       hash throughput and collisions\n"
+            << "  types      type interning\n"
+            << "  snapshot   loading snapshots vs. parsing the input files\n"
+            << "options:\n"
+            << "  -n <runs>  repeat each benchmark <runs> times (default 5)\n"
+            << "  -j <jobs>  lex each file on up to <jobs> threads (default 1)\n"
+            << "  -size <n>  generate an input of <n> bytes when no input files\n"
+            << "             are given (default 4194304)\n";
+}
+
+int
+main(int argc, const char* argv[])
+{
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+  std::string bench = argv[1];
+  if (bench != "lex" && bench != "keywords" && bench != "hash" &&
+      bench != "types" && bench != "snapshot") {
+    std::cerr << "error: unknown benchmark '" << bench << "'\n";
+    return 1;
+  }
+
+  Options opts;
+  for (int i = 2; i < argc; ++i) {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "-n") == 0 || std::strcmp(arg, "-j") == 0 ||
+        std::strcmp(arg, "-size") == 0) {
+      if (++i == argc) {
+        usage();
+        return 1;
+      }
+      long n = std::atol(argv[i]);
+      if (n <= 0) {
+        std::cerr << "error: invalid value '" << argv[i] << "' for '" << arg << "'\n";
+        return 1;
+      }
+      if (arg[1] == 'n')
+        opts.runs = n;
+      else if (arg[1] == 'j')
+        opts.jobs = n;
+      else
+        opts.size = n;
+    }
+    else if (arg[0] == '-' && arg[1] != 0) {
+      std::cerr << "error: unknown option '" << arg << "'\n";
+      return 1;
+    }
+    else {
+      opts.inputs.push_back(arg);
+    }
+  }
+
+  try {
+    std::unique_ptr<Generated_input> gen;
+    // The generated input exercises only the lexer.
+    if (opts.inputs.empty() && bench == "snapshot")
+      throw std::runtime_error("no input files");
+    if (opts.inputs.empty() && bench != "types") {
+      gen.reset(new Generated_input(opts.size));
+      opts.inputs.push_back(gen->path);
+    }
+
+    Context cxt;
+    std::vector<const File*> files;
+    for (const std::string& path : opts.inputs)
+      files.push_back(&cxt.get_source_manager().add_file(path));
+
+    if (bench == "lex")
+      bench_lex(cxt, opts, files);
+    else if (bench == "keywords")
+      bench_keywords(cxt, opts, files);
+    else if (bench == "hash")
+      bench_hash(cxt, opts, files);
+    else if (bench == "types")
+      bench_types(opts);
+    else
+      bench_snapshot(opts);
+  }
+  catch (std::exception& err) {
+    std::cerr << "error: " << err.what() << '\n';
+    return 1;
+  }
+}
@@ -8,6 +8,8 @@ namespace beaker
   class Bitwise_and_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == bit_and_kind; }
+
     Bitwise_and_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(bit_and_kind, t, lhs, rhs, op)
     { }
@@ -18,6 +20,8 @@ namespace beaker
   class Bitwise_or_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == bit_ior_kind; }
+
     Bitwise_or_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(bit_ior_kind, t, lhs, rhs, op)
     { }
@@ -28,6 +32,8 @@ namespace beaker
   class Bitwise_xor_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == bit_xor_kind; }
+
     Bitwise_xor_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(bit_xor_kind, t, lhs, rhs, op)
     { }
@@ -38,6 +44,8 @@ namespace beaker
   class Bitwise_not_expression : public Unary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == bit_not_kind; }
+
     Bitwise_not_expression(Type* t, Expression* e, const Token& op)
       : Unary_operator(bit_not_kind, t, e, op)
     { }
@@ -48,6 +56,8 @@ namespace beaker
   class Shift_left_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == bit_shl_kind; }
+
     Shift_left_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(bit_shl_kind, t, lhs, rhs, op)
     { }
@@ -58,6 +68,8 @@ namespace beaker
   class Shift_right_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == bit_shr_kind; }
+
     Shift_right_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(bit_shr_kind, t, lhs, rhs, op)
     { }
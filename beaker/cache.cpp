@@ -0,0 +1,221 @@
+#include "cache.hpp"
+#include "hash.hpp"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <utime.h>
+
+namespace beaker
+{
+  /// Identifies cache entries. The last byte is the version of the entry
+  /// format.
+  static const char entry_magic[4] = {'B', 'K', 'C', '1'};
+
+  /// The extension of cache entries.
+  static const char* entry_extension = ".bkrc";
+
+  /// The extension of the temporary files that entries are written to.
+  static const char* temp_extension = ".tmp";
+
+  /// The age after which a temporary file is assumed to have been left by
+  /// an interrupted store rather than by one in progress.
+  static const auto stale_temp_age = std::chrono::hours(1);
+
+  /// The fixed-size header of a cache entry. This is followed by the
+  /// configuration, the source text, and the output.
+  struct Entry_header
+  {
+    char magic[4];
+    std::uint64_t config_size;
+    std::uint64_t source_size;
+    std::uint64_t output_size;
+  };
+
+  Compilation_cache::Compilation_cache(const std::string& dir, std::uint64_t limit)
+    : m_dir(dir), m_limit(limit),
+      m_hits(0), m_misses(0), m_stores(0), m_evictions(0), m_size(0)
+  {
+    if (std::error_code ec = llvm::sys::fs::create_directories(m_dir)) {
+      std::stringstream ss;
+      ss << "cannot create cache directory '" << m_dir << "': " << ec.message();
+      throw std::runtime_error(ss.str());
+    }
+  }
+
+  std::string
+  Compilation_cache::get_entry_path(const std::string& config,
+                                    Text_view src) const
+  {
+    Hasher h;
+    hash_append(h, config.size());
+    h(config.data(), config.size());
+    hash_append(h, src.size());
+    h(src.data(), src.size());
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)(std::size_t)h);
+
+    llvm::SmallString<128> path(m_dir);
+    llvm::sys::path::append(path, name);
+    path += entry_extension;
+    return path.str().str();
+  }
+
+  /// Reads `n` bytes from `is` and returns true if they are equal to the
+  /// bytes in `str`.
+  static bool
+  read_and_compare(std::istream& is, Text_view str, std::uint64_t n)
+  {
+    if (n != str.size())
+      return false;
+    std::string buf(n, 0);
+    if (!is.read(&buf[0], n))
+      return false;
+    return std::memcmp(buf.data(), str.data(), n) == 0;
+  }
+
+  bool
+  Compilation_cache::lookup(const std::string& config,
+                            Text_view src,
+                            std::string& out)
+  {
+    std::string path = get_entry_path(config, src);
+    Text_view cfg(config.data(), config.data() + config.size());
+    std::ifstream ifs(path, std::ios::binary);
+    Entry_header hdr;
+    if (ifs &&
+        ifs.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) &&
+        std::memcmp(hdr.magic, entry_magic, sizeof(entry_magic)) == 0 &&
+        read_and_compare(ifs, cfg, hdr.config_size) &&
+        read_and_compare(ifs, src, hdr.source_size))
+    {
+      std::string buf(hdr.output_size, 0);
+      if (ifs.read(&buf[0], hdr.output_size)) {
+        // Mark the entry as recently used.
+        ::utime(path.c_str(), nullptr);
+        out = std::move(buf);
+        ++m_hits;
+        return true;
+      }
+    }
+    ++m_misses;
+    return false;
+  }
+
+  void
+  Compilation_cache::store(const std::string& config,
+                           Text_view src,
+                           const char* p,
+                           std::size_t n)
+  {
+    std::string path = get_entry_path(config, src);
+
+    // Write the entry to a uniquely named temporary file so that readers
+    // never observe a partially written entry.
+    llvm::SmallString<128> model(m_dir);
+    llvm::sys::path::append(model, std::string("%%%%%%%%%%%%") + temp_extension);
+    llvm::SmallString<128> tmp;
+    int fd;
+    if (llvm::sys::fs::createUniqueFile(model, fd, tmp))
+      return;
+
+    Entry_header hdr;
+    std::memcpy(hdr.magic, entry_magic, sizeof(entry_magic));
+    hdr.config_size = config.size();
+    hdr.source_size = src.size();
+    hdr.output_size = n;
+    {
+      llvm::raw_fd_ostream os(fd, true);
+      os.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+      os << config;
+      os.write(src.data(), src.size());
+      os.write(p, n);
+      os.close();
+      if (os.has_error()) {
+        os.clear_error();
+        llvm::sys::fs::remove(tmp);
+        return;
+      }
+    }
+
+    if (llvm::sys::fs::rename(tmp, path)) {
+      llvm::sys::fs::remove(tmp);
+      return;
+    }
+    ++m_stores;
+  }
+
+  void
+  Compilation_cache::trim()
+  {
+    struct Entry
+    {
+      std::string path;
+      std::uint64_t size;
+      llvm::sys::TimePoint<> time;
+    };
+
+    // Gather the entries and the total size of the cache. Temporary files
+    // count toward the size; those left by interrupted stores are removed.
+    std::vector<Entry> entries;
+    std::uint64_t total = 0;
+    auto now = std::chrono::system_clock::now();
+    std::error_code ec;
+    for (llvm::sys::fs::directory_iterator iter(m_dir, ec), last;
+         iter != last && !ec;
+         iter.increment(ec))
+    {
+      const std::string& path = iter->path();
+      llvm::StringRef ext = llvm::sys::path::extension(path);
+      if (ext != entry_extension && ext != temp_extension)
+        continue;
+      llvm::sys::fs::file_status st;
+      if (llvm::sys::fs::status(path, st))
+        continue;
+      if (ext == temp_extension) {
+        if (now - st.getLastModificationTime() > stale_temp_age &&
+            !llvm::sys::fs::remove(path))
+          continue;
+        total += st.getSize();
+        continue;
+      }
+      entries.push_back({path, st.getSize(), st.getLastModificationTime()});
+      total += st.getSize();
+    }
+
+    // Evict the least recently used entries first.
+    if (total > m_limit) {
+      std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.time < b.time;
+      });
+      for (const Entry& e : entries) {
+        if (total <= m_limit)
+          break;
+        if (llvm::sys::fs::remove(e.path))
+          continue;
+        total -= e.size;
+        ++m_evictions;
+      }
+    }
+    m_size = total;
+  }
+
+  Cache_statistics
+  Compilation_cache::get_statistics() const
+  {
+    return {m_hits, m_misses, m_stores, m_evictions, m_size};
+  }
+
+} // namespace beaker
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <beaker/file.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace beaker
+{
+  /// Counts the outcomes of cache operations.
+  struct Cache_statistics
+  {
+    /// The number of lookups that found an entry.
+    std::size_t hits;
+
+    /// The number of lookups that did not find an entry.
+    std::size_t misses;
+
+    /// The number of entries written.
+    std::size_t stores;
+
+    /// The number of entries removed to keep the cache within its limit.
+    std::size_t evictions;
+
+    /// The size of the cache after the last trim, in bytes.
+    std::uint64_t size;
+  };
+
+
+  /// A content-addressed, on-disk store of compiler outputs.
+  ///
+  /// Entries are keyed by the hash of the source text and a configuration
+  /// string describing everything else that affects the output (e.g., the
+  /// compiler version and options). Each entry also records the source text
+  /// and configuration it was produced from, so that a hash collision is
+  /// detected as a miss instead of returning the wrong output.
+  ///
+  /// Lookups and stores may be performed concurrently. Stores are atomic:
+  /// an entry is written to a temporary file and then renamed into place.
+  ///
+  /// The cache is bounded by evicting the least recently used entries
+  /// when trimmed. A hit refreshes the modification time of its entry.
+  class Compilation_cache
+  {
+  public:
+    /// Opens the cache in `dir`, creating the directory if needed. The
+    /// total size of all entries is limited to `limit` bytes.
+    Compilation_cache(const std::string& dir, std::uint64_t limit);
+
+    /// Returns the directory containing the cache.
+    const std::string& get_directory() const { return m_dir; }
+
+    /// Returns the maximum size of the cache.
+    std::uint64_t get_limit() const { return m_limit; }
+
+    /// Searches for the output of a previous compilation of `src` under
+    /// `config`. If found, the output is assigned to `out`.
+    bool lookup(const std::string& config, Text_view src, std::string& out);
+
+    /// Stores `n` bytes of output at `p` as the result of compiling `src`
+    /// under `config`. Failures to write the entry are ignored; the cache
+    /// is only an optimization.
+    void store(const std::string& config, Text_view src, const char* p, std::size_t n);
+
+    /// Removes the least recently used entries until the cache fits within
+    /// its size limit. Temporary files left by interrupted stores are
+    /// removed as well.
+    void trim();
+
+    /// Returns the statistics accumulated by this cache.
+    Cache_statistics get_statistics() const;
+
+  private:
+    std::string get_entry_path(const std::string& config, Text_view src) const;
+
+    /// The cache directory.
+    std::string m_dir;
+
+    /// The maximum size of the cache in bytes.
+    std::uint64_t m_limit;
+
+    std::atomic<std::size_t> m_hits;
+    std::atomic<std::size_t> m_misses;
+    std::atomic<std::size_t> m_stores;
+    std::atomic<std::size_t> m_evictions;
+    std::atomic<std::uint64_t> m_size;
+  };
+
+} // namespace beaker
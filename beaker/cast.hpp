@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+
+namespace beaker
+{
+  // Casting
+  //
+  // Each class in a tree hierarchy (declarations, expressions, statements,
+  // types, and type specifiers) defines a static member function
+  // `classof(p)` that returns true if the object `p` of its base class is an
+  // object of that class. The test reads only the kind of the object.
+  // Intermediate bases test for a range of kinds, so the kinds of the
+  // classes derived from each base are kept together.
+  //
+  // These replace dynamic_cast, which requires run time type information.
+
+  /// The type of a pointer to `T` having the constness of `U`.
+  template<typename T, typename U>
+  using Cast_result = std::conditional_t<std::is_const<U>::value, const T*, T*>;
+
+  namespace cast_detail
+  {
+    template<typename T, typename U>
+    inline bool
+    isa(const U*, std::true_type)
+    {
+      return true;
+    }
+
+    template<typename T, typename U>
+    inline bool
+    isa(const U* p, std::false_type)
+    {
+      return T::classof(p);
+    }
+
+  } // namespace cast_detail
+
+  /// Returns true if `p` points to an object of type `T`. The pointer must
+  /// not be null. This is always true when `T` is a base of `U`.
+  template<typename T, typename U>
+  inline bool
+  isa(const U* p)
+  {
+    assert(p && "isa of null pointer");
+    return cast_detail::isa<T>(p, std::is_base_of<T, U>());
+  }
+
+  /// Returns `p` converted to a pointer to `T`. The object `p` points to
+  /// must have type `T`.
+  template<typename T, typename U>
+  inline Cast_result<T, U>
+  cast(U* p)
+  {
+    assert(isa<T>(p) && "invalid cast");
+    return static_cast<Cast_result<T, U>>(p);
+  }
+
+  /// Returns `p` converted to a pointer to `T` if the object it points to
+  /// has type `T`, or nullptr otherwise. The pointer must not be null.
+  template<typename T, typename U>
+  inline Cast_result<T, U>
+  dyn_cast(U* p)
+  {
+    return isa<T>(p) ? static_cast<Cast_result<T, U>>(p) : nullptr;
+  }
+
+  /// Returns `p` converted to a pointer to `T` if it is non-null and the
+  /// object it points to has type `T`, or nullptr otherwise.
+  template<typename T, typename U>
+  inline Cast_result<T, U>
+  dyn_cast_or_null(U* p)
+  {
+    return p ? dyn_cast<T>(p) : nullptr;
+  }
+
+} // namespace beaker
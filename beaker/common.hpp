@@ -1,5 +1,8 @@
 #pragma once
 
+#include <beaker/cast.hpp>
+#include <beaker/span.hpp>
+
 #include <cassert>
 #include <memory>
 #include <vector>
@@ -34,6 +37,7 @@ namespace beaker
   class Bool_literal;
   class Int_literal;
   class Id_expression;
+  class Folded_expression;
   class Addition_expression;
   class Subtraction_expression;
   class Negation_expression;
@@ -42,6 +46,12 @@ namespace beaker
   class Remainder_expression;
   class Division_expression;
   class Reciprocal_expression;
+  class Bitwise_and_expression;
+  class Bitwise_or_expression;
+  class Bitwise_xor_expression;
+  class Bitwise_not_expression;
+  class Shift_left_expression;
+  class Shift_right_expression;
   class Equal_to_expression;
   class Not_equal_to_expression;
   class Less_than_expression;
@@ -84,6 +94,7 @@ namespace beaker
   class Reference_declaration;
   class Function_declaration;
   class Assertion;
+  class Import_declaration;
   
   class Parameter;
 
@@ -95,6 +106,9 @@ namespace beaker
 
   /// A sequence of type specifiers.
   using Type_specifier_seq = std::vector<Type_specifier*>;
+
+  /// An immutable list of type specifiers in a syntax tree.
+  using Type_specifier_list = Span<Type_specifier*>;
   
   /// A sequence of expressions.
   using Expression_seq = std::vector<Expression*>;
@@ -104,6 +118,9 @@ namespace beaker
   
   /// A sequence of statements.
   using Statement_seq = std::vector<Statement*>;
+
+  /// An immutable list of statements in a syntax tree.
+  using Statement_list = Span<Statement*>;
   
   /// A sequence of declarations.
   using Declaration_seq = std::vector<Declaration*>;
@@ -111,6 +128,9 @@ namespace beaker
   /// A sequence of declarations.
   using Parameter_seq = std::vector<Parameter*>;
 
+  /// An immutable list of parameters in a syntax tree.
+  using Parameter_list = Span<Parameter*>;
+
 
   /// A syntactic construct is a type specifier, expression, statement,
   /// or declaration. 
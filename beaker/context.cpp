@@ -1,31 +1,19 @@
 #include "context.hpp"
 #include "type.hpp"
+#include "type_specifier.hpp"
+#include "expression.hpp"
+#include "conversion.hpp"
+#include "value.hpp"
 #include "factory.hpp"
+#include "module_interface.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace beaker
 {
-  struct Type_equal
-  {
-    bool 
-    operator()(const Type& t1, const Type& t2) const noexcept
-    {
-      return t1.is_equal_to(t2);
-    }
-  };
-
-  /// A general facility for hashing trees.
-  template<typename T>
-  struct Tree_hash
-  {
-    std::size_t operator()(const T& t) const noexcept
-    {
-      return t.hash();
-    }
-  };
-
-  template<typename T>
-  using Unique_type = Unique_factory<T, Tree_hash<T>, Type_equal>;
-
   class Context::Type_factory
   {
   public:
@@ -56,16 +44,198 @@ namespace beaker
     /// The type `auto`.
     std::unique_ptr<Auto_type> auto_type;
 
-    /// Creates unique function types.
-    Unique_type<Function_type> function_types;
+    /// Holds the function and reference types.
+    Arena arena;
+
+    /// Ensures the uniqueness of function types.
+    Intern_table<Function_type> function_types;
+
+    /// Ensures the uniqueness of reference types.
+    Intern_table<Reference_type> reference_types;
+
+    /// Ensures the uniqueness of simple type specifiers.
+    Intern_table<Simple_type_specifier> simple_specifiers;
+
+    /// Guards the tables while the context is shared.
+    std::mutex lock;
+  };
+
+  /// Returns a lock on `m` if `cxt` is shared by worker threads, or an
+  /// unlocked lock otherwise.
+  static inline std::unique_lock<std::mutex>
+  lock_if_shared(const Context& cxt, std::mutex& m)
+  {
+    if (cxt.is_shared())
+      return std::unique_lock<std::mutex>(m);
+    return std::unique_lock<std::mutex>(m, std::defer_lock);
+  }
+
+  /// The shallow structure of an expression: the value or declaration
+  /// that distinguishes it from other expressions of the same kind and
+  /// type, and the identities of its operands.
+  struct Expression_key
+  {
+    std::intmax_t data;
+    const Expression* ops[3];
+  };
+
+  /// Computes the key of `e`. Returns false if `e` may have side effects
+  /// or refers to an object under initialization, in which case it has no
+  /// canonical form. Operands are keyed by the expressions they use, so
+  /// that their locations do not matter.
+  static bool
+  get_expression_key(const Expression& e, Expression_key& k)
+  {
+    k = Expression_key();
+    switch (e.get_kind()) {
+    case Expression::bool_kind:
+      k.data = static_cast<const Bool_literal&>(e).get_value();
+      return true;
+    case Expression::int_kind:
+      k.data = static_cast<const Int_literal&>(e).get_value();
+      return true;
+    case Expression::id_kind:
+      k.data = reinterpret_cast<std::intptr_t>(static_cast<const Id_expression&>(e).get_declaration());
+      return true;
+    case Expression::fold_kind:
+      k.data = static_cast<const Folded_expression&>(e).get_value().get_int();
+      k.ops[0] = get_used_expression(static_cast<const Folded_expression&>(e).get_expression());
+      return true;
+
+    case Expression::neg_kind:
+    case Expression::rec_kind:
+    case Expression::bit_not_kind:
+    case Expression::not_kind:
+      k.ops[0] = get_used_expression(static_cast<const Unary_expression&>(e).get_operand());
+      return true;
+
+    case Expression::add_kind:
+    case Expression::sub_kind:
+    case Expression::mul_kind:
+    case Expression::quo_kind:
+    case Expression::rem_kind:
+    case Expression::div_kind:
+    case Expression::bit_and_kind:
+    case Expression::bit_ior_kind:
+    case Expression::bit_xor_kind:
+    case Expression::bit_shl_kind:
+    case Expression::bit_shr_kind:
+    case Expression::and_kind:
+    case Expression::or_kind:
+    case Expression::eq_kind:
+    case Expression::ne_kind:
+    case Expression::lt_kind:
+    case Expression::gt_kind:
+    case Expression::ng_kind:
+    case Expression::nl_kind:
+      k.ops[0] = get_used_expression(static_cast<const Binary_expression&>(e).get_lhs());
+      k.ops[1] = get_used_expression(static_cast<const Binary_expression&>(e).get_rhs());
+      return true;
+
+    case Expression::cond_kind:
+      k.ops[0] = get_used_expression(static_cast<const Ternary_expression&>(e).get_first());
+      k.ops[1] = get_used_expression(static_cast<const Ternary_expression&>(e).get_second());
+      k.ops[2] = get_used_expression(static_cast<const Ternary_expression&>(e).get_third());
+      return true;
+
+    case Expression::imp_conv:
+      k.data = static_cast<const Conversion&>(e).get_conversion_kind();
+      k.ops[0] = get_used_expression(static_cast<const Conversion&>(e).get_source());
+      return true;
+
+    case Expression::init_kind:
+    case Expression::assign_kind:
+    case Expression::empty_init:
+    case Expression::def_init:
+    case Expression::val_init:
+    case Expression::loc_kind:
+      return false;
+    }
+    __builtin_unreachable();
+  }
+
+  /// Returns the hash code of an expression with key `k`. Because
+  /// operands are canonical, they are hashed by identity, and hashing does
+  /// not traverse the expression.
+  static std::size_t
+  hash_expression(const Expression& e, const Expression_key& k)
+  {
+    Hasher h;
+    hash_append(h, e.get_kind());
+    hash_append(h, e.get_type());
+    hash_append(h, k.data);
+    h(k.ops, sizeof(k.ops));
+    return (std::size_t)h;
+  }
 
-    /// Creates unique reference types.
-    Unique_type<Reference_type> reference_types;
+  /// Returns true if `e1` has the same kind and type as `e2`, whose key
+  /// is `k2`.
+  static bool
+  equal_expressions(const Expression& e1, const Expression& e2, const Expression_key& k2)
+  {
+    if (e1.get_kind() != e2.get_kind() || e1.get_type() != e2.get_type())
+      return false;
+    Expression_key k1;
+    get_expression_key(e1, k1);
+    return k1.data == k2.data && std::equal(k1.ops, k1.ops + 3, k2.ops);
+  }
+
+  class Context::Expression_factory
+  {
+  public:
+    /// The canonical expressions.
+    Intern_table<Expression> canonical_exprs;
+
+    /// The memoized values of canonical expressions.
+    std::unordered_map<const Expression*, Value> values;
+
+    /// Guards the tables while the context is shared.
+    std::mutex lock;
+
+    /// Returns true if `e` is in the table of canonical expressions.
+    bool is_canonical(const Expression* e) const;
   };
 
+  bool
+  Context::Expression_factory::is_canonical(const Expression* e) const
+  {
+    Expression_key k;
+    if (!get_expression_key(*e, k))
+      return false;
+    std::size_t h = hash_expression(*e, k);
+    return canonical_exprs.find(h, [e](const Expression* x) {
+      return x == e;
+    });
+  }
+
+  thread_local Worker_arena* Worker_arena::s_current = nullptr;
+
+  Worker_arena::Worker_arena(Context& cxt)
+    : m_cxt(cxt), m_arena()
+  {
+    assert(!s_current); // Worker arenas do not nest.
+    s_current = this;
+    ++m_cxt.m_workers;
+  }
+
+  Worker_arena::~Worker_arena()
+  {
+    s_current = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(m_cxt.m_arena_lock);
+      m_cxt.m_arena.merge(m_arena);
+    }
+    --m_cxt.m_workers;
+  }
+
   Context::Context()
-    : m_syms(),
-      m_types(new Type_factory())
+    : m_arena(),
+      m_arena_lock(),
+      m_workers(0),
+      m_sources(),
+      m_syms(),
+      m_types(new Type_factory()),
+      m_exprs(new Expression_factory())
   { }
 
   Context::~Context()
@@ -104,13 +274,150 @@ namespace beaker
   Reference_type*
   Context::get_reference_type(Type* t)
   {
-    return m_types->reference_types.make(t);
+    auto lock = lock_if_shared(*this, m_types->lock);
+    std::size_t h = hash_reference_type(t);
+    return m_types->reference_types.get(h, [t](const Reference_type* r) {
+      return r->get_object_type() == t;
+    }, [this, t]() {
+      return m_types->arena.make<Reference_type>(t);
+    });
+  }
+
+  /// Returns true if `f` has the `n` parameter types at `parms` and the
+  /// return type `r`. Types are unique, so they are compared by identity.
+  static inline bool
+  has_signature(const Function_type* f, Type* const* parms, std::size_t n, Type* r)
+  {
+    const Type_seq& ps = f->get_parameter_types();
+    return f->get_return_type() == r && ps.size() == n && std::equal(ps.begin(), ps.end(), parms);
   }
 
   Function_type*
-  Context::get_function_type(const Type_seq& ts, Type* t)
+  Context::get_function_type(const Type_seq& ts, Type* r)
+  {
+    auto lock = lock_if_shared(*this, m_types->lock);
+    std::size_t h = hash_function_type(ts.data(), ts.size(), r);
+    return m_types->function_types.get(h, [&](const Function_type* f) {
+      return has_signature(f, ts.data(), ts.size(), r);
+    }, [&]() {
+      return m_types->arena.make<Function_type>(ts, r);
+    });
+  }
+
+  Function_type*
+  Context::get_function_type(Type_seq&& ts, Type* r)
+  {
+    auto lock = lock_if_shared(*this, m_types->lock);
+    std::size_t h = hash_function_type(ts.data(), ts.size(), r);
+    return m_types->function_types.get(h, [&](const Function_type* f) {
+      return has_signature(f, ts.data(), ts.size(), r);
+    }, [&]() {
+      return m_types->arena.make<Function_type>(std::move(ts), r);
+    });
+  }
+
+  Intern_statistics
+  Context::get_type_statistics() const
+  {
+    auto lock = lock_if_shared(*this, m_types->lock);
+    Intern_statistics s = m_types->function_types.get_statistics();
+    s += m_types->reference_types.get_statistics();
+    return s;
+  }
+
+  Simple_type_specifier*
+  Context::get_simple_type_specifier(Type* t)
+  {
+    auto lock = lock_if_shared(*this, m_types->lock);
+    return m_types->simple_specifiers.get(t->hash(), [t](const Simple_type_specifier* ts) {
+      return ts->get_type() == t;
+    }, [this, t]() {
+      return make<Simple_type_specifier>(t);
+    });
+  }
+
+  Expression*
+  Context::get_canonical_expression(const Expression& e, Expression_copy copy)
+  {
+    Expression_key k;
+    if (!get_expression_key(e, k))
+      return copy(*this, e);
+    auto lock = lock_if_shared(*this, m_exprs->lock);
+    for (const Expression* op : k.ops) {
+      if (op && !m_exprs->is_canonical(op))
+        return copy(*this, e);
+    }
+
+    std::size_t h = hash_expression(e, k);
+    return m_exprs->canonical_exprs.get(h, [&](const Expression* x) {
+      return equal_expressions(*x, e, k);
+    }, [&]() {
+      return copy(*this, e);
+    });
+  }
+
+  /// Locations are compared only when `c` was not created from `use`, in
+  /// which case `c` is a shared canonical expression.
+  Expression*
+  Context::locate_expression(Expression* c, const Expression& use)
+  {
+    if (c->get_location() == use.get_location() &&
+        c->get_start_location() == use.get_start_location() &&
+        c->get_end_location() == use.get_end_location())
+      return c;
+    return make<Located_expression>(c, use);
+  }
+
+  bool
+  Context::is_canonical_expression(const Expression* e) const
   {
-    return m_types->function_types.make(ts, t);
+    auto lock = lock_if_shared(*this, m_exprs->lock);
+    return m_exprs->is_canonical(e);
+  }
+
+  Intern_statistics
+  Context::get_expression_statistics() const
+  {
+    auto lock = lock_if_shared(*this, m_exprs->lock);
+    return m_exprs->canonical_exprs.get_statistics();
+  }
+
+  const Value*
+  Context::get_constant_value(const Expression* e) const
+  {
+    auto lock = lock_if_shared(*this, m_exprs->lock);
+    auto iter = m_exprs->values.find(e);
+    if (iter != m_exprs->values.end())
+      return &iter->second;
+    return nullptr;
+  }
+
+  void
+  Context::set_constant_value(const Expression* e, const Value& v)
+  {
+    if (v.is_reference() || v.is_indeterminate())
+      return;
+    auto lock = lock_if_shared(*this, m_exprs->lock);
+    if (!m_exprs->is_canonical(e))
+      return;
+    m_exprs->values.emplace(e, v);
+  }
+
+  Module_interface*
+  Context::get_module_interface(Symbol name)
+  {
+    std::unique_ptr<Module_interface>& mi = m_modules[name];
+    if (!mi) {
+      std::string path = find_module_interface(m_import_dirs, name->str());
+      if (path.empty()) {
+        m_modules.erase(name);
+        std::stringstream ss;
+        ss << "cannot find interface of module '" << name << "'";
+        throw std::runtime_error(ss.str());
+      }
+      mi.reset(new Module_interface(path));
+    }
+    return mi.get();
   }
 
 } // namespace beaker
@@ -1,9 +1,17 @@
 #pragma once
 
 #include <beaker/common.hpp>
+#include <beaker/arena.hpp>
+#include <beaker/factory.hpp>
 #include <beaker/symbol.hpp>
+#include <beaker/source.hpp>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace beaker
 {
@@ -14,18 +22,65 @@ namespace beaker
   class Auto_type;
   class Function_type;
   class Reference_type;
+  class Simple_type_specifier;
+  class Module_interface;
+  class Worker_arena;
 
   /// Provides context (i.e., resources) to all major components of the
   /// compiler. This includes: memory allocation, diagnostics, memoization,
   /// internment, etc.
   ///
-  /// \todo Integrate input management into the context.
+  /// A context is used by one thread at a time, except that worker threads
+  /// may build syntax trees concurrently, each with a Worker_arena.
   class Context
   {
+    friend class Worker_arena;
+
+
   public:
     Context();
     ~Context();
 
+    // Input
+
+    /// Returns the source manager, which owns the input files.
+    Source_manager& get_source_manager() { return m_sources; }
+
+    /// Returns the file, line, and column of `loc`.
+    Source_location get_source_location(Location loc) const
+    {
+      return m_sources.get_source_location(loc);
+    }
+
+    // Memory
+
+    /// Returns the arena that holds the syntax trees.
+    Arena& get_arena() { return m_arena; }
+
+    /// Returns the arena in which the calling thread creates nodes. This
+    /// is the thread's worker arena, if it has one, or the context's arena.
+    Arena& get_local_arena();
+
+    /// Returns true if worker threads may be creating nodes in the context.
+    /// While this is the case, the interning tables are locked on each
+    /// access.
+    bool is_shared() const { return m_workers.load(std::memory_order_relaxed) != 0; }
+
+    /// Creates a new node of type T. The node is destroyed with the
+    /// context.
+    template<typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+      return get_local_arena().make<T>(std::forward<Args>(args)...);
+    }
+
+    /// Copies a list of children into the context, and returns the copy.
+    template<typename T>
+    Span<T> make_span(const std::vector<T>& v)
+    {
+      return get_local_arena().make_span(v);
+    }
+
     // Symbols
 
     /// Returns the symbol table.
@@ -37,6 +92,9 @@ namespace beaker
     /// Get a unique symbol for the given string.
     Symbol get_symbol(const std::string& str) { return m_syms.get(str); }
 
+    /// Returns the symbol spelled by the `n` characters at `str`.
+    Symbol get_symbol(const char* str, std::size_t n) { return m_syms.get(str, n); }
+
     // Types
 
     /// Returns the type `unit`.
@@ -60,7 +118,91 @@ namespace beaker
     /// Returns the type `(t1, t2, ..., tn) -> tr`.
     Function_type* get_function_type(const Type_seq& ts, Type* r);
 
+    /// Returns the type `(t1, t2, ..., tn) -> tr`. If the type is created,
+    /// it takes the sequence `ts`.
+    Function_type* get_function_type(Type_seq&& ts, Type* r);
+
+    /// Returns statistics about the interning of function and reference
+    /// types.
+    Intern_statistics get_type_statistics() const;
+
+    // Type specifiers
+
+    /// Returns the simple type specifier that denotes `t`.
+    Simple_type_specifier* get_simple_type_specifier(Type* t);
+
+    // Expressions
+
+    /// Copies an expression into the context.
+    using Expression_copy = Expression* (*)(Context&, const Expression&);
+
+    /// Returns the canonical expression structurally equal to `e`. If there
+    /// is none, a copy of `e` is made by `copy` and becomes canonical. Only
+    /// expressions without side effects whose operands are themselves
+    /// canonical are canonicalized; for all others, a copy is returned.
+    /// The operands of `e` must be created before `e`, so that the
+    /// expressions form a DAG.
+    Expression* get_canonical_expression(const Expression& e, Expression_copy copy);
+
+    /// Returns `c`, the canonical expression of `use`, if it has the
+    /// locations of `use`. Otherwise, returns a located expression that
+    /// records the locations of `use`.
+    Expression* locate_expression(Expression* c, const Expression& use);
+
+    /// Creates an expression of type T unless a structurally equal
+    /// expression already exists, and returns the canonical expression.
+    /// The candidate is built on the stack, so that duplicates never
+    /// occupy the arena. When the canonical expression was created for a
+    /// use elsewhere, the result is a located expression wrapping it.
+    template<typename T, typename... Args>
+    Expression* make_canonical(Args&&... args)
+    {
+      T e(std::forward<Args>(args)...);
+      Expression* c = get_canonical_expression(e, [](Context& cxt, const Expression& x) -> Expression* {
+        return cxt.make<T>(static_cast<const T&>(x));
+      });
+      return locate_expression(c, e);
+    }
+
+    /// Returns true if `e` is a canonical expression.
+    bool is_canonical_expression(const Expression* e) const;
+
+    /// Returns the memoized constant value of `e`, or null if `e` has not
+    /// been evaluated.
+    const Value* get_constant_value(const Expression* e) const;
+
+    /// Memoizes `v` as the constant value of `e`. This has no effect when
+    /// `e` is not canonical, or when `v` refers to an object, whose storage
+    /// is owned by the evaluator that computed it.
+    void set_constant_value(const Expression* e, const Value& v);
+
+    /// Returns statistics about the interning of expressions.
+    Intern_statistics get_expression_statistics() const;
+
+    // Modules
+
+    /// Adds `dir` to the directories searched for module interfaces.
+    void add_import_directory(const std::string& dir) { m_import_dirs.push_back(dir); }
+
+    /// Returns the interface of the module `name`, opening it from the
+    /// first import directory that contains it. Each interface is opened
+    /// once. Throws if no interface is found.
+    Module_interface* get_module_interface(Symbol name);
+
   private:
+    /// Holds the syntax trees. This is declared first so that it is
+    /// destroyed last.
+    Arena m_arena;
+
+    /// Serializes the merging of worker arenas into the context's arena.
+    std::mutex m_arena_lock;
+
+    /// The number of worker arenas.
+    std::atomic<unsigned> m_workers;
+
+    /// The input files.
+    Source_manager m_sources;
+
     /// The symbol table provides unique representations of symbols in the
     /// language. This is not used to associate information with identifiers.
     Symbol_table m_syms;
@@ -71,6 +213,60 @@ namespace beaker
     /// Used to create (possibly unique) types.
     std::unique_ptr<Type_factory> m_types;
 
+    // Expressions
+    class Expression_factory;
+
+    /// Used to create canonical expressions and memoize their values.
+    std::unique_ptr<Expression_factory> m_exprs;
+
+    // Modules
+
+    /// The directories searched for module interfaces.
+    std::vector<std::string> m_import_dirs;
+
+    /// The opened module interfaces.
+    std::unordered_map<Symbol, std::unique_ptr<Module_interface>> m_modules;
+
   };
 
+
+  /// Gives the calling thread its own arena in which to create the nodes of
+  /// a context, so that several threads can build syntax trees in the same
+  /// context without contending for its arena. The worker arena is merged
+  /// into the context's arena when it is destroyed.
+  ///
+  /// A thread has at most one worker arena at a time. While any worker
+  /// arena exists, threads without one must not create nodes in the
+  /// context.
+  class Worker_arena
+  {
+    friend class Context;
+
+  public:
+    explicit Worker_arena(Context& cxt);
+    ~Worker_arena();
+
+    Worker_arena(const Worker_arena&) = delete;
+    Worker_arena& operator=(const Worker_arena&) = delete;
+
+  private:
+    /// The worker arena of the calling thread, if any.
+    static thread_local Worker_arena* s_current;
+
+    /// The context whose nodes are created in the arena.
+    Context& m_cxt;
+
+    /// Holds the nodes created by the thread.
+    Arena m_arena;
+  };
+
+  inline Arena&
+  Context::get_local_arena()
+  {
+    Worker_arena* w = Worker_arena::s_current;
+    if (w && &w->m_cxt == this)
+      return w->m_arena;
+    return m_arena;
+  }
+
 } // namespace beaker
\ No newline at end of file
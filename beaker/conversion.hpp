@@ -10,6 +10,8 @@ namespace beaker
   class Conversion : public Unary_expression
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == imp_conv; }
+
     enum Conversion_kind
     {
       value_conv, // reference to value conversion
@@ -63,6 +65,8 @@ namespace beaker
   class Implicit_conversion : public Conversion
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == imp_conv; }
+
     Implicit_conversion(Conversion_kind ck, Type* t, Expression* e)
       : Conversion(imp_conv, ck, t, e)
     { }
@@ -61,73 +61,73 @@ namespace beaker
   }
 
   /// Returns a new value conversion.
-  static Implicit_conversion*
-  make_value_conversion(Type* t, Expression* e)
+  static Expression*
+  make_value_conversion(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::value_conv, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::value_conv, t, e);
   }
 
   /// Returns a new bool conversion.
-  static Implicit_conversion*
-  make_bool_conversion(Type* t, Expression* e)
+  static Expression*
+  make_bool_conversion(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::bool_conv, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::bool_conv, t, e);
   }
   
   /// Returns a new integer promotion.
-  static Implicit_conversion*
-  make_int_promotion(Type* t, Expression* e)
+  static Expression*
+  make_int_promotion(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::int_prom, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::int_prom, t, e);
   }
 
   /// Returns a new sign extension.
-  static Implicit_conversion*
-  make_sign_extension(Type* t, Expression* e)
+  static Expression*
+  make_sign_extension(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::sign_ext, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::sign_ext, t, e);
   }
 
   /// Returns a new zero extension.
-  static Implicit_conversion*
-  make_zero_extension(Type* t, Expression* e)
+  static Expression*
+  make_zero_extension(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::zero_ext, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::zero_ext, t, e);
   }
 
   /// Returns a new integer truncation.
-  static Implicit_conversion*
-  make_int_truncation(Type* t, Expression* e)
+  static Expression*
+  make_int_truncation(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::int_trunc, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::int_trunc, t, e);
   }
 
   /// Returns a new floating point promotion.
-  static Implicit_conversion*
-  make_float_promotion(Type* t, Expression* e)
+  static Expression*
+  make_float_promotion(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::float_prom, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::float_prom, t, e);
   }
 
   /// Returns a new floating point demotion.
-  static Implicit_conversion*
-  make_float_demotion(Type* t, Expression* e)
+  static Expression*
+  make_float_demotion(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::float_dem, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::float_dem, t, e);
   }
 
   /// Returns a new floating point extension.
-  static Implicit_conversion*
-  make_float_extension(Type* t, Expression* e)
+  static Expression*
+  make_float_extension(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::float_ext, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::float_ext, t, e);
   }
 
   /// Returns a new floating point truncation.
-  static Implicit_conversion*
-  make_float_truncation(Type* t, Expression* e)
+  static Expression*
+  make_float_truncation(Context& cxt, Type* t, Expression* e)
   {
-    return new Implicit_conversion(Conversion::float_trunc, t, e);
+    return cxt.make_canonical<Implicit_conversion>(Conversion::float_trunc, t, e);
   }
 
   Expression*
@@ -150,14 +150,14 @@ namespace beaker
 
     std::stringstream ss;
     ss << "cannot convert " << *e->get_type() << " to " << *t;
-    throw std::runtime_error(ss.str());
+    error(e->get_location(), ss.str());
   }
 
   Expression*
   Semantics::convert_to_value(Expression* e)
   {
     if (Reference_type* rt = get_if_ref_type(e))
-      return make_value_conversion(rt->get_object_type(), e);
+      return make_value_conversion(m_cxt, rt->get_object_type(), e);
     return e;
   }
 
@@ -165,7 +165,7 @@ namespace beaker
   Semantics::convert_to_value(Expression* e, Type* t)
   {
     // Make sure we're converting to a reference type.
-    if (auto* rt = dynamic_cast<Reference_type*>(t))
+    if (auto* rt = dyn_cast<Reference_type>(t))
       t = rt->get_object_type();
     return convert_to_type(e, t);
   }
@@ -187,7 +187,7 @@ namespace beaker
     case Type::int_kind:
     case Type::float_kind:
     case Type::func_kind:
-      return make_bool_conversion(b, e);
+      return fold(make_bool_conversion(m_cxt, b, e));
 
     default:
       break;
@@ -195,7 +195,7 @@ namespace beaker
 
     std::stringstream ss;
     ss << "cannot convert " << *t << " to bool";
-    throw std::runtime_error(ss.str());
+    error(e->get_location(), ss.str());
   }
 
   Expression*
@@ -207,10 +207,10 @@ namespace beaker
     Type* t = e->get_type();
     switch (t->get_kind()) {
     case Type::bool_kind:
-      return make_int_promotion(z, e);
+      return fold(make_int_promotion(m_cxt, z, e));
 
     case Type::float_kind:
-      return make_float_demotion(z, e);
+      return fold(make_float_demotion(m_cxt, z, e));
     
     case Type::int_kind:
       return convert_integer(e, z);
@@ -221,7 +221,7 @@ namespace beaker
 
     std::stringstream ss;
     ss << "cannot convert " << *t << " to " << *z;
-    throw std::runtime_error(ss.str());
+    error(e->get_location(), ss.str());
   }
 
   Expression*
@@ -240,14 +240,14 @@ namespace beaker
   {
     assert(get_int_rank(e) < z->get_rank());
     /// FIXME: Implement zero extensions for unsigned types.
-    return make_sign_extension(z, e);
+    return fold(make_sign_extension(m_cxt, z, e));
   }
 
   Expression*
   Semantics::truncate_integer(Expression* e, Int_type* z)
   {
     assert(get_int_rank(e) > z->get_rank());
-    return make_int_truncation(z, e);
+    return fold(make_int_truncation(m_cxt, z, e));
   }
 
   Expression*
@@ -262,7 +262,7 @@ namespace beaker
       return convert_floating_point(e, f);
     
     case Type::int_kind:
-      return make_float_promotion(f, e);
+      return fold(make_float_promotion(m_cxt, f, e));
     
     default:
       break;
@@ -270,7 +270,7 @@ namespace beaker
 
     std::stringstream ss;
     ss << "cannot convert " << *t << " to " << *f;
-    throw std::runtime_error(ss.str());
+    error(e->get_location(), ss.str());
   }
 
   Expression*
@@ -288,14 +288,14 @@ namespace beaker
   Semantics::extend_floating_point(Expression* e, Float_type* f)
   {
     assert(get_fp_rank(e) < f->get_rank());
-    return make_float_extension(f, e);
+    return fold(make_float_extension(m_cxt, f, e));
   }
 
   Expression*
   Semantics::truncate_floating_point(Expression* e, Float_type* f)
   {
     assert(get_fp_rank(e) > f->get_rank());
-    return make_float_truncation(f, e);
+    return fold(make_float_truncation(m_cxt, f, e));
   }
 
   /// Returns true if t1 and t2 are both references.
@@ -321,7 +321,7 @@ namespace beaker
 
     std::stringstream ss;
     ss << "cannot convert " << *e->get_type() << " to " << *r;
-    throw std::runtime_error(ss.str());
+    error(e->get_location(), ss.str());
   }
 
   Expression_pair
@@ -358,7 +358,7 @@ namespace beaker
 
     std::stringstream ss;
     ss << "no common reference type for " << *t1 << " and " << *t2;
-    throw std::runtime_error(ss.str());
+    error(e1->get_location(), ss.str());
   }
 
   /// Returns true if both types are integers point types.
@@ -417,7 +417,7 @@ namespace beaker
 
     std::stringstream ss;
     ss << "no common type for " << *t1 << " and " << *t2;
-    throw std::runtime_error(ss.str());
+    error(e1->get_location(), ss.str());
   }
 
   Expression_pair
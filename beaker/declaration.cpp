@@ -32,6 +32,7 @@ namespace beaker
     case ref_kind: return "reference-declaration";
     case parm_kind: return "parameter";
     case assert_kind: return "assertion";
+    case import_kind: return "import-declaration";
     default:
       break;
     }
@@ -44,6 +45,7 @@ namespace beaker
     switch (m_kind) {
     case tu_kind:
     case func_kind:
+    case import_kind:
       return true;
     default:
       return false;
@@ -69,11 +71,19 @@ namespace beaker
       return static_cast<Translation_unit*>(self);
     case func_kind:
       return static_cast<Function_declaration*>(self);
+    case import_kind:
+      return static_cast<Import_declaration*>(self);
     default:
       __builtin_unreachable();
     }
   }
 
+  bool
+  Declaration::is_imported() const
+  {
+    return m_scope && m_scope->get_decl_kind() == import_kind;
+  }
+
   Declaration*
   Declaration::get_enclosing_declaration() const
   {
@@ -152,7 +162,8 @@ namespace beaker
   Data_declaration::has_static_storage() const
   {
     // FIXME: Namespaces can also have static storage.
-    return get_enclosing_declaration()->is_translation_unit();
+    Declaration* d = get_enclosing_declaration();
+    return d->is_translation_unit() || d->is_import();
   }
 
   bool
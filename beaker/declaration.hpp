@@ -3,6 +3,7 @@
 #include <beaker/common.hpp>
 #include <beaker/symbol.hpp>
 #include <beaker/location.hpp>
+#include <beaker/arena.hpp>
 
 #include <unordered_map>
 
@@ -14,6 +15,7 @@ namespace beaker
   class Scoped_declaration;
   class Named_declaration;
   class Function_type;
+  class Module_interface;
 
 
   /// Associates names with declarations.
@@ -82,21 +84,26 @@ namespace beaker
   class Declaration
   {
   public:
+    /// The kinds of declarations. The kinds of each intermediate base class
+    /// are contiguous; see the `classof` member of each class.
     enum Kind
     {
       tu_kind,
+      assert_kind,
+
+      // named declarations
       func_kind,
       val_kind,
       var_kind,
       ref_kind,
       parm_kind,
-      assert_kind,
+      import_kind,
     };
 
   protected:
     /// Construct a declaration of kind `k` in the scoped declaration.
     Declaration(Kind k, Scoped_declaration* sd, Location start)
-      : m_kind(k), m_scope(sd), m_start(start)
+      : m_kind(k), m_start(start), m_scope(sd)
     { }
 
   public:
@@ -132,6 +139,13 @@ namespace beaker
     /// Returns true if this is a reference definition.
     bool is_reference() const { return m_kind == ref_kind; }
 
+    /// Returns true if this is an import declaration.
+    bool is_import() const { return m_kind == import_kind; }
+
+    /// Returns true if this declaration was loaded from the interface of
+    /// another module.
+    bool is_imported() const;
+
     /// Returns true if this is a scoped declaration.
     bool is_scoped() const;
 
@@ -166,11 +180,11 @@ namespace beaker
     /// The kind of declaration.
     Kind m_kind;
 
-    /// The region of source text associated with the declaration.
-    Scoped_declaration* m_scope;
-
     /// The starting location of the declaration.
     Location m_start;
+
+    /// The region of source text associated with the declaration.
+    Scoped_declaration* m_scope;
   };
 
 
@@ -241,10 +255,23 @@ namespace beaker
   class Translation_unit : public Declaration, public Scoped_declaration
   {
   public:
+    static bool classof(const Declaration* p) { return p->get_kind() == tu_kind; }
+
     /// Constructs the translation unit.
     Translation_unit()
       : Declaration(tu_kind, nullptr, Location()), Scoped_declaration(this)
     { }
+
+    /// Returns the modules imported by the translation unit, in order of
+    /// import.
+    const std::vector<Import_declaration*>& get_imports() const { return m_imports; }
+
+    /// Adds an imported module.
+    void add_import(Import_declaration* d) { m_imports.push_back(d); }
+
+  private:
+    /// The imported modules.
+    std::vector<Import_declaration*> m_imports;
   };
 
 
@@ -261,6 +288,9 @@ namespace beaker
                       Location loc);
 
   public:
+    /// Named declarations are those from `func_kind` through `import_kind`.
+    static bool classof(const Declaration* p) { return p->get_kind() >= func_kind && p->get_kind() <= import_kind; }
+
     /// Returns the name of the symbol.
     Symbol get_name() const { return m_sym; }
 
@@ -299,6 +329,9 @@ namespace beaker
                       Location loc);
 
   public:
+    /// Typed declarations are those from `func_kind` through `ref_kind`.
+    static bool classof(const Declaration* p) { return p->get_kind() >= func_kind && p->get_kind() <= ref_kind; }
+
     /// Returns the type of the declaration.
     Type* get_type() const { return m_type; }
 
@@ -323,6 +356,8 @@ namespace beaker
   class Function_declaration : public Typed_declaration, public Scoped_declaration
   {
   public:
+    static bool classof(const Declaration* p) { return p->get_kind() == func_kind; }
+
     Function_declaration(Scoped_declaration* sd, 
                          Symbol sym, 
                          Location start, 
@@ -348,13 +383,10 @@ namespace beaker
     // Parameters
 
     /// Returns the parameters.
-    const Parameter_seq& get_parameters() const { return m_parms; }
-    
-    /// Returns the parameters.
-    Parameter_seq& get_parameters() { return m_parms; }
+    Parameter_list get_parameters() const { return m_parms; }
 
     /// Sets the parameters.
-    void set_parameters(Parameter_seq&& parms) { m_parms = std::move(parms); }
+    void set_parameters(Parameter_list parms) { m_parms = parms; }
 
     // Return type specifier
 
@@ -374,7 +406,7 @@ namespace beaker
 
   private:
     /// The parameters of the function.
-    Parameter_seq m_parms;
+    Parameter_list m_parms;
 
     /// The return type specifier.
     Type_specifier* m_ret;
@@ -410,6 +442,9 @@ namespace beaker
                      Location loc);
 
   public:
+    /// Data declarations are those from `val_kind` through `ref_kind`.
+    static bool classof(const Declaration* p) { return p->get_kind() >= val_kind && p->get_kind() <= ref_kind; }
+
     /// Returns the type specifier for the declaration.
     Type_specifier* get_type_specifier() const { return m_ts; }
 
@@ -458,6 +493,8 @@ namespace beaker
   class Value_declaration : public Data_declaration
   {
   public:
+    static bool classof(const Declaration* p) { return p->get_kind() == val_kind; }
+
     Value_declaration(Scoped_declaration* sd, 
                       Symbol sym, 
                       Location start, 
@@ -473,6 +510,8 @@ namespace beaker
   class Variable_declaration : public Data_declaration
   {
   public:
+    static bool classof(const Declaration* p) { return p->get_kind() == var_kind; }
+
     Variable_declaration(Scoped_declaration* sd, 
                          Symbol sym, 
                          Location start,
@@ -488,6 +527,8 @@ namespace beaker
   class Reference_declaration : public Data_declaration
   {
   public:
+    static bool classof(const Declaration* p) { return p->get_kind() == ref_kind; }
+
     Reference_declaration(Scoped_declaration* sd, 
                           Symbol sym, 
                           Location start, 
@@ -507,6 +548,8 @@ namespace beaker
   class Parameter : public Named_declaration
   {
   public:
+    static bool classof(const Declaration* p) { return p->get_kind() == parm_kind; }
+
     Parameter(Named_declaration* d);
 
     /// Returns the declared parameter.
@@ -541,7 +584,7 @@ namespace beaker
   inline Type*
   Parameter::get_type() const
   {
-    assert(dynamic_cast<const Typed_declaration*>(m_decl));
+    assert(isa<Typed_declaration>(m_decl));
     return static_cast<const Typed_declaration*>(m_decl)->get_type();
   }
 
@@ -552,6 +595,8 @@ namespace beaker
   class Assertion : public Declaration
   {
   public:
+    static bool classof(const Declaration* p) { return p->get_kind() == assert_kind; }
+
     Assertion(Scoped_declaration* sd, Expression* e, Location kw)
       : Declaration(assert_kind, sd, kw), m_expr(e)
     { }
@@ -563,4 +608,39 @@ namespace beaker
     Expression* m_expr;
   };
 
+
+  /// Represents the import of a module. Imported declarations are loaded
+  /// from the module's interface only when their names are looked up, and
+  /// are owned by the import.
+  class Import_declaration : public Named_declaration, public Scoped_declaration
+  {
+  public:
+    static bool classof(const Declaration* p) { return p->get_kind() == import_kind; }
+
+    Import_declaration(Scoped_declaration* sd, 
+                       Symbol sym, 
+                       Module_interface* mi,
+                       Location start, 
+                       Location loc)
+      : Named_declaration(import_kind, sd, sym, start, loc), 
+        Scoped_declaration(this),
+        m_module(mi)
+    { }
+
+    /// Returns the interface of the imported module.
+    Module_interface* get_interface() const { return m_module; }
+
+  private:
+    /// The interface of the imported module. This is owned by the context.
+    Module_interface* m_module;
+  };
+
+
+  /// Declarations own no resources unless they are scoped, so only scoped
+  /// declarations are destroyed by an arena.
+  template<typename T>
+  struct Arena_destroy<T, std::enable_if_t<std::is_base_of<Declaration, T>::value>>
+    : std::is_base_of<Scoped_declaration, T>
+  { };
+
 } // namespace beaker
@@ -4,11 +4,17 @@
 #include "value.hpp"
 #include "object.hpp"
 
+#include <stdexcept>
+
 namespace beaker
 {
   void
   Evaluator::elaborate(const Declaration* d)
   {
+    // Imported declarations have no definition to evaluate.
+    if (d->is_imported())
+      throw std::runtime_error("use of imported declaration in constant expression");
+
     switch (d->get_kind()) {
     default:
       break;
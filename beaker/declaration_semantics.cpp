@@ -20,7 +20,7 @@ namespace beaker
   Declaration*
   Semantics::on_start_translation()
   {
-    Translation_unit* tu = new Translation_unit();
+    Translation_unit* tu = m_cxt.make<Translation_unit>();
 
     // FIXME: Anything else to do here?
 
@@ -42,7 +42,7 @@ namespace beaker
     Scoped_declaration* owner = sema.get_current_declaration();
     Symbol sym = id.get_symbol();
     Location loc = id.get_location();
-    return new Value_declaration(owner, sym, loc, loc);
+    return sema.get_context().make<Value_declaration>(owner, sym, loc, loc);
   }
 
   // Create a value declaration with an introducer.
@@ -53,7 +53,7 @@ namespace beaker
     Location start = intro.get_location();
     Location loc = id.get_location();
     Symbol sym = id.get_symbol();
-    return new Value_declaration(owner, sym, start, loc);
+    return sema.get_context().make<Value_declaration>(owner, sym, start, loc);
   }
 
   // Create a variable declaration with an introducer.
@@ -64,7 +64,7 @@ namespace beaker
     Location start = intro.get_location();
     Location loc = id.get_location();
     Symbol sym = id.get_symbol();
-    return new Variable_declaration(owner, sym, start, loc);
+    return sema.get_context().make<Variable_declaration>(owner, sym, start, loc);
   }
 
   // Create a reference declaration with an introducer.
@@ -75,7 +75,7 @@ namespace beaker
     Location start = intro.get_location();
     Location loc = id.get_location();
     Symbol sym = id.get_symbol();
-    return new Reference_declaration(owner, sym, start, loc);
+    return sema.get_context().make<Reference_declaration>(owner, sym, start, loc);
   }
 
   // Allocate a declaration of the appropriate kind.
@@ -104,7 +104,7 @@ namespace beaker
 
     // Set the adjusted type of the data declaration.
     Type* t = ts->get_type();
-    if (auto* ref = dynamic_cast<Reference_declaration*>(d))
+    if (isa<Reference_declaration>(d))
       t = sema.get_context().get_reference_type(t);
     d->set_type(t);
   }
@@ -171,7 +171,7 @@ namespace beaker
     Location start = kw.get_location();
     Location loc = id.get_location();
     Symbol sym = id.get_symbol();
-    Function_declaration* fn = new Function_declaration(m_decl, sym, start, loc);
+    Function_declaration* fn = m_cxt.make<Function_declaration>(m_decl, sym, start, loc);
 
     // Identify the declaration
     identify(fn);
@@ -203,7 +203,7 @@ namespace beaker
     fn->set_type(make_fn_type(m_cxt, parms, ret));
 
     // Set the parameters and return specifier.
-    fn->set_parameters(std::move(parms));
+    fn->set_parameters(m_cxt.make_span(parms));
     fn->set_return(ret);
     
     return fn;
@@ -216,7 +216,7 @@ namespace beaker
 
     // Create the function definition and make it the function body.
     // We're going to add statements later.
-    Block_statement* body = new Block_statement();
+    Block_statement* body = m_cxt.make<Block_statement>();
     fn->set_body(body);
     
     // Enter block scope.
@@ -243,7 +243,7 @@ namespace beaker
     leave_scope(body);
 
     // Update the function definition.
-    body->set_statements(std::move(ss));
+    body->set_statements(m_cxt.make_span(ss));
     body->set_brace_locations(lbrace.get_location(), rbrace.get_location());
 
     // FIXME: Perform final analysis of the function.
@@ -264,7 +264,7 @@ namespace beaker
     set_data_type(*this, inner, type);
 
     // Build the parameter over the underlying declaration. 
-    Parameter* parm = new Parameter(inner);
+    Parameter* parm = m_cxt.make<Parameter>(inner);
 
     // Identify and declare the parameter.
     identify(parm);
@@ -284,7 +284,7 @@ namespace beaker
     set_data_type(*this, inner, type);
 
     // Build the parameter over the underlying declaration. 
-    Parameter* parm = new Parameter(inner);
+    Parameter* parm = m_cxt.make<Parameter>(inner);
 
     // Identify and declare the parameter.
     identify(parm);
@@ -313,7 +313,7 @@ namespace beaker
 
     // Create the assertion and add it to the owner.
     Scoped_declaration* owner = get_current_declaration();
-    auto* decl = new Assertion(owner, cond, kw.get_location());
+    auto* decl = m_cxt.make<Assertion>(owner, cond, kw.get_location());
     owner->add_hidden_declaration(decl);
 
     // If we're not in block scope, evaluate the condition, possibly making
@@ -321,12 +321,35 @@ namespace beaker
     if (!get_current_block()) {
       Value result = evaluate(m_cxt, cond);
       if (!result.get_int())
-        throw std::runtime_error("static assertion failed");
+        error(kw.get_location(), "static assertion failed");
     }
 
     return decl;
   }
 
+  /// Opens the interface of the imported module. Nothing is loaded from the
+  /// interface until names are looked up.
+  Declaration*
+  Semantics::on_import(const Token& kw, const Token& id, const Token& semi)
+  {
+    Module_interface* mi = m_cxt.get_module_interface(id.get_symbol());
+
+    Scoped_declaration* owner = get_current_declaration();
+    assert(owner->is_translation_unit());
+    Translation_unit* tu = static_cast<Translation_unit*>(owner->cast_as_declaration());
+    for (Import_declaration* imp : tu->get_imports()) {
+      if (imp->get_interface() == mi)
+        return imp;
+    }
+
+    Location start = kw.get_location();
+    Location loc = id.get_location();
+    auto* imp = m_cxt.make<Import_declaration>(owner, id.get_symbol(), mi, start, loc);
+    owner->add_hidden_declaration(imp);
+    tu->add_import(imp);
+    return imp;
+  }
+
   // Declaration
 
   // Make a declaration available for name lookup.
@@ -337,15 +360,22 @@ namespace beaker
     //
     // FIXME: Allow multiple declarations of functions, although we have
     // to check them at the point of declaration.
-    Declaration_set decls = m_scope->lookup(d->get_name());
-    if (!decls.is_empty()) {
+    bool found;
+    if (!m_blocks.is_empty())
+      found = m_blocks.lookup_current(d->get_name());
+    else
+      found = !m_scope->lookup(d->get_name()).is_empty();
+    if (found) {
       std::stringstream ss;
       ss << "redeclaration of " << *d->get_name();
-      throw std::runtime_error(ss.str());
+      error(d->get_name_location(), ss.str());
     }
 
     // Make the declaration available for lookup.
-    m_scope->declare(d);
+    if (!m_blocks.is_empty())
+      m_blocks.declare(d);
+    else
+      m_scope->declare(d);
   }
 
   // Verify that the declaration is valid.
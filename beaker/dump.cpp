@@ -192,7 +192,19 @@ namespace beaker
   static void
   dump_literal_attributes(Dump_context& dc, const Literal* e)
   {
-    dc.get_stream() << " value=" << '\'' << e->get_token() << '\'';
+    std::ostream& os = dc.get_stream();
+    os << " value=" << '\'';
+    switch (e->get_kind()) {
+    case Expression::bool_kind:
+      os << (static_cast<const Bool_literal*>(e)->get_value() ? "true" : "false");
+      break;
+    case Expression::int_kind:
+      os << static_cast<const Int_literal*>(e)->get_value();
+      break;
+    default:
+      break;
+    }
+    os << '\'';
   }
 
   static void
@@ -204,6 +216,12 @@ namespace beaker
       dc.get_stream() << " ref=<null>";
   }
 
+  static void
+  dump_folded_attributes(Dump_context& dc, const Folded_expression* e)
+  {
+    dc.get_stream() << " value=" << '\'' << e->get_value() << '\'';
+  }
+
   static void
   dump_conversion_attributes(Dump_context& dc, const Implicit_conversion* e)
   {
@@ -232,6 +250,9 @@ namespace beaker
     case Expression::init_kind:
       return dump_id_attributes(dc, static_cast<const Id_expression*>(e));
 
+    case Expression::fold_kind:
+      return dump_folded_attributes(dc, static_cast<const Folded_expression*>(e));
+
     case Expression::imp_conv:
       return dump_conversion_attributes(dc, static_cast<const Implicit_conversion*>(e));
 
@@ -264,6 +285,20 @@ namespace beaker
     dump(dc, e->get_third());
   }
 
+  static void
+  dump_folded_children(Dump_context& dc, const Folded_expression* e)
+  {
+    Indent_around indent(dc);
+    dump(dc, e->get_expression());
+  }
+
+  static void
+  dump_located_children(Dump_context& dc, const Located_expression* e)
+  {
+    Indent_around indent(dc);
+    dump(dc, e->get_expression());
+  }
+
   static void
   dump_initializer_children(Dump_context& dc, const Value_initializer* e)
   {
@@ -290,6 +325,12 @@ namespace beaker
     case Expression::id_kind:
       // These nodes have no subexpressions.
       return;
+
+    case Expression::fold_kind:
+      return dump_folded_children(dc, static_cast<const Folded_expression*>(e));
+
+    case Expression::loc_kind:
+      return dump_located_children(dc, static_cast<const Located_expression*>(e));
     
     case Expression::neg_kind:
     case Expression::rec_kind:
@@ -506,6 +547,9 @@ namespace beaker
     
     case Declaration::assert_kind:
       return;
+
+    case Declaration::import_kind:
+      return dump_named_attributes(dc, static_cast<const Named_declaration*>(d));
     }
   }
 
@@ -597,6 +641,9 @@ namespace beaker
 
     case Declaration::assert_kind:
       return dump_assertion_children(dc, static_cast<const Assertion*>(d));
+
+    case Declaration::import_kind:
+      return;
     }
   }
 
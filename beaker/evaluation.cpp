@@ -51,9 +51,9 @@ namespace beaker
   Value
   Evaluator::fetch(const Typed_declaration* d)
   {
-    if (const Data_declaration* dd = dynamic_cast<const Data_declaration*>(d))
+    if (const Data_declaration* dd = dyn_cast<Data_declaration>(d))
       return fetch_data(dd);
-    else if (const Function_declaration* fn = dynamic_cast<const Function_declaration*>(d))
+    else if (const Function_declaration* fn = dyn_cast<Function_declaration>(d))
       return fetch_function(fn);
     assert(false);
   }
@@ -65,7 +65,8 @@ namespace beaker
     enum Mode 
     {
       /// A simple form of evaluation that folds constant expressions.
-      /// This limits 
+      /// This is limited to literals, folded expressions, and constants
+      /// whose initializers are known. No declaration is elaborated.
       constant_fold,
 
       /// Applies the rules of constant expression evaluation and fails if
@@ -76,32 +77,75 @@ namespace beaker
       /// Applies the rules of constant expression evaluation, except that
       /// it is not an error to encounter non-constant expressions.
       potential_eval,
+
+      /// Applies the rules of constant expression evaluation to the
+      /// initializers of static data. No code runs before static data is
+      /// initialized, so the initial values of static variables can be
+      /// read.
+      static_init,
     };
 
     Evaluator(Context& cxt, Mode mode)
-      : m_cxt(cxt)
+      : m_cxt(cxt), m_mode(mode)
     { }
 
-    /// Evaluate an expression, returning a value.
+    /// Evaluate an expression, returning a value. During constant
+    /// expression evaluation, the values of canonical expressions are
+    /// memoized by the context and computed at most once.
     Value evaluate(const Expression* e);
 
+    /// Evaluate an expression without consulting the memoized values.
+    Value evaluate_expression(const Expression* e);
+
     // Basic expressions
     Value evaluate_bool_literal(const Bool_literal* e);
     Value evaluate_int_literal(const Int_literal* e);
     Value evaluate_id_expression(const Id_expression* e);
     Value evaluate_init_expression(const Id_expression* e);
+    Value evaluate_folded_expression(const Folded_expression* e);
+
+    // Arithmetic expressions
+    Value evaluate_addition_expression(const Addition_expression* e);
+    Value evaluate_subtraction_expression(const Subtraction_expression* e);
+    Value evaluate_multiplication_expression(const Multiplication_expression* e);
+    Value evaluate_quotient_expression(const Quotient_expression* e);
+    Value evaluate_remainder_expression(const Remainder_expression* e);
+    Value evaluate_division_expression(const Division_expression* e);
+    Value evaluate_negation_expression(const Negation_expression* e);
+    Value evaluate_reciprocal_expression(const Reciprocal_expression* e);
+
+    // Bitwise expressions
+    Value evaluate_bitwise_and_expression(const Bitwise_and_expression* e);
+    Value evaluate_bitwise_or_expression(const Bitwise_or_expression* e);
+    Value evaluate_bitwise_xor_expression(const Bitwise_xor_expression* e);
+    Value evaluate_bitwise_not_expression(const Bitwise_not_expression* e);
+    Value evaluate_shift_left_expression(const Shift_left_expression* e);
+    Value evaluate_shift_right_expression(const Shift_right_expression* e);
 
     // Logical expressions
     Value evaluate_conditional_expression(const Conditional_expression* e);
     Value evaluate_logical_and_expression(const Logical_and_expression* e);
     Value evaluate_logical_or_expression(const Logical_or_expression* e);
     Value evaluate_logical_not_expression(const Logical_not_expression* e);
+
+    // Relational expressions
+    Value evaluate_equal_to_expression(const Equal_to_expression* e);
+    Value evaluate_not_equal_to_expression(const Not_equal_to_expression* e);
+    Value evaluate_less_than_expression(const Less_than_expression* e);
+    Value evaluate_greater_than_expression(const Greater_than_expression* e);
+    Value evaluate_not_greater_than_expression(const Not_greater_than_expression* e);
+    Value evaluate_not_less_than_expression(const Not_less_than_expression* e);
+
+    // Object expressions
+    Value evaluate_assignment_expression(const Assignment_expression* e);
   
     // Conversions
     Value evaluate_implicit_conversion(const Implicit_conversion* e);
     Value convert_to_value(const Expression* e);
 
     // Initializers
+    Value evaluate_empty_initializer(const Empty_initializer* e);
+    Value evaluate_default_initializer(const Default_initializer* e);
     Value evaluate_value_initializer(const Value_initializer* e);
 
     // Declarations
@@ -129,6 +173,9 @@ namespace beaker
     /// The translation context.
     Context& m_cxt;
 
+    /// The evaluation mode.
+    Mode m_mode;
+
     /// The static store.
     Static_store m_statics;
   };
@@ -155,6 +202,17 @@ namespace beaker
   };
 
 
+  /// A helper class that constructs an evaluator for the initializers of
+  /// static data.
+  class Static_evaluator : public Evaluator
+  {
+  public:
+    Static_evaluator(Context& cxt)
+      : Evaluator(cxt, static_init)
+    { }
+  };
+
+
   // ------------------------------------------------------------------------ //
   // Helper functions
 
@@ -16,6 +16,7 @@ namespace beaker
     // id expressions
     case id_kind: return "id-expression";
     case init_kind: return "init-expression";
+    case fold_kind: return "folded-expression";
 
     // arithmetic expressions
     case add_kind: return "addition-expression";
@@ -58,6 +59,9 @@ namespace beaker
     case empty_init: return "empty-initializer";
     case def_init: return "default-initializer";
     case val_init: return "value-initializer";
+
+    // Uses
+    case loc_kind: return "located-expression";
     
     default: __builtin_unreachable();
     }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <beaker/common.hpp>
+#include <beaker/arena.hpp>
 #include <beaker/token.hpp>
+#include <beaker/value.hpp>
 
 namespace beaker
 {
@@ -9,12 +11,25 @@ namespace beaker
   class Expression
   {
   public:
+    /// The kinds of expressions. Expressions are grouped by their number
+    /// of operands so that the kinds of each intermediate base class are
+    /// contiguous; see the `classof` member of each class.
     enum Kind
     {
       bool_kind,
       int_kind,
       id_kind,
       init_kind,
+      fold_kind,
+
+      // unary operators
+      neg_kind,
+      rec_kind,
+      bit_not_kind,
+      not_kind,
+
+      // conversions
+      imp_conv,
 
       // arithmetic expressions
       add_kind,
@@ -23,22 +38,17 @@ namespace beaker
       quo_kind,
       rem_kind,
       div_kind,
-      neg_kind,
-      rec_kind,
 
       // bitwise expressions
       bit_and_kind,
       bit_ior_kind,
       bit_xor_kind,
-      bit_not_kind,
       bit_shl_kind,
       bit_shr_kind,
 
       // logical expressions
-      cond_kind,
       and_kind,
       or_kind,
-      not_kind,
 
       // relational expressions
       eq_kind,
@@ -51,19 +61,28 @@ namespace beaker
       // object expressions
       assign_kind,
 
-      // conversions
-      imp_conv,
+      // ternary operators
+      cond_kind,
       
       // initializers
       empty_init, // implicit default initialization
       def_init, // explicit default initialization
       val_init, // value/copy initialization
+
+      // uses
+      loc_kind, // a use of a shared expression at another location
     };
 
   protected:
     /// Constructs an expression of the given kind and type.
     Expression(Kind k, Type* t)
-      : m_kind(k), m_type(t)
+      : m_kind(k), m_loc(), m_type(t)
+    { }
+
+    /// Constructs an expression of the given kind and type, spelled by the
+    /// token at `loc`.
+    Expression(Kind k, Type* t, Location loc)
+      : m_kind(k), m_loc(loc), m_type(t)
     { }
 
   public:
@@ -83,6 +102,11 @@ namespace beaker
 
     // Location
 
+    /// Returns the location of the token that spells the expression: the
+    /// literal or the operator. This is invalid for expressions that are
+    /// not spelled, such as implicit conversions.
+    Location get_location() const { return m_loc; }
+
     /// Returns the start location of the this statement.
     virtual Location get_start_location() const { return Location(); }
     
@@ -97,31 +121,33 @@ namespace beaker
     /// The kind of declaration.
     Kind m_kind;
 
+    /// The location of the spelling token. This fills what would otherwise
+    /// be padding after the kind.
+    Location m_loc;
+
     /// The type of the expression.
     Type* m_type;
   };
 
 
-  /// Represents literals comprised of a single token.
+  /// Represents literals comprised of a single token. Only the location of
+  /// the token is retained; its value is stored by the derived class.
   class Literal : public Expression
   {
   protected:
     Literal(Kind k, Type* t, const Token& tok)
-      : Expression(k, t), m_tok(tok)
+      : Expression(k, t, tok.get_location())
     { }
 
   public:
-    /// Returns the token for the literal.
-    const Token& get_token() const { return m_tok; }
+    /// Literals are those from `bool_kind` through `int_kind`.
+    static bool classof(const Expression* p) { return p->get_kind() >= bool_kind && p->get_kind() <= int_kind; }
 
     /// Returns the start location of the this statement.
-    Location get_start_location() const override { return m_tok.get_location(); }
+    Location get_start_location() const override { return get_location(); }
     
     /// Returns the end location of the this statement.
-    Location get_end_location() const override { return m_tok.get_location(); }
-
-  private:
-    Token m_tok;
+    Location get_end_location() const override { return get_location(); }
   };
 
 
@@ -129,6 +155,8 @@ namespace beaker
   class Bool_literal : public Literal
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == bool_kind; }
+
     Bool_literal(Type* t, const Token& tok, bool val)
       : Literal(bool_kind, t, tok), m_value(val)
     { }
@@ -145,6 +173,8 @@ namespace beaker
   class Int_literal : public Literal
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == int_kind; }
+
     Int_literal(Type* t, const Token& tok, std::intmax_t val)
       : Literal(int_kind, t, tok), m_value(val)
     { }
@@ -166,6 +196,9 @@ namespace beaker
     { }
   
   public:
+    /// Id expressions are those from `id_kind` through `init_kind`.
+    static bool classof(const Expression* p) { return p->get_kind() >= id_kind && p->get_kind() <= init_kind; }
+
     Id_expression(Type* t, Typed_declaration* d)
       : Expression(id_kind, t), m_decl(d)
     { }
@@ -183,12 +216,107 @@ namespace beaker
   class Init_expression : public Id_expression
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == init_kind; }
+
     Init_expression(Type* t, Typed_declaration* d)
       : Id_expression(init_kind, t, d)
     { }
   };
 
 
+  /// Represents the value of an expression computed during semantic
+  /// analysis. Operator expressions and conversions whose operands have
+  /// known values are replaced by their folded values, so that later
+  /// phases need not compute them. The expression as written is retained
+  /// for diagnostics, but is not evaluated again.
+  class Folded_expression : public Expression
+  {
+  public:
+    static bool classof(const Expression* p) { return p->get_kind() == fold_kind; }
+
+    Folded_expression(Type* t, Expression* e, const Value& v)
+      : Expression(fold_kind, t, e->get_location()), m_expr(e), m_value(v)
+    { }
+
+    /// Returns the expression as written.
+    Expression* get_expression() const { return m_expr; }
+
+    /// Returns the value of the expression.
+    const Value& get_value() const { return m_value; }
+
+    /// Returns the start location of the expression as written.
+    Location get_start_location() const override { return m_expr->get_start_location(); }
+
+    /// Returns the end location of the expression as written.
+    Location get_end_location() const override { return m_expr->get_end_location(); }
+
+  private:
+    /// The expression as written.
+    Expression* m_expr;
+
+    /// The value of the expression.
+    Value m_value;
+  };
+
+
+  /// Represents a use of a canonical expression whose locations differ from
+  /// those of the canonical expression. Canonical expressions are shared by
+  /// all structurally equal uses, but only carry the locations of the first
+  /// one; the locations of every other use are recorded here. A located
+  /// expression is otherwise transparent: it has the type and value of the
+  /// expression it wraps, and is never itself canonical.
+  class Located_expression : public Expression
+  {
+  public:
+    static bool classof(const Expression* p) { return p->get_kind() == loc_kind; }
+
+    /// Constructs a use of `e` with the locations of `use`.
+    Located_expression(Expression* e, const Expression& use)
+      : Expression(loc_kind, e->get_type(), use.get_location()),
+        m_expr(e),
+        m_start(use.get_start_location()),
+        m_end(use.get_end_location())
+    { }
+
+    /// Returns the canonical expression.
+    Expression* get_expression() const { return m_expr; }
+
+    /// Returns the start location of this use.
+    Location get_start_location() const override { return m_start; }
+
+    /// Returns the end location of this use.
+    Location get_end_location() const override { return m_end; }
+
+  private:
+    /// The canonical expression.
+    Expression* m_expr;
+
+    /// The start location of the use.
+    Location m_start;
+
+    /// The end location of the use.
+    Location m_end;
+  };
+
+  /// Returns the expression used by `e`. This looks through located
+  /// expressions.
+  inline Expression*
+  get_used_expression(Expression* e)
+  {
+    if (Located_expression* loc = dyn_cast<Located_expression>(e))
+      return loc->get_expression();
+    return e;
+  }
+
+  inline const Expression*
+  get_used_expression(const Expression* e)
+  {
+    if (const Located_expression* loc = dyn_cast<Located_expression>(e))
+      return loc->get_expression();
+    return e;
+  }
+
+
   /// The base class of all unary expressions.
   class Unary_expression : public Expression
   {
@@ -197,7 +325,14 @@ namespace beaker
       : Expression(k, t), m_expr(e)
     { }
 
+    Unary_expression(Kind k, Type* t, Expression* e, Location loc)
+      : Expression(k, t, loc), m_expr(e)
+    { }
+
   public:
+    /// Unary expressions are those from `neg_kind` through `imp_conv`.
+    static bool classof(const Expression* p) { return p->get_kind() >= neg_kind && p->get_kind() <= imp_conv; }
+
     /// Returns the operand of the expression.
     Expression* get_operand() const { return m_expr; }
 
@@ -214,7 +349,14 @@ namespace beaker
       : Expression(k, t), m_exprs{lhs, rhs}
     { }
 
+    Binary_expression(Kind k, Type* t, Expression* lhs, Expression* rhs, Location loc)
+      : Expression(k, t, loc), m_exprs{lhs, rhs}
+    { }
+
   public:
+    /// Binary expressions are those from `add_kind` through `assign_kind`.
+    static bool classof(const Expression* p) { return p->get_kind() >= add_kind && p->get_kind() <= assign_kind; }
+
     /// Returns the left-hand operand.
     Expression* get_lhs() const { return m_exprs[0]; }
 
@@ -234,7 +376,13 @@ namespace beaker
       : Expression(k, t), m_exprs{e1, e2, e3}
     { }
 
+    Ternary_expression(Kind k, Type* t, Expression* e1, Expression* e2, Expression* e3, Location loc)
+      : Expression(k, t, loc), m_exprs{e1, e2, e3}
+    { }
+
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == cond_kind; }
+
     /// Returns the first operand.
     Expression* get_first() const { return m_exprs[0]; }
 
@@ -254,12 +402,15 @@ namespace beaker
   {
   protected:
     Unary_operator(Kind k, Type* t, Expression* e, const Token& op)
-      : Unary_expression(k, t, e), m_op(op)
+      : Unary_expression(k, t, e, op.get_location())
     { }
 
   public:
-    /// Returns the operator token.
-    const Token& get_operator() const { return m_op; }
+    /// Unary operators are those from `neg_kind` through `not_kind`.
+    static bool classof(const Expression* p) { return p->get_kind() >= neg_kind && p->get_kind() <= not_kind; }
+
+    /// Returns the location of the operator.
+    Location get_operator_location() const { return get_location(); }
 
     /// Returns the start location of the expression. This is the location
     /// of the operator token.
@@ -268,15 +419,12 @@ namespace beaker
     /// Returns the end location of the expression. This is the end location
     /// of the operand.
     Location get_end_location() const override;
-
-  private:
-    Token m_op;
   };
 
   inline Location
   Unary_operator::get_start_location() const
   {
-    return m_op.get_location();
+    return get_location();
   }
   
   inline Location
@@ -292,12 +440,15 @@ namespace beaker
   {
   protected:
     Binary_operator(Kind k, Type* t, Expression* lhs, Expression* rhs, const Token& op)
-      : Binary_expression(k, t, lhs, rhs), m_op(op)
+      : Binary_expression(k, t, lhs, rhs, op.get_location())
     { }
 
   public:
-    /// Returns the operator token.
-    const Token& get_operator() const { return m_op; }
+    /// Binary operators are those from `add_kind` through `assign_kind`.
+    static bool classof(const Expression* p) { return p->get_kind() >= add_kind && p->get_kind() <= assign_kind; }
+
+    /// Returns the location of the operator.
+    Location get_operator_location() const { return get_location(); }
 
     /// Returns the start location of the expression. This is the start 
     /// location of the left-hand operand.
@@ -306,9 +457,6 @@ namespace beaker
     /// Returns the end location of the expression. This is the end location
     /// of the right-hand operand.
     Location get_end_location() const override;
-
-  private:
-    Token m_op;
   };
 
   inline Location
@@ -336,15 +484,18 @@ namespace beaker
                      Expression* e3,
                      const Token& tok1,
                      const Token& tok2)
-      : Ternary_expression(k, t, e1, e2, e3), m_toks{tok1, tok2}
+      : Ternary_expression(k, t, e1, e2, e3, tok1.get_location()), 
+        m_sep(tok2.get_location())
     { }
 
   public:
-    /// Returns the operator token (the first token).
-    const Token& get_operator() const { return m_toks[0]; }
+    static bool classof(const Expression* p) { return p->get_kind() == cond_kind; }
+
+    /// Returns the location of the operator (the first token).
+    Location get_operator_location() const { return get_location(); }
 
-    /// Returns the separator token (the second toke).
-    const Token& get_separator() const { return m_toks[1]; }
+    /// Returns the location of the separator (the second token).
+    Location get_separator_location() const { return m_sep; }
 
     /// Returns the start location of the expression. This is the start 
     /// location of the first operand.
@@ -355,7 +506,8 @@ namespace beaker
     Location get_end_location() const override;
 
   private:
-    Token m_toks[2];
+    /// The location of the separator.
+    Location m_sep;
   };
 
   inline Location
@@ -377,9 +529,19 @@ namespace beaker
   class Assignment_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == assign_kind; }
+
     Assignment_expression(Type* t, Expression* e1, Expression* e2, const Token& op)
       : Binary_operator(assign_kind, t, e1, e2, op)
     { }
   };
 
+
+  /// Expressions own no resources, so they are never destroyed by an
+  /// arena.
+  template<typename T>
+  struct Arena_destroy<T, std::enable_if_t<std::is_base_of<Expression, T>::value>>
+    : std::false_type
+  { };
+
 } // namespace beaker
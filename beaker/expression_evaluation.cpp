@@ -7,11 +7,178 @@
 #include "conversion.hpp"
 #include "initializer.hpp"
 #include "declaration.hpp"
+#include "type.hpp"
+#include "context.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
 namespace beaker
 {
+  // Integer arithmetic
+  //
+  // Integer values are computed in an Int_value and then checked against
+  // the range of their type, which is determined by its rank. Types wider
+  // than an Int_value cannot be evaluated. Bool values are 0 and 1.
+
+  /// Returns the number of bits in the values of the bool or integer type
+  /// `t`. Throws an exception if `t` is wider than an Int_value.
+  static int
+  get_precision(const Type* t)
+  {
+    if (t->is_bool())
+      return 1;
+    int r = cast<Int_type>(t)->get_rank();
+    if (r > std::numeric_limits<Int_value>::digits + 1)
+      throw std::runtime_error("integer type is too wide to evaluate");
+    return r;
+  }
+
+  [[noreturn]] static void
+  overflow()
+  {
+    throw std::runtime_error("integer overflow");
+  }
+
+  /// Returns `n` if it is in the range of the bool or integer type `t`.
+  /// Otherwise, throws an exception.
+  static Value
+  check_integer(const Type* t, Int_value n)
+  {
+    int p = get_precision(t);
+    if (p == 1) {
+      if (n != 0 && n != 1)
+        overflow();
+    }
+    else if (p <= std::numeric_limits<Int_value>::digits) {
+      Int_value max = (Int_value(1) << (p - 1)) - 1;
+      if (n < -max - 1 || n > max)
+        overflow();
+    }
+    return Value(n);
+  }
+
+  /// Returns `n` reduced to the bits of the bool or integer type `t`, as
+  /// computed by fixed-width (two's complement) operations. Bool values
+  /// are not signed.
+  static Int_value
+  wrap_integer(const Type* t, Int_value n)
+  {
+    int p = get_precision(t);
+    if (p > std::numeric_limits<Int_value>::digits)
+      return n;
+    std::uintmax_t bits = std::uintmax_t(n) & ((std::uintmax_t(1) << p) - 1);
+    if (p == 1)
+      return bits;
+    std::uintmax_t sign = std::uintmax_t(1) << (p - 1);
+    return Int_value(bits ^ sign) - Int_value(sign);
+  }
+
+  /// Returns the negation of `n`, which has the bool or integer type `t`.
+  static Value
+  negate_integer(const Type* t, Int_value n)
+  {
+    Int_value r;
+    if (__builtin_sub_overflow(Int_value(0), n, &r))
+      overflow();
+    return check_integer(t, r);
+  }
+
+  /// Throws an exception if `n` is not a valid shift amount for values of
+  /// the type `t`.
+  static void
+  check_shift(const Type* t, Int_value n)
+  {
+    if (n < 0 || n >= get_precision(t))
+      throw std::runtime_error("shift amount out of range");
+  }
+
+  /// Throws an exception if `n` is zero.
+  static void
+  check_divisor(Int_value n)
+  {
+    if (n == 0)
+      throw std::runtime_error("division by zero");
+  }
+
+  // Floating point arithmetic
+  //
+  // Floating point values are computed in a Float_value and then rounded
+  // to the precision of their type. Types whose rank is at most 32 have
+  // the precision of float; types wider than a Float_value cannot be
+  // evaluated. Operands are always finite, so a result that is not finite
+  // has overflowed.
+
+  /// Returns `x` rounded to the floating point type `t` if the result is
+  /// finite. Otherwise, throws an exception.
+  static Value
+  check_float(const Type* t, Float_value x)
+  {
+    int r = cast<Float_type>(t)->get_rank();
+    if (r > Float_type::float64)
+      throw std::runtime_error("floating point type is too wide to evaluate");
+    if (r <= Float_type::float32) {
+      if (std::fabs(x) > std::numeric_limits<float>::max())
+        throw std::runtime_error("floating point overflow");
+      x = static_cast<float>(x);
+    }
+    if (!std::isfinite(x))
+      throw std::runtime_error("floating point overflow");
+    return Value(x);
+  }
+
+  /// Returns the quotient of `x` and `y`, which have the floating point
+  /// type `t`.
+  static Value
+  divide_float(const Type* t, Float_value x, Float_value y)
+  {
+    if (y == 0)
+      throw std::runtime_error("division by zero");
+    return check_float(t, x / y);
+  }
+
+  /// Returns the zero value of the type `t`.
+  static Value
+  get_zero_value(const Type* t)
+  {
+    switch (t->get_kind()) {
+    case Type::bool_kind:
+    case Type::int_kind:
+      return Value(0);
+    case Type::float_kind:
+      return Value(Float_value(0));
+    default:
+      break;
+    }
+    throw std::runtime_error("object cannot be zero-initialized");
+  }
+
+  /// Returns a negative value, zero, or a positive value when `a` is less
+  /// than, equal to, or greater than `b`. Both values are integers, or both
+  /// are floating point values.
+  static int
+  compare(const Value& a, const Value& b)
+  {
+    if (a.is_float())
+      return (a.get_float() > b.get_float()) - (a.get_float() < b.get_float());
+    return (a.get_int() > b.get_int()) - (a.get_int() < b.get_int());
+  }
+
   Value
   Evaluator::evaluate(const Expression* e)
+  {
+    if (m_mode != constant_eval)
+      return evaluate_expression(e);
+    if (const Value* v = m_cxt.get_constant_value(e))
+      return *v;
+    Value v = evaluate_expression(e);
+    m_cxt.set_constant_value(e, v);
+    return v;
+  }
+
+  Value
+  Evaluator::evaluate_expression(const Expression* e)
   {
     switch (e->get_kind()) {
     case Expression::bool_kind:
@@ -22,38 +189,40 @@ namespace beaker
       return evaluate_id_expression(static_cast<const Id_expression*>(e));
     case Expression::init_kind:
       return evaluate_init_expression(static_cast<const Init_expression*>(e));
+    case Expression::fold_kind:
+      return evaluate_folded_expression(static_cast<const Folded_expression*>(e));
 
     // arithmetic expressions
     case Expression::add_kind:
-      break;
+      return evaluate_addition_expression(static_cast<const Addition_expression*>(e));
     case Expression::sub_kind:
-      break;
+      return evaluate_subtraction_expression(static_cast<const Subtraction_expression*>(e));
     case Expression::mul_kind:
-      break;
+      return evaluate_multiplication_expression(static_cast<const Multiplication_expression*>(e));
     case Expression::quo_kind:
-      break;
+      return evaluate_quotient_expression(static_cast<const Quotient_expression*>(e));
     case Expression::rem_kind:
-      break;
+      return evaluate_remainder_expression(static_cast<const Remainder_expression*>(e));
     case Expression::div_kind:
-      break;
+      return evaluate_division_expression(static_cast<const Division_expression*>(e));
     case Expression::neg_kind:
-      break;
+      return evaluate_negation_expression(static_cast<const Negation_expression*>(e));
     case Expression::rec_kind:
-      break;
+      return evaluate_reciprocal_expression(static_cast<const Reciprocal_expression*>(e));
 
     // bitwise expressions
     case Expression::bit_and_kind:
-      break;
+      return evaluate_bitwise_and_expression(static_cast<const Bitwise_and_expression*>(e));
     case Expression::bit_ior_kind:
-      break;
+      return evaluate_bitwise_or_expression(static_cast<const Bitwise_or_expression*>(e));
     case Expression::bit_xor_kind:
-      break;
+      return evaluate_bitwise_xor_expression(static_cast<const Bitwise_xor_expression*>(e));
     case Expression::bit_not_kind:
-      break;
+      return evaluate_bitwise_not_expression(static_cast<const Bitwise_not_expression*>(e));
     case Expression::bit_shl_kind:
-      break;
+      return evaluate_shift_left_expression(static_cast<const Shift_left_expression*>(e));
     case Expression::bit_shr_kind:
-      break;
+      return evaluate_shift_right_expression(static_cast<const Shift_right_expression*>(e));
 
     // logical expressions
     case Expression::cond_kind:
@@ -67,21 +236,21 @@ namespace beaker
 
     // relational expressions
     case Expression::eq_kind:
-      break;
+      return evaluate_equal_to_expression(static_cast<const Equal_to_expression*>(e));
     case Expression::ne_kind:
-      break;
+      return evaluate_not_equal_to_expression(static_cast<const Not_equal_to_expression*>(e));
     case Expression::lt_kind:
-      break;
+      return evaluate_less_than_expression(static_cast<const Less_than_expression*>(e));
     case Expression::gt_kind:
-      break;
+      return evaluate_greater_than_expression(static_cast<const Greater_than_expression*>(e));
     case Expression::ng_kind:
-      break;
+      return evaluate_not_greater_than_expression(static_cast<const Not_greater_than_expression*>(e));
     case Expression::nl_kind:
-      break;
+      return evaluate_not_less_than_expression(static_cast<const Not_less_than_expression*>(e));
 
     // object expressions
     case Expression::assign_kind:
-      break;
+      return evaluate_assignment_expression(static_cast<const Assignment_expression*>(e));
 
     // conversions
     case Expression::imp_conv:
@@ -89,11 +258,15 @@ namespace beaker
 
     // initializers
     case Expression::empty_init:
-      break;
+      return evaluate_empty_initializer(static_cast<const Empty_initializer*>(e));
     case Expression::def_init:
-      break;
+      return evaluate_default_initializer(static_cast<const Default_initializer*>(e));
     case Expression::val_init:
       return evaluate_value_initializer(static_cast<const Value_initializer*>(e));
+
+    // uses
+    case Expression::loc_kind:
+      return evaluate(static_cast<const Located_expression*>(e)->get_expression());
     }
     e->dump();
     assert(false);
@@ -108,12 +281,23 @@ namespace beaker
   Value
   Evaluator::evaluate_int_literal(const Int_literal* e)
   {
-    return Value(e->get_value());
+    return check_integer(e->get_type(), e->get_value());
   }
 
+  /// When folding, only constants whose initializers are known can be
+  /// evaluated; no declaration is elaborated.
   Value
   Evaluator::evaluate_id_expression(const Id_expression* e)
   {
+    if (m_mode == constant_fold) {
+      const Typed_declaration* d = e->get_declaration();
+      if (d->is_value()) {
+        if (const Expression* init = cast<Value_declaration>(d)->get_initializer())
+          return evaluate(init);
+      }
+      throw std::runtime_error("non-constant expression");
+    }
+
     // FIXME: an id-expression that refers to a reference can fail to
     // be a constant expression.
     return fetch(e->get_declaration());
@@ -126,6 +310,179 @@ namespace beaker
     return fetch(e->get_declaration());
   }
 
+  Value
+  Evaluator::evaluate_folded_expression(const Folded_expression* e)
+  {
+    return e->get_value();
+  }
+
+  // Arithmetic expressions
+  //
+  // The operands of an arithmetic expression have the type of the
+  // expression, so the type determines whether integer or floating point
+  // arithmetic is performed.
+
+  Value
+  Evaluator::evaluate_addition_expression(const Addition_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    if (e->get_type()->is_floating_point())
+      return check_float(e->get_type(), lhs.get_float() + rhs.get_float());
+    Int_value n;
+    if (__builtin_add_overflow(lhs.get_int(), rhs.get_int(), &n))
+      overflow();
+    return check_integer(e->get_type(), n);
+  }
+
+  Value
+  Evaluator::evaluate_subtraction_expression(const Subtraction_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    if (e->get_type()->is_floating_point())
+      return check_float(e->get_type(), lhs.get_float() - rhs.get_float());
+    Int_value n;
+    if (__builtin_sub_overflow(lhs.get_int(), rhs.get_int(), &n))
+      overflow();
+    return check_integer(e->get_type(), n);
+  }
+
+  Value
+  Evaluator::evaluate_multiplication_expression(const Multiplication_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    if (e->get_type()->is_floating_point())
+      return check_float(e->get_type(), lhs.get_float() * rhs.get_float());
+    Int_value n;
+    if (__builtin_mul_overflow(lhs.get_int(), rhs.get_int(), &n))
+      overflow();
+    return check_integer(e->get_type(), n);
+  }
+
+  /// The quotient of integers is truncated toward zero.
+  Value
+  Evaluator::evaluate_quotient_expression(const Quotient_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    if (e->get_type()->is_floating_point())
+      return divide_float(e->get_type(), lhs.get_float(), rhs.get_float());
+    check_divisor(rhs.get_int());
+    if (rhs.get_int() == -1)
+      return negate_integer(e->get_type(), lhs.get_int());
+    return check_integer(e->get_type(), lhs.get_int() / rhs.get_int());
+  }
+
+  /// The remainder has the sign of the dividend.
+  Value
+  Evaluator::evaluate_remainder_expression(const Remainder_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    if (e->get_type()->is_floating_point()) {
+      if (rhs.get_float() == 0)
+        throw std::runtime_error("division by zero");
+      return check_float(e->get_type(), std::fmod(lhs.get_float(), rhs.get_float()));
+    }
+    check_divisor(rhs.get_int());
+    if (rhs.get_int() == -1)
+      return check_integer(e->get_type(), 0);
+    return check_integer(e->get_type(), lhs.get_int() % rhs.get_int());
+  }
+
+  /// Division of integers computes their quotient.
+  Value
+  Evaluator::evaluate_division_expression(const Division_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    if (e->get_type()->is_floating_point())
+      return divide_float(e->get_type(), lhs.get_float(), rhs.get_float());
+    check_divisor(rhs.get_int());
+    if (rhs.get_int() == -1)
+      return negate_integer(e->get_type(), lhs.get_int());
+    return check_integer(e->get_type(), lhs.get_int() / rhs.get_int());
+  }
+
+  Value
+  Evaluator::evaluate_negation_expression(const Negation_expression* e)
+  {
+    Value arg = evaluate(e->get_operand());
+    if (e->get_type()->is_floating_point())
+      return Value(-arg.get_float());
+    return negate_integer(e->get_type(), arg.get_int());
+  }
+
+  /// The reciprocal of an integer is the quotient of 1 and that integer.
+  Value
+  Evaluator::evaluate_reciprocal_expression(const Reciprocal_expression* e)
+  {
+    Value arg = evaluate(e->get_operand());
+    if (e->get_type()->is_floating_point())
+      return divide_float(e->get_type(), 1, arg.get_float());
+    check_divisor(arg.get_int());
+    return check_integer(e->get_type(), 1 / arg.get_int());
+  }
+
+  // Bitwise expressions
+  //
+  // The operands are in range, so the results of and, or, xor, and not
+  // are as well.
+
+  Value
+  Evaluator::evaluate_bitwise_and_expression(const Bitwise_and_expression* e)
+  {
+    Int_value lhs = evaluate(e->get_lhs()).get_int();
+    Int_value rhs = evaluate(e->get_rhs()).get_int();
+    return Value(lhs & rhs);
+  }
+
+  Value
+  Evaluator::evaluate_bitwise_or_expression(const Bitwise_or_expression* e)
+  {
+    Int_value lhs = evaluate(e->get_lhs()).get_int();
+    Int_value rhs = evaluate(e->get_rhs()).get_int();
+    return Value(lhs | rhs);
+  }
+
+  Value
+  Evaluator::evaluate_bitwise_xor_expression(const Bitwise_xor_expression* e)
+  {
+    Int_value lhs = evaluate(e->get_lhs()).get_int();
+    Int_value rhs = evaluate(e->get_rhs()).get_int();
+    return Value(lhs ^ rhs);
+  }
+
+  Value
+  Evaluator::evaluate_bitwise_not_expression(const Bitwise_not_expression* e)
+  {
+    Int_value arg = evaluate(e->get_operand()).get_int();
+    return Value(wrap_integer(e->get_type(), ~arg));
+  }
+
+  /// Bits shifted out of the value are discarded.
+  Value
+  Evaluator::evaluate_shift_left_expression(const Shift_left_expression* e)
+  {
+    Int_value lhs = evaluate(e->get_lhs()).get_int();
+    Int_value rhs = evaluate(e->get_rhs()).get_int();
+    check_shift(e->get_type(), rhs);
+    return Value(wrap_integer(e->get_type(), std::uintmax_t(lhs) << rhs));
+  }
+
+  /// The sign bit is replicated.
+  Value
+  Evaluator::evaluate_shift_right_expression(const Shift_right_expression* e)
+  {
+    Int_value lhs = evaluate(e->get_lhs()).get_int();
+    Int_value rhs = evaluate(e->get_rhs()).get_int();
+    check_shift(e->get_type(), rhs);
+    return Value(lhs >> rhs);
+  }
+
+  // Logical expressions
 
   Value
   Evaluator::evaluate_conditional_expression(const Conditional_expression* e)
@@ -164,22 +521,123 @@ namespace beaker
     return Value(!arg.get_int());
   }
 
+  // Relational expressions
+
+  Value
+  Evaluator::evaluate_equal_to_expression(const Equal_to_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    return Value(compare(lhs, rhs) == 0);
+  }
+
+  Value
+  Evaluator::evaluate_not_equal_to_expression(const Not_equal_to_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    return Value(compare(lhs, rhs) != 0);
+  }
+
+  Value
+  Evaluator::evaluate_less_than_expression(const Less_than_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    return Value(compare(lhs, rhs) < 0);
+  }
+
+  Value
+  Evaluator::evaluate_greater_than_expression(const Greater_than_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    return Value(compare(lhs, rhs) > 0);
+  }
+
+  Value
+  Evaluator::evaluate_not_greater_than_expression(const Not_greater_than_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    return Value(compare(lhs, rhs) <= 0);
+  }
+
+  Value
+  Evaluator::evaluate_not_less_than_expression(const Not_less_than_expression* e)
+  {
+    Value lhs = evaluate(e->get_lhs());
+    Value rhs = evaluate(e->get_rhs());
+    return Value(compare(lhs, rhs) >= 0);
+  }
+
+  // Conversions
+
   Value
   Evaluator::evaluate_implicit_conversion(const Implicit_conversion* e)
   {
     switch (e->get_conversion_kind()) {
     case Conversion::value_conv:
       return convert_to_value(e->get_source());
-    case Conversion::bool_conv:
+
+    case Conversion::bool_conv: {
+      Value arg = evaluate(e->get_source());
+      switch (arg.get_kind()) {
+      case Value::int_kind:
+        return Value(arg.get_int() != 0);
+      case Value::float_kind:
+        return Value(arg.get_float() != 0);
+      case Value::func_kind:
+        return Value(1);
+      default:
+        break;
+      }
+      break;
+    }
+
     case Conversion::int_prom:
     case Conversion::sign_ext:
-    case Conversion::zero_ext:
-    case Conversion::int_trunc:
-    case Conversion::float_prom:
-    case Conversion::float_dem:
+      // The value is unchanged.
+      return evaluate(e->get_source());
+
+    case Conversion::zero_ext: {
+      // The source value is reinterpreted as unsigned.
+      const Expression* src = e->get_source();
+      Int_value arg = evaluate(src).get_int();
+      int p = get_precision(src->get_type());
+      if (p > std::numeric_limits<Int_value>::digits)
+        return check_integer(e->get_type(), arg);
+      return check_integer(e->get_type(), arg & ((std::uintmax_t(1) << p) - 1));
+    }
+
+    case Conversion::int_trunc: {
+      Int_value arg = evaluate(e->get_source()).get_int();
+      return Value(wrap_integer(e->get_type(), arg));
+    }
+
+    case Conversion::float_prom: {
+      // The value is rounded to the precision of the floating point type.
+      Int_value arg = evaluate(e->get_source()).get_int();
+      return check_float(e->get_type(), Float_value(arg));
+    }
+
+    case Conversion::float_dem: {
+      // The value is truncated toward zero.
+      Float_value arg = std::trunc(evaluate(e->get_source()).get_float());
+      Float_value lim = std::ldexp(1.0, std::numeric_limits<Int_value>::digits);
+      if (arg < -lim || arg >= lim)
+        overflow();
+      return check_integer(e->get_type(), Int_value(arg));
+    }
+
     case Conversion::float_ext:
-    case Conversion::float_trunc:
-      break;
+      // The value is unchanged.
+      return evaluate(e->get_source());
+
+    case Conversion::float_trunc: {
+      Float_value arg = evaluate(e->get_source()).get_float();
+      return check_float(e->get_type(), arg);
+    }
     }
     assert(false);
   }
@@ -206,8 +664,9 @@ namespace beaker
       const Data_declaration* d = c.get_declaration();
       
       // Technically, global variables can have a constant initialization,
-      // but we don't know if there have been any intermediate writes.
-      if (d->is_variable() && d->has_static_storage())
+      // but we don't know if there have been any intermediate writes. There
+      // are none while static data is being initialized.
+      if (d->is_variable() && d->has_static_storage() && m_mode != static_init)
         throw std::runtime_error("read from non-constant object");
     }
 
@@ -218,6 +677,43 @@ namespace beaker
     return val;
   }
 
+  // Object expressions
+
+  /// Only objects created during evaluation can be modified. A declared
+  /// object can be observed by code that runs after the evaluation.
+  Value
+  Evaluator::evaluate_assignment_expression(const Assignment_expression* e)
+  {
+    Value ref = evaluate(e->get_lhs());
+    Value val = evaluate(e->get_rhs());
+    Object* obj = ref.get_reference();
+    if (obj->get_creator().is_declaration())
+      throw std::runtime_error("modification of non-constant object");
+    obj->store(val);
+    return ref;
+  }
+
+  // Initializers
+
+  /// Implicit default initialization trivially initializes the object, so
+  /// its value remains indeterminate.
+  Value
+  Evaluator::evaluate_empty_initializer(const Empty_initializer* e)
+  {
+    evaluate(e->get_object());
+    return Value();
+  }
+
+  /// Explicit default initialization zero-initializes the object.
+  Value
+  Evaluator::evaluate_default_initializer(const Default_initializer* e)
+  {
+    Value ref = evaluate(e->get_object());
+    Object* obj = ref.get_reference();
+    obj->initialize(get_zero_value(obj->get_type()));
+    return Value();
+  }
+
   /// FIXME: This returns an indeterminate value, which doesn't quite 
   /// correspond to void, but it's close.
   Value
@@ -31,6 +31,12 @@ namespace beaker
     case Expression::init_kind:
       return generate_id_expression(static_cast<const Id_expression*>(e));
 
+    case Expression::fold_kind:
+      return generate_folded_expression(static_cast<const Folded_expression*>(e));
+
+    case Expression::loc_kind:
+      return generate_expression(static_cast<const Located_expression*>(e)->get_expression());
+
     // arithmetic expressions
     case Expression::add_kind:
       return generate_addition_expression(static_cast<const Addition_expression*>(e));
@@ -120,6 +126,15 @@ namespace beaker
     return lookup(e->get_declaration());
   }
 
+  /// The value is emitted as a constant; the expression as written is not
+  /// generated.
+  llvm::Value*
+  Instruction_generator::generate_folded_expression(const Folded_expression* e)
+  {
+    llvm::Type* type = generate_type(e->get_type());
+    return llvm::ConstantInt::get(type, e->get_value().get_int());
+  }
+
   // Arithmetic expressions
 
   // FIXME: Handle unsigned and floating point expressions.
@@ -257,13 +272,15 @@ namespace beaker
     return ir.CreateICmpSLE(lhs, rhs);
   }
 
+  /// The value of an assignment is a reference to its left operand.
   llvm::Value*
   Instruction_generator::generate_assignment_expression(const Assignment_expression* e)
   {
     llvm::Value* lhs = generate_expression(e->get_lhs());
     llvm::Value* rhs = generate_expression(e->get_rhs());
     llvm::IRBuilder<> ir(get_current_block());
-    return ir.CreateStore(rhs, lhs);
+    ir.CreateStore(rhs, lhs);
+    return lhs;
   }
 
   llvm::Value*
@@ -292,7 +309,7 @@ namespace beaker
   {
     llvm::Value* ref = generate_expression(e->get_source());
     llvm::IRBuilder<> ir(get_current_block());
-    return ir.CreateLoad(ref);
+    return ir.CreateLoad(ref->getType()->getPointerElementType(), ref);
   }
 
   llvm::Value*
@@ -440,7 +440,7 @@ namespace beaker
       break;
     }
     
-    throw std::runtime_error("expected primary-expression");
+    syntax_error("expected primary-expression");
   }
 
   /// id-expression:
@@ -6,7 +6,9 @@
 #include "relational_expression.hpp"
 #include "type.hpp"
 #include "declaration.hpp"
+#include "conversion.hpp"
 #include "context.hpp"
+#include "evaluation.hpp"
 #include "print.hpp"
 
 #include <iostream>
@@ -14,6 +16,81 @@
 
 namespace beaker
 {
+  /// Returns true if the value of `e` is known during analysis. This is the
+  /// case for literals, folded expressions, and the names of constants
+  /// whose initializers are known.
+  ///
+  /// Only local constants are considered. Global initializers may be
+  /// analyzed concurrently with the expressions that use them, which
+  /// would make folding depend on the order of analysis. Those are
+  /// evaluated during code generation instead.
+  static bool
+  has_known_value(const Expression* e)
+  {
+    e = get_used_expression(e);
+    switch (e->get_kind()) {
+    case Expression::bool_kind:
+    case Expression::int_kind:
+    case Expression::fold_kind:
+      return true;
+
+    case Expression::id_kind: {
+      const Typed_declaration* d = static_cast<const Id_expression*>(e)->get_declaration();
+      if (!d->is_value())
+        return false;
+      const Value_declaration* val = cast<Value_declaration>(d);
+      if (!val->has_automatic_storage())
+        return false;
+      const Expression* init = val->get_initializer();
+      return init && has_known_value(init);
+    }
+
+    default:
+      return false;
+    }
+  }
+
+  /// Returns true if the operands of `e` have known values.
+  static bool
+  has_known_operands(const Expression* e)
+  {
+    e = get_used_expression(e);
+    if (const Unary_expression* u = dyn_cast<Unary_expression>(e))
+      return has_known_value(u->get_operand());
+    if (const Binary_expression* b = dyn_cast<Binary_expression>(e))
+      return has_known_value(b->get_lhs()) && has_known_value(b->get_rhs());
+    if (const Ternary_expression* t = dyn_cast<Ternary_expression>(e))
+      return has_known_value(t->get_first()) 
+          && has_known_value(t->get_second()) 
+          && has_known_value(t->get_third());
+    return false;
+  }
+
+  /// Only bool and integer values are folded. The folded expression links
+  /// to `e`, which is canonical whenever its operands are, so each folded
+  /// value is created once.
+  ///
+  /// An expression whose evaluation fails (e.g., by dividing by zero) is
+  /// not folded. The error is diagnosed where the expression is evaluated,
+  /// if ever.
+  Expression*
+  Semantics::fold(Expression* e)
+  {
+    Type* t = e->get_type();
+    if (!t->is_bool() && !t->is_integer())
+      return e;
+    if (!has_known_operands(e))
+      return e;
+    try {
+      Constant_folder eval(m_cxt);
+      Value v = eval.evaluate(e);
+      return m_cxt.make_canonical<Folded_expression>(t, e, v);
+    }
+    catch (std::runtime_error&) {
+      return e;
+    }
+  }
+
   /// The first operand shall have type `ref t`, and the second shall be
   /// converted to `t`.
   Expression*
@@ -23,7 +100,7 @@ namespace beaker
   {
     e1 = require_reference(e1);
     e2 = convert_to_value(e2, e1->get_type());
-    return new Assignment_expression(e1->get_type(), e1, e2, op);
+    return m_cxt.make<Assignment_expression>(e1->get_type(), e1, e2, op);
   }
 
   /// The first operand shall be converted to bool. The second and third
@@ -38,7 +115,7 @@ namespace beaker
   {
     e1 = convert_to_bool(e1);
     std::tie(e2, e3) = convert_to_common_type(e2, e3);
-    return new Conditional_expression(e2->get_type(), e1, e2, e3, question, colon);
+    return fold(m_cxt.make_canonical<Conditional_expression>(e2->get_type(), e1, e2, e3, question, colon));
   }
 
   /// The operands are converted to bool values.
@@ -52,9 +129,9 @@ namespace beaker
     e2 = convert_to_bool(e2);
     switch (op.get_name()) {
     case Token::ampersand_ampersand:
-      return new Logical_and_expression(m_cxt.get_bool_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Logical_and_expression>(m_cxt.get_bool_type(), e1, e2, op));
     case Token::bar_bar:    
-      return new Logical_or_expression(m_cxt.get_bool_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Logical_or_expression>(m_cxt.get_bool_type(), e1, e2, op));
     default:
       break;
     }
@@ -68,7 +145,7 @@ namespace beaker
                                    const Token& op)
   {
     e = convert_to_bool(e);
-    return new Logical_not_expression(m_cxt.get_bool_type(), e, op);
+    return fold(m_cxt.make_canonical<Logical_not_expression>(m_cxt.get_bool_type(), e, op));
   }
 
   /// The operands shall be converted to a common integer type. The type of
@@ -81,11 +158,11 @@ namespace beaker
     std::tie(e1, e2) = require_common_integer(e1, e2);
     switch (op.get_name()) {
     case Token::ampersand:
-      return new Bitwise_and_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Bitwise_and_expression>(e1->get_type(), e1, e2, op));
     case Token::bar:
-      return new Bitwise_or_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Bitwise_or_expression>(e1->get_type(), e1, e2, op));
     case Token::caret:
-      return new Bitwise_xor_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Bitwise_xor_expression>(e1->get_type(), e1, e2, op));
     default:
       break;
     }
@@ -99,7 +176,7 @@ namespace beaker
                                    const Token& op)
   {
     e = require_integer(e);
-    return new Bitwise_not_expression(e->get_type(), e, op);
+    return fold(m_cxt.make_canonical<Bitwise_not_expression>(e->get_type(), e, op));
   }
 
   /// The operands shall be converted to their common value type. The type
@@ -113,9 +190,9 @@ namespace beaker
     Type* t = m_cxt.get_bool_type();
     switch (op.get_name()) {
     case Token::equal_equal:
-      return new Equal_to_expression(t, e1, e2, op);
+      return fold(m_cxt.make_canonical<Equal_to_expression>(t, e1, e2, op));
     case Token::bang_equal:
-      return new Not_equal_to_expression(t, e1, e2, op);
+      return fold(m_cxt.make_canonical<Not_equal_to_expression>(t, e1, e2, op));
     default:
       break;
     }
@@ -133,13 +210,13 @@ namespace beaker
     Type* t = m_cxt.get_bool_type();
     switch (op.get_name()) {
     case Token::less:
-      return new Less_than_expression(t, e1, e2, op);
+      return fold(m_cxt.make_canonical<Less_than_expression>(t, e1, e2, op));
     case Token::greater:
-      return new Greater_than_expression(t, e1, e2, op);
+      return fold(m_cxt.make_canonical<Greater_than_expression>(t, e1, e2, op));
     case Token::less_equal:
-      return new Not_greater_than_expression(t, e1, e2, op);
+      return fold(m_cxt.make_canonical<Not_greater_than_expression>(t, e1, e2, op));
     case Token::greater_equal:
-      return new Not_less_than_expression(t, e1, e2, op);
+      return fold(m_cxt.make_canonical<Not_less_than_expression>(t, e1, e2, op));
     default:
       break;
     }
@@ -157,9 +234,9 @@ namespace beaker
     e2 = require_integer(e2);
     switch (op.get_name()) {
     case Token::less_less:
-      return new Shift_left_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Shift_left_expression>(e1->get_type(), e1, e2, op));
     case Token::greater_greater:
-      return new Shift_right_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Shift_right_expression>(e1->get_type(), e1, e2, op));
     default:
       break;
     }
@@ -176,9 +253,9 @@ namespace beaker
     std::tie(e1, e2) = convert_to_common_value(e1, e2);
     switch (op.get_name()) {
     case Token::plus:
-      return new Addition_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Addition_expression>(e1->get_type(), e1, e2, op));
     case Token::minus:
-      return new Subtraction_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Subtraction_expression>(e1->get_type(), e1, e2, op));
     default:
       break;
     }
@@ -191,7 +268,7 @@ namespace beaker
                                     const Token& op)
   {
     e = require_integer(e);
-    return new Negation_expression(e->get_type(), e, op);
+    return fold(m_cxt.make_canonical<Negation_expression>(e->get_type(), e, op));
   }
 
   /// \todo The operands shall be converted to a common value type. The result
@@ -204,11 +281,11 @@ namespace beaker
     std::tie(e1, e2) = convert_to_common_value(e1, e2);
     switch (op.get_name()) {
     case Token::star:
-      return new Multiplication_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Multiplication_expression>(e1->get_type(), e1, e2, op));
     case Token::slash:
-      return new Quotient_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Quotient_expression>(e1->get_type(), e1, e2, op));
     case Token::percent:
-      return new Remainder_expression(e1->get_type(), e1, e2, op);
+      return fold(m_cxt.make_canonical<Remainder_expression>(e1->get_type(), e1, e2, op));
     default:
       break;
     }
@@ -221,7 +298,7 @@ namespace beaker
                                           const Token& op)
   {
     e = require_integer(e);
-    return new Reciprocal_expression(e->get_type(), e, op);
+    return fold(m_cxt.make_canonical<Reciprocal_expression>(e->get_type(), e, op));
   }
 
   Expression*
@@ -280,9 +357,11 @@ namespace beaker
   {
     Type* type = m_cxt.get_bool_type();
     bool val = tok.is(Token::true_kw);
-    return new Bool_literal(type, tok, val);
+    return m_cxt.make_canonical<Bool_literal>(type, tok, val);
   }
   
+  /// The value of the literal shall be representable in its type. Values
+  /// too large for an intmax_t saturate and are rejected likewise.
   Expression*
   Semantics::on_integer_literal(const Token& tok)
   {
@@ -291,8 +370,14 @@ namespace beaker
     std::intmax_t val = std::strtoll(tok.get_spelling(), &end, 10);
     assert(*end == 0);
 
-    Type* type = m_cxt.get_int_type();
-    return new Int_literal(type, tok, val);
+    Int_type* type = m_cxt.get_int_type();
+    std::intmax_t max = (std::intmax_t(1) << (type->get_rank() - 1)) - 1;
+    if (val > max) {
+      std::stringstream ss;
+      ss << "integer-literal '" << tok.get_spelling() << "' is too large for " << *type;
+      error(tok.get_location(), ss.str());
+    }
+    return m_cxt.make_canonical<Int_literal>(type, tok, val);
   }
   
   Expression*
@@ -321,27 +406,27 @@ namespace beaker
   Semantics::on_id_expression(const Token& id)
   {
     // Search for declarations with the given name.
-    Declaration_set found = unqualified_lookup(id.get_symbol());
-    if (found.is_empty()) {
+    Named_declaration* found = unqualified_lookup(id.get_symbol());
+    if (!found) {
       std::stringstream ss;
       ss << "no matching declaration for " << '\'' << id << '\'';
-      throw std::runtime_error(ss.str());
+      error(id.get_location(), ss.str());
     }
-    return make_id_expression(found.get_single_declaration());
+    return make_id_expression(found, id);
   }
 
   Expression*
-  Semantics::make_id_expression(Named_declaration* d)
+  Semantics::make_id_expression(Named_declaration* d, const Token& id)
   {
     // Unwrap references to parameters.
-    if (Parameter* parm = dynamic_cast<Parameter*>(d))
+    if (Parameter* parm = dyn_cast<Parameter>(d))
       d = parm->get_declaration();
 
     // Id-expressions must be typed.
     if (!d->is_typed()) {
       std::stringstream ss;
       ss << "declaration " << '\'' << d->get_name() << '\'' << " does not have a value";
-      throw std::runtime_error(ss.str());
+      error(id.get_location(), ss.str());
     }
     
     return make_id_expression(static_cast<Typed_declaration*>(d));
@@ -357,14 +442,14 @@ namespace beaker
     if (d->is_variable())
       t = m_cxt.get_reference_type(t);
 
-    return new Id_expression(t, d);
+    return m_cxt.make_canonical<Id_expression>(t, d);
   }
 
   Expression*
   Semantics::make_init_expression(Variable_declaration* d)
   {
     Type* type = m_cxt.get_reference_type(d->get_type());
-    return new Init_expression(type, d);
+    return m_cxt.make<Init_expression>(type, d);
   }
 
   Expression*
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <forward_list>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace beaker
 {
@@ -14,24 +16,138 @@ namespace beaker
     template<typename... Args>
     T* make(Args&&... args)
     {
-      this->emplace_back(std::forward<Args>(args)...);
-      return &this->back();
+      this->emplace_front(std::forward<Args>(args)...);
+      return &this->front();
     }
   };
 
 
-  /// Creates objects of a particular, ensuring that each object with unique
-  /// properties is created exactly once. In other words, this "interns" or
-  /// "canonicalizes" the objects.
-  template<typename T, typename Hash, typename Eq>
-  struct Unique_factory : std::unordered_set<T, Hash, Eq>
+  /// Statistics about the use of an interning table.
+  struct Intern_statistics
   {
-    template<typename... Args>
-    T* make(Args&&... args)
+    /// The number of objects in the table.
+    std::size_t size;
+
+    /// The number of slots in the table.
+    std::size_t capacity;
+
+    /// The number of lookups.
+    std::size_t lookups;
+
+    /// The number of lookups that found an existing object.
+    std::size_t hits;
+
+    /// The number of occupied slots examined during lookups.
+    std::size_t probes;
+
+    /// Accumulates the statistics of another table.
+    Intern_statistics& operator+=(const Intern_statistics& s)
+    {
+      size += s.size;
+      capacity += s.capacity;
+      lookups += s.lookups;
+      hits += s.hits;
+      probes += s.probes;
+      return *this;
+    }
+  };
+
+
+  /// Ensures that each object with unique properties is created exactly
+  /// once. In other words, this "interns" or "canonicalizes" the objects.
+  ///
+  /// The table does not own its objects. It is a flat, open-addressing
+  /// hash table of pointers, probed linearly, and kept at most half full.
+  /// Each slot stores the hash code of its object, so that a probe only
+  /// touches an object whose hash code matches. Lookups are given a hash
+  /// code and a predicate rather than an object, so that a key can be
+  /// compared against the table without first creating an object.
+  template<typename T>
+  class Intern_table
+  {
+    struct Slot
+    {
+      std::size_t hash;
+      T* obj;
+    };
+
+  public:
+    Intern_table()
+      : m_slots(16), m_stats()
+    {
+      m_stats.capacity = m_slots.size();
+    }
+
+    /// Returns the object whose hash code is `h` and that satisfies `eq`,
+    /// or null if there is no such object.
+    template<typename Eq>
+    T* find(std::size_t h, Eq eq) const
+    {
+      ++m_stats.lookups;
+      std::size_t mask = m_slots.size() - 1;
+      for (std::size_t i = h & mask; T* obj = m_slots[i].obj; i = (i + 1) & mask) {
+        ++m_stats.probes;
+        if (m_slots[i].hash == h && eq(obj)) {
+          ++m_stats.hits;
+          return obj;
+        }
+      }
+      return nullptr;
+    }
+
+    /// Returns the object whose hash code is `h` and that satisfies `eq`.
+    /// If there is no such object, the object returned by `make` is added
+    /// to the table and returned.
+    template<typename Eq, typename Make>
+    T* get(std::size_t h, Eq eq, Make make)
     {
-      const T& elem = *this->emplace(std::forward<Args>(args)...).first;
-      return const_cast<T*>(&elem);
+      ++m_stats.lookups;
+      std::size_t mask = m_slots.size() - 1;
+      std::size_t i = h & mask;
+      for (; T* obj = m_slots[i].obj; i = (i + 1) & mask) {
+        ++m_stats.probes;
+        if (m_slots[i].hash == h && eq(obj)) {
+          ++m_stats.hits;
+          return obj;
+        }
+      }
+      T* obj = make();
+      m_slots[i] = {h, obj};
+      if (++m_stats.size * 2 > m_slots.size())
+        grow();
+      return obj;
     }
+
+    /// Returns the number of objects in the table.
+    std::size_t size() const { return m_stats.size; }
+
+    /// Returns statistics about the use of the table.
+    const Intern_statistics& get_statistics() const { return m_stats; }
+
+  private:
+    /// Doubles the size of the table.
+    void grow()
+    {
+      std::vector<Slot> old(m_slots.size() * 2);
+      old.swap(m_slots);
+      std::size_t mask = m_slots.size() - 1;
+      for (const Slot& s : old) {
+        if (!s.obj)
+          continue;
+        std::size_t i = s.hash & mask;
+        while (m_slots[i].obj)
+          i = (i + 1) & mask;
+        m_slots[i] = s;
+      }
+      m_stats.capacity = m_slots.size();
+    }
+
+    /// The slots. The number of slots is a power of 2.
+    std::vector<Slot> m_slots;
+
+    /// Usage statistics. Lookups are counted even though they do not
+    /// modify the table.
+    mutable Intern_statistics m_stats;
   };
 
 } // namespace beaker
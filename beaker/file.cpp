@@ -1,18 +1,148 @@
 #include "file.hpp"
 
-#include <iterator>
-#include <fstream>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace beaker
 {
 
+/// Throws an exception describing the failure of `what` on `path`.
+[[noreturn]] static void
+throw_error(const char* what, const std::string& path, int err)
+{
+  std::stringstream ss;
+  ss << "cannot " << what << " file '" << path << "': " << std::strerror(err);
+  throw std::runtime_error(ss.str());
+}
+
 File::File(const std::string& path)
-  : m_path(path)
+  : File(path, 0)
+{ }
+
+File::File(const std::string& path, unsigned base)
+  : m_path(path), m_map(), m_map_size(), m_base(base)
+{
+  map_or_read();
+}
+
+File::~File()
+{
+  if (m_map)
+    ::munmap(m_map, m_map_size);
+}
+
+/// Throws an exception unless the offsets of a file of `n` bytes, including
+/// the one past the end, are representable.
+void
+File::check_size(std::size_t n) const
 {
-  std::ifstream ifs(m_path);
-  std::istreambuf_iterator<char> first{ifs};
-  std::istreambuf_iterator<char> last{};
-  m_text = std::string(first, last);
+  std::size_t limit = std::numeric_limits<unsigned>::max() - m_base;
+  if (n >= limit) {
+    std::stringstream ss;
+    ss << "file '" << m_path << "' is too large";
+    throw std::runtime_error(ss.str());
+  }
+}
+
+/// Maps a regular file into memory. Mapping is only possible when the file
+/// is not empty and does not end on a page boundary; the remainder of the
+/// last page is zero-filled, which provides the null terminator for free.
+/// Other files are read into a buffer.
+void
+File::map_or_read()
+{
+  int fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    throw_error("open", m_path, errno);
+
+  struct stat st;
+  if (::fstat(fd, &st) < 0) {
+    int err = errno;
+    ::close(fd);
+    throw_error("stat", m_path, err);
+  }
+  if (S_ISDIR(st.st_mode)) {
+    ::close(fd);
+    throw_error("read", m_path, EISDIR);
+  }
+
+  // Check the size of a regular file before it is mapped, since the
+  // mapping is not released if the constructor throws.
+  std::size_t size = st.st_size;
+  if (S_ISREG(st.st_mode)) {
+    try {
+      check_size(size);
+    }
+    catch (...) {
+      ::close(fd);
+      throw;
+    }
+  }
+
+  std::size_t page = ::sysconf(_SC_PAGESIZE);
+  if (S_ISREG(st.st_mode) && size != 0 && size % page != 0) {
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      ::madvise(p, size, MADV_SEQUENTIAL);
+      ::close(fd);
+      m_map = p;
+      m_map_size = size;
+      const char* first = static_cast<const char*>(p);
+      m_text = Text_view(first, first + size);
+      return;
+    }
+  }
+
+  // Fall back to reading the file.
+  try {
+    read(fd);
+  }
+  catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+/// Reads the contents of `fd` into the buffer. When the size of the input
+/// is known, it is read in a single pass. Otherwise, the buffer grows
+/// geometrically until the end of input.
+void
+File::read(int fd)
+{
+  struct stat st;
+  std::size_t hint = 0;
+  if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    hint = st.st_size;
+
+  std::size_t n = 0;
+  m_buf.resize(hint ? hint + 1 : 4096);
+  for (;;) {
+    if (n == m_buf.size())
+      m_buf.resize(2 * m_buf.size());
+    ssize_t k = ::read(fd, &m_buf[n], m_buf.size() - n);
+    if (k < 0) {
+      if (errno == EINTR)
+        continue;
+      throw_error("read", m_path, errno);
+    }
+    if (k == 0)
+      break;
+    n += k;
+  }
+  m_buf.resize(n);
+  check_size(n);
+
+  // The string guarantees the null terminator.
+  m_text = Text_view(m_buf.data(), m_buf.data() + n);
 }
 
 } // namespace beaker
@@ -1,12 +1,58 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace beaker
 {
 
+/// A non-owning view of a contiguous sequence of characters.
+class Text_view
+{
+public:
+  Text_view()
+    : m_first(), m_last()
+  { }
+
+  Text_view(const char* first, const char* last)
+    : m_first(first), m_last(last)
+  { }
+
+  /// Returns a pointer to the first character.
+  const char* data() const { return m_first; }
+
+  /// Returns the number of characters in the view.
+  std::size_t size() const { return m_last - m_first; }
+
+  /// Returns true if the view is empty.
+  bool empty() const { return m_first == m_last; }
+
+  /// Returns a pointer to the first character.
+  const char* begin() const { return m_first; }
+
+  /// Returns a pointer past the last character.
+  const char* end() const { return m_last; }
+
+  /// Returns a copy of the viewed characters.
+  std::string str() const { return std::string(m_first, m_last); }
+
+private:
+  const char* m_first;
+  const char* m_last;
+};
+
+
 /// Represents a source file.
 ///
+/// The contents of regular files are mapped into memory. Other inputs
+/// (e.g., pipes) are read into a buffer. In either case, the text is
+/// followed by a null character that is not part of the text, which
+/// allows scanners to detect the end of input without a bounds check.
+///
+/// Each file occupies a range of offsets starting at its base offset.
+/// Distinct files can share a single offset space by giving them disjoint
+/// ranges; see get_limit_offset().
+///
 /// \todo Factor the text buffer into a separate facility so that we can
 /// support input from the command line or from generated code.
 ///
@@ -18,27 +64,55 @@ namespace beaker
 class File
 {
 public:
-  /// Construct a source file from the file indicated by `path`. This reads
-  /// the contents of the file.
+  /// Construct a source file from the file indicated by `path`. This maps
+  /// or reads the contents of the file. The base offset is 0.
   File(const std::string& path);
   
+  /// Construct a source file from the file indicated by `path` whose text
+  /// begins at the offset `base`.
   File(const std::string& path, unsigned base);
 
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  ~File();
+
   /// Returns the path to the file.
   const std::string& get_path() const { return m_path; }
   
   /// Returns the text of the file.
-  const std::string& get_text() const { return m_text; }
+  Text_view get_text() const { return m_text; }
 
   /// Returns the base offset of the file.
   unsigned get_base_offset() const { return m_base; }
 
+  /// Returns the offset past the end of the file's text. Offsets up to and
+  /// including this one belong to the file; the next file in an offset
+  /// space can start just after it.
+  unsigned get_limit_offset() const { return m_base + m_text.size(); }
+
+  /// Returns true if the text is mapped into memory.
+  bool is_mapped() const { return m_map != nullptr; }
+
 private:
+  void map_or_read();
+  void read(int fd);
+  void check_size(std::size_t n) const;
+
   /// The path to the file.
   std::string m_path;
 
   /// The text of the file.
-  std::string m_text;
+  Text_view m_text;
+
+  /// The memory mapping of the file, if any.
+  void* m_map;
+
+  /// The size of the memory mapping.
+  std::size_t m_map_size;
+
+  /// Holds the text when the file is not mapped.
+  std::string m_buf;
 
   /// The base, starting offset of the file's text buffer.
   unsigned m_base;
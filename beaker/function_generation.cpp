@@ -128,7 +128,7 @@ namespace beaker
   void
   Function_context::generate_parameters(const Function_declaration* d)
   {
-    const Parameter_seq& parms = d->get_parameters();
+    Parameter_list parms = d->get_parameters();
     auto args = m_llvm->args();
     
     auto pi = parms.begin();
@@ -140,7 +140,7 @@ namespace beaker
       // Set the name and other attributes.
       //
       // FIXME: Actually set attributes based on the parameter.
-      arg->setName(*parm->get_name());
+      arg->setName(parm->get_name()->c_str());
 
       // Declare the parameter. Note that we can't have non-typed parameters.
       Named_declaration* nd = parm->get_declaration();
@@ -3,6 +3,19 @@
 #include "module_generation.hpp"
 #include "declaration.hpp"
 
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PassTimingInfo.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <sstream>
+#include <stdexcept>
+
 namespace beaker
 {
   /// A clever trick to use private classes in a private implementation.
@@ -10,6 +23,15 @@ namespace beaker
   {
   public:
     using Global_context::Global_context;
+
+    /// Transfers ownership of the LLVM context to the caller.
+    std::unique_ptr<llvm::LLVMContext> release_llvm_context()
+    {
+      return std::move(m_llvm);
+    }
+
+    /// The generated module.
+    std::unique_ptr<llvm::Module> m_mod;
   };
 
   Generator::Generator(Context& cxt)
@@ -20,13 +42,172 @@ namespace beaker
   { }
 
   void
-  Generator::generate_module(const Declaration* d)
+  Generator::generate_module(const Declaration* d, const std::string& name)
   {
     assert(d->is_translation_unit());
+    assert(!m_cxt->m_mod);
     
     auto* tu = static_cast<const Translation_unit*>(d);
     Module_context mod(*m_cxt);
-    mod.generate_module(tu);
+    mod.generate_module(tu, name);
+    m_cxt->m_mod.reset(mod.get_llvm_module());
+
+    // The optimizer assumes a well-formed module, so check it before any
+    // pass can run.
+    verify_module();
+  }
+
+  llvm::Module*
+  Generator::get_module() const
+  {
+    return m_cxt->m_mod.get();
+  }
+
+  void
+  Generator::verify_module() const
+  {
+    assert(m_cxt->m_mod);
+
+    std::string msg;
+    llvm::raw_string_ostream os(msg);
+    if (llvm::verifyModule(*m_cxt->m_mod, &os)) {
+      os.flush();
+      while (!msg.empty() && msg.back() == '\n')
+        msg.pop_back();
+      std::stringstream ss;
+      ss << "generated an invalid module\n" << msg;
+      throw std::runtime_error(ss.str());
+    }
+  }
+
+  std::unique_ptr<llvm::Module>
+  Generator::release_module()
+  {
+    assert(m_cxt->m_mod);
+    return std::move(m_cxt->m_mod);
+  }
+
+  std::unique_ptr<llvm::LLVMContext>
+  Generator::release_llvm_context()
+  {
+    assert(!m_cxt->m_mod); // The module must be released first.
+    return m_cxt->release_llvm_context();
+  }
+
+  /// Returns the pass builder's optimization level for `n`.
+  static llvm::OptimizationLevel
+  get_pass_level(Generator::Optimization_level n)
+  {
+    switch (n) {
+    case Generator::O0:
+      return llvm::OptimizationLevel::O0;
+    case Generator::O1:
+      return llvm::OptimizationLevel::O1;
+    case Generator::O2:
+      return llvm::OptimizationLevel::O2;
+    case Generator::O3:
+      return llvm::OptimizationLevel::O3;
+    }
+    __builtin_unreachable();
+  }
+
+  /// Returns the code generator's optimization level for `n`.
+  static llvm::CodeGenOpt::Level
+  get_codegen_level(Generator::Optimization_level n)
+  {
+    switch (n) {
+    case Generator::O0:
+      return llvm::CodeGenOpt::None;
+    case Generator::O1:
+      return llvm::CodeGenOpt::Less;
+    case Generator::O2:
+      return llvm::CodeGenOpt::Default;
+    case Generator::O3:
+      return llvm::CodeGenOpt::Aggressive;
+    }
+    __builtin_unreachable();
+  }
+
+  void
+  Generator::optimize_module(Optimization_level n, llvm::raw_ostream* timing)
+  {
+    assert(m_cxt->m_mod);
+
+    llvm::Module* mod = m_cxt->m_mod.get();
+    llvm::TargetMachine* tm = m_cxt->get_target_machine();
+    tm->setOptLevel(get_codegen_level(n));
+
+    // Register per-pass timers when requested.
+    llvm::PassInstrumentationCallbacks pic;
+    llvm::TimePassesHandler timer(timing != nullptr);
+    if (timing) {
+      timer.setOutStream(*timing);
+      timer.registerCallbacks(pic);
+    }
+
+    // Build the analysis managers and cross-register their proxies.
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+    llvm::PassBuilder pb(tm, llvm::PipelineTuningOptions(), llvm::None, &pic);
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    llvm::OptimizationLevel level = get_pass_level(n);
+    llvm::ModulePassManager mpm;
+    if (level == llvm::OptimizationLevel::O0)
+      mpm = pb.buildO0DefaultPipeline(level);
+    else
+      mpm = pb.buildPerModuleDefaultPipeline(level);
+    mpm.run(*mod, mam);
+
+    if (timing)
+      timer.print();
+  }
+
+  /// Runs the target's code generator to produce assembly or an object file.
+  static void
+  emit_native(llvm::TargetMachine* tm,
+              llvm::Module* mod,
+              llvm::raw_pwrite_stream& os, 
+              llvm::CodeGenFileType type)
+  {
+    llvm::legacy::PassManager pm;
+    if (tm->addPassesToEmitFile(pm, os, nullptr, type)) {
+      std::stringstream ss;
+      ss << "target '" << tm->getTargetTriple().str() << "' "
+         << "cannot emit a file of this type";
+      throw std::runtime_error(ss.str());
+    }
+    pm.run(*mod);
+  }
+
+  void
+  Generator::emit_module(llvm::raw_pwrite_stream& os, Output_kind k)
+  {
+    // Never write out a malformed module, in any format.
+    verify_module();
+
+    llvm::Module* mod = m_cxt->m_mod.get();
+    llvm::TargetMachine* tm = m_cxt->get_target_machine();
+    switch (k) {
+    case ir_output:
+      return mod->print(os, nullptr);
+    
+    case bitcode_output:
+      return llvm::WriteBitcodeToFile(*mod, os);
+    
+    case assembly_output:
+      return emit_native(tm, mod, os, llvm::CGFT_AssemblyFile);
+    
+    case object_output:
+      return emit_native(tm, mod, os, llvm::CGFT_ObjectFile);
+    }
+    __builtin_unreachable();
   }
 
 } // namespace beaker
@@ -2,19 +2,76 @@
 
 #include <beaker/common.hpp>
 
+namespace llvm
+{
+  class LLVMContext;
+  class Module;
+  class raw_ostream;
+  class raw_pwrite_stream;
+} // namespace llvm
+
 namespace beaker
 {
   /// Maintains essential state for a code generation.
   ///
+  /// Each generator owns its own LLVM context. Separate generators can be
+  /// used concurrently, provided that they do not share a Beaker context.
+  ///
   /// \todo Support multiple code generation facilities (e.g., for GCC?).
   class Generator
   {
   public:
+    /// The kinds of output that can be emitted for a module.
+    enum Output_kind
+    {
+      ir_output,       // Textual LLVM IR
+      bitcode_output,  // LLVM bitcode
+      assembly_output, // Target assembly
+      object_output,   // Target object file
+    };
+
+    /// The optimization levels of the standard pass pipelines.
+    enum Optimization_level
+    {
+      O0, // No optimization
+      O1, // Quick optimization
+      O2, // Default optimization
+      O3, // Aggressive optimization
+    };
+
     Generator(Context& cxt);
     ~Generator();
 
-    /// Generate the IR code for this translation unit.
-    void generate_module(const Declaration* tu);
+    /// Generate the IR code for this translation unit. The module is
+    /// named `name`; this is typically the path of the input file. Throws
+    /// an exception if the generated module is not well-formed.
+    void generate_module(const Declaration* tu, const std::string& name);
+
+    /// Returns the generated module, or nullptr if no module has been
+    /// generated.
+    llvm::Module* get_module() const;
+
+    /// Checks that the generated module is well-formed. Throws an
+    /// exception describing the problems found otherwise.
+    void verify_module() const;
+
+    /// Runs the standard optimization pipeline for level `n` over the
+    /// generated module. This also sets the optimization level used to
+    /// emit assembly and object files. If `timing` is non-null, a report
+    /// of the time spent in each pass is written to it.
+    void optimize_module(Optimization_level n, llvm::raw_ostream* timing = nullptr);
+
+    /// Writes the generated module to `os` in the format given by `k`. The
+    /// module is verified first.
+    void emit_module(llvm::raw_pwrite_stream& os, Output_kind k);
+
+    /// Transfers ownership of the generated module to the caller.
+    std::unique_ptr<llvm::Module> release_module();
+
+    /// Transfers ownership of the LLVM context to the caller. This allows
+    /// the module to outlive the generator (e.g., when handed to a JIT).
+    /// The generator cannot be used after its context has been released.
+    std::unique_ptr<llvm::LLVMContext> release_llvm_context();
 
   private:
     class Generation_context;
@@ -10,6 +10,14 @@
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+
+#include <mutex>
+#include <stdexcept>
 
 namespace beaker
 {
@@ -189,8 +197,34 @@ namespace beaker
     : m_llvm(new llvm::LLVMContext())
   { }
 
+  /// Returns a new target machine for the host. The native target is
+  /// registered the first time this is called.
+  static llvm::TargetMachine*
+  make_host_target_machine()
+  {
+    static std::once_flag init;
+    std::call_once(init, []() {
+      llvm::InitializeNativeTarget();
+      llvm::InitializeNativeTargetAsmPrinter();
+      llvm::InitializeNativeTargetAsmParser();
+    });
+
+    std::string triple = llvm::sys::getDefaultTargetTriple();
+    std::string msg;
+    const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple, msg);
+    if (!target)
+      throw std::runtime_error(msg);
+
+    // Generate position independent code for the generic CPU so that
+    // objects can be linked into any executable for the host.
+    llvm::TargetOptions opts;
+    return target->createTargetMachine(triple, "generic", "", opts,
+                                       llvm::Reloc::PIC_);
+  }
+
   Global_context::Global_context(Context& cxt)
-    : m_cxt(cxt), Global_context_base(), cg::Factory(m_llvm.get())
+    : m_cxt(cxt), Global_context_base(), cg::Factory(m_llvm.get()),
+      m_target(make_host_target_machine())
   { }
 
   Global_context::~Global_context()
@@ -201,7 +235,7 @@ namespace beaker
   std::string
   Global_context::generate_external_name(const Named_declaration* d)
   {
-    return *d->get_name();
+    return d->get_name()->str();
   }
 
   llvm::Type*
@@ -303,8 +337,13 @@ namespace beaker
   llvm::Constant*
   Global_context::generate_constant(const Object* o)
   {
+    // Static storage that is never given a value holds zero.
+    const Value& v = o->load();
+    if (v.is_indeterminate())
+      return get_llvm_zero(generate_type(o->get_type()));
+
     // FIXME: Generate aggregate constants for aggregate objects.
-    return generate_constant(o->get_type(), o->load());
+    return generate_constant(o->get_type(), v);
   }
 
 } // namespace beaker
@@ -2,6 +2,7 @@
 
 #include <beaker/common.hpp>
 
+#include <cstdint>
 #include <unordered_map>
 
 namespace llvm
@@ -23,6 +24,8 @@ namespace llvm
   class Constant;
   class GlobalVariable;
   class Function;
+
+  class TargetMachine;
 } // namespace llvm
 
 namespace beaker
@@ -184,6 +187,9 @@ namespace beaker
     /// Returns the LLVM context.
     llvm::LLVMContext* get_llvm_context() const { return m_llvm.get(); }
 
+    /// Returns the machine for which code is generated.
+    llvm::TargetMachine* get_target_machine() const { return m_target.get(); }
+
     // FIXME: Implement this...
 
     // Names
@@ -223,6 +229,10 @@ namespace beaker
 
     /// Stores previously translated types.
     Type_map m_types;
+
+    /// The target machine. This determines the target triple and data
+    /// layout of generated modules.
+    std::unique_ptr<llvm::TargetMachine> m_target;
   };
 
 } // namespace beaker
@@ -2,8 +2,11 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <string>
 #include <type_traits>
 #include <typeinfo>
+#include <vector>
 
 // FIXME: Move this into a config header.
 
@@ -47,15 +50,25 @@ namespace beaker
   } // namespace fnv1_detail
 
 
-  // The fnv1a hash algorithm is the default hasher.
-  struct Hasher
+  // ------------------------------------------------------------------------ //
+  // Hash algorithms
+  //
+  // A hasher is a function object that accumulates bytes into a hash code.
+  // Hashers are called with `h(p, n)` to append `n` bytes at `p`, and are
+  // explicitly converted to std::size_t to obtain the hash code. Objects are
+  // appended by calling `hash_append(h, obj)`, which is overloaded for each
+  // hashable type and templated over the hasher.
+
+  /// The FNV-1a hash algorithm. This consumes one byte at a time, which
+  /// makes it simple but slow. It is retained for comparison.
+  struct Fnv1a_hasher
   {
-    Hasher()
+    Fnv1a_hasher()
       : code(fnv1_detail::basis())
     { }
 
     /// Hash bytes into the code.
-    void operator()(const void* p, int n) 
+    void operator()(const void* p, std::size_t n) 
     {
       unsigned char const* first = static_cast<unsigned char const*>(p);
       unsigned char const* limit = first + n;
@@ -64,32 +77,143 @@ namespace beaker
     }
 
     /// Returns the computed hash code.
-    operator std::size_t() const { return code; }
+    explicit operator std::size_t() const { return code; }
 
     std::size_t code;
   };
 
 
+  namespace wy_detail
+  {
+
+  constexpr std::uint64_t secret_0() { return 0xa0761d6478bd642full; }
+  constexpr std::uint64_t secret_1() { return 0xe7037ed1a0b428dbull; }
+
+  /// Returns the high and low halves of the 128-bit product of `a` and `b`,
+  /// combined by exclusive or.
+  inline std::uint64_t
+  mix(std::uint64_t a, std::uint64_t b)
+  {
+  #if defined(__SIZEOF_INT128__)
+    __uint128_t r = a;
+    r *= b;
+    return (std::uint64_t)r ^ (std::uint64_t)(r >> 64);
+  #else
+    std::uint64_t ha = a >> 32, hb = b >> 32;
+    std::uint64_t la = (std::uint32_t)a, lb = (std::uint32_t)b;
+    std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    std::uint64_t t = rl + (rm0 << 32);
+    std::uint64_t c = t < rl;
+    std::uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    std::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
+  #endif
+  }
+
+  inline std::uint64_t
+  read_8(const unsigned char* p)
+  {
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+  }
+
+  inline std::uint64_t
+  read_4(const unsigned char* p)
+  {
+    std::uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+  }
+
+  /// Reads 1 to 3 bytes.
+  inline std::uint64_t
+  read_3(const unsigned char* p, std::size_t n)
+  {
+    return ((std::uint64_t)p[0] << 16) | ((std::uint64_t)p[n >> 1] << 8) | p[n - 1];
+  }
+
+  } // namespace wy_detail
+
+
+  /// A word-at-a-time hash algorithm in the style of wyhash. Each call folds
+  /// up to 16 bytes into the state with a single 64x64->128 bit multiply.
+  /// Short inputs, which are the common case for hash_append, are read with
+  /// (possibly overlapping) 4 and 8-byte loads, and never byte by byte.
+  struct Wy_hasher
+  {
+    Wy_hasher()
+      : state(wy_detail::secret_0())
+    { }
+
+    /// Hash bytes into the state.
+    void operator()(const void* p, std::size_t n)
+    {
+      using namespace wy_detail;
+      const unsigned char* q = static_cast<const unsigned char*>(p);
+      std::uint64_t a, b;
+      if (n <= 16) {
+        if (n >= 4) {
+          std::size_t k = (n >> 3) << 2;
+          a = (read_4(q) << 32) | read_4(q + k);
+          b = (read_4(q + n - 4) << 32) | read_4(q + n - 4 - k);
+        }
+        else if (n > 0) {
+          a = read_3(q, n);
+          b = 0;
+        }
+        else {
+          a = b = 0;
+        }
+      }
+      else {
+        std::size_t i = n;
+        for (; i > 16; i -= 16, q += 16)
+          state = mix(read_8(q) ^ secret_1(), read_8(q + 8) ^ state);
+        a = read_8(q + i - 16);
+        b = read_8(q + i - 8);
+      }
+      state = mix(a ^ secret_1(), b ^ state ^ n);
+    }
+
+    /// Returns the computed hash code.
+    explicit operator std::size_t() const
+    {
+      return wy_detail::mix(state ^ wy_detail::secret_0(), wy_detail::secret_1());
+    }
+
+    std::uint64_t state;
+  };
+
+
+  /// The default hash algorithm.
+  using Hasher = Wy_hasher;
+
+
+  // ------------------------------------------------------------------------ //
+  // Hash append
+
   /// Hash for trivially comparable T.
-  template<typename T>
+  template<typename H, typename T>
   inline typename std::enable_if_t<std::is_integral<T>::value, void>
-  hash_append(Hasher& h, T t)
+  hash_append(H& h, T t)
   {
     h(&t, sizeof(t));
   }
 
-  template<typename T>
+  template<typename H, typename T>
   inline typename std::enable_if_t<std::is_enum<T>::value, void>
-  hash_append(Hasher& h, T t)
+  hash_append(H& h, T t)
   {
     h(&t, sizeof(t));
   }
 
   /// Hash for floating point T. Guarantee that 0 and -0 have the same 
   /// hash code since 0 == -0.
-  template<typename T>
+  template<typename H, typename T>
   inline typename std::enable_if_t<std::is_floating_point<T>::value, void>
-  hash_append(Hasher& h, T t)
+  hash_append(H& h, T t)
   {
     if (t == 0)
       t = 0;
@@ -97,37 +221,69 @@ namespace beaker
   }
 
   /// Hash for pointers. This just hashes the bits of the address.
-  template<typename T>
+  template<typename H, typename T>
   inline void
-  hash_append(Hasher& h, const T* p)
+  hash_append(H& h, const T* p)
   {
     h(&p, sizeof(p));
   }
 
   /// Hash append for nullptr.
+  template<typename H>
   inline void
-  hash_append(Hasher& h, std::nullptr_t p)
+  hash_append(H& h, std::nullptr_t p)
   {
     h(&p, sizeof(p));
   }
 
   /// Hash for type information.
+  template<typename H>
   inline void
-  hash_append(Hasher& h, const std::type_info& ti) 
+  hash_append(H& h, const std::type_info& ti) 
   {
     hash_append(h, ti.hash_code());
   }
 
+  /// Hash for strings. The size is appended after the characters so that
+  /// adjacent strings are not confused.
+  template<typename H>
+  inline void
+  hash_append(H& h, const std::string& str)
+  {
+    h(str.data(), str.size());
+    hash_append(h, str.size());
+  }
+
+  /// Hash for the elements in [first, last), followed by their number.
+  template<typename H, typename I>
+  inline void
+  hash_append_range(H& h, I first, I last)
+  {
+    std::size_t n = 0;
+    for (; first != last; ++first, ++n)
+      hash_append(h, *first);
+    hash_append(h, n);
+  }
+
+  /// Hash for vectors. Note that sequences of pointers (e.g., Type_seq)
+  /// are hashed by the identity of their elements.
+  template<typename H, typename T, typename A>
+  inline void
+  hash_append(H& h, const std::vector<T, A>& vec)
+  {
+    hash_append_range(h, vec.begin(), vec.end());
+  }
+
   // ------------------------------------------------------------------------ //
   // Hash functions
 
   /// Computes the hash values of objects.
-  template<typename T>
+  template<typename T, typename H = Hasher>
   struct Hash
   {
     std::size_t operator()(const T& obj) const noexcept
     {
-      Hasher h;
+      H h;
       hash_append(h, obj);
       return (std::size_t)h;
     };
@@ -135,12 +291,12 @@ namespace beaker
 
 
   /// Hashes a pointer to an object.
-  template<typename T>
+  template<typename T, typename H = Hasher>
   struct Indirect_hash
   {
     std::size_t operator()(const T* obj) const noexcept
     {
-      Hasher h;
+      H h;
       hash_append(h, *obj);
       return (std::size_t)h;
     };
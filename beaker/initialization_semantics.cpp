@@ -17,13 +17,13 @@ namespace beaker
     if (d->is_value()) {
       std::stringstream ss;
       ss << "value declarations must be initialized";
-      throw std::runtime_error(ss.str());
+      error(d->get_name_location(), ss.str());
     }
 
     if (d->is_reference()) {
       std::stringstream ss;
       ss << "reference declarations must be initialized";
-      throw std::runtime_error(ss.str());
+      error(d->get_name_location(), ss.str());
     }
 
     // Build the object expression.
@@ -31,7 +31,7 @@ namespace beaker
     Expression* obj = make_init_expression(var);
 
     // Build the initializer. 
-    Initializer* init = new Default_initializer(obj);
+    Initializer* init = m_cxt.make<Default_initializer>(obj);
     d->set_initializer(init);
   }
 
@@ -53,7 +53,7 @@ namespace beaker
     // Convert the initializer to the entity's type.
     e = convert_to_type(e, d->get_type());
 
-    if (auto* var = dynamic_cast<Variable_declaration*>(d))
+    if (auto* var = dyn_cast<Variable_declaration>(d))
       value_initialize_variable(var, e);
     else
       value_initialize_constant(d, e);
@@ -67,7 +67,7 @@ namespace beaker
     Expression* obj = make_init_expression(d);
 
     /// Build the initializer.
-    Initializer* init = new Value_initializer(obj, e);
+    Initializer* init = m_cxt.make<Value_initializer>(obj, e);
 
     d->set_initializer(init);
   }
@@ -15,6 +15,9 @@ namespace beaker
     { }
 
   public:
+    /// Initializers are those from `empty_init` through `val_init`.
+    static bool classof(const Expression* p) { return p->get_kind() >= empty_init && p->get_kind() <= val_init; }
+
     /// Returns the object being initialized. For variable declarations,
     /// this is an id-expression referring to the object. For dynamic
     /// allocations and temporaries, this is the expression that creates
@@ -39,6 +42,8 @@ namespace beaker
   class Empty_initializer : public Initializer
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == empty_init; }
+
     Empty_initializer(Expression* obj)
       : Initializer(empty_init, obj)
     { }
@@ -54,6 +59,8 @@ namespace beaker
   class Default_initializer : public Initializer
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == def_init; }
+
     Default_initializer(Expression* obj)
       : Initializer(def_init, obj)
     { }
@@ -69,6 +76,8 @@ namespace beaker
   class Value_initializer : public Initializer
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == val_init; }
+
     Value_initializer(Expression* obj, Expression* e)
       : Initializer(val_init, obj), m_expr(e)
     { }
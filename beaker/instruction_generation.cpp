@@ -1,6 +1,8 @@
 #include "instruction_generation.hpp"
 #include "function_generation.hpp"
 
+#include <llvm/IR/BasicBlock.h>
+
 namespace beaker
 {
   Instruction_generator::Instruction_generator(Function_context& parent)
@@ -61,6 +63,12 @@ namespace beaker
     m_parent.emit_block(b);
   }
 
+  bool
+  Instruction_generator::is_terminated() const
+  {
+    return get_current_block()->getTerminator();
+  }
+
   void
   Instruction_generator::declare(const Typed_declaration* d, llvm::Value* v)
   {
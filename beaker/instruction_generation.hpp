@@ -63,6 +63,10 @@ namespace beaker
     /// Emits `b`, making it the current block.
     void emit_block(llvm::BasicBlock* b);
 
+    /// Returns true if the current block ends with a terminator. Nothing
+    /// can be emitted into such a block.
+    bool is_terminated() const;
+
     // Declarations
 
     /// Locally associate a declaration with its value.
@@ -86,6 +90,7 @@ namespace beaker
     llvm::Value* generate_bool_literal(const Bool_literal* e);
     llvm::Value* generate_int_literal(const Int_literal* e);
     llvm::Value* generate_id_expression(const Id_expression* e);
+    llvm::Value* generate_folded_expression(const Folded_expression* e);
 
     // Arithmetic expressions
     llvm::Value* generate_addition_expression(const Addition_expression* e);
@@ -3,55 +3,374 @@
 #include "file.hpp"
 
 #include <cassert>
-#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
 #include <sstream>
 #include <iostream>
 
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define BEAKER_X86_SIMD
+#endif
+
 namespace beaker
 {
   // ------------------------------------------------------------------------ //
   // Character classes
 
-  static bool
-  is_space(char c)
+  enum Char_class : std::uint8_t
+  {
+    space_char = 0x01,
+    newline_char = 0x02,
+    nondigit_char = 0x04,
+    digit_char = 0x08,
+    hexadecimal_char = 0x10,
+    binary_char = 0x20,
+  };
+
+  /// Maps each character to its classes. Classification does not depend on
+  /// the locale. Note that the null character has no class, which lets the
+  /// sentinel at the end of the input terminate every scanning loop.
+  struct Char_table
+  {
+    std::uint8_t classes[256];
+  };
+
+  static constexpr Char_table
+  make_char_table()
   {
-    return c == ' ' || c == '\t';
+    Char_table t {};
+    t.classes[(unsigned char)' '] = space_char;
+    t.classes[(unsigned char)'\t'] = space_char;
+    t.classes[(unsigned char)'\n'] = newline_char;
+    t.classes[(unsigned char)'_'] = nondigit_char;
+    for (char c = 'a'; c <= 'z'; ++c)
+      t.classes[(unsigned char)c] |= nondigit_char;
+    for (char c = 'A'; c <= 'Z'; ++c)
+      t.classes[(unsigned char)c] |= nondigit_char;
+    for (char c = '0'; c <= '9'; ++c)
+      t.classes[(unsigned char)c] |= digit_char | hexadecimal_char;
+    for (char c = 'a'; c <= 'f'; ++c)
+      t.classes[(unsigned char)c] |= hexadecimal_char;
+    for (char c = 'A'; c <= 'F'; ++c)
+      t.classes[(unsigned char)c] |= hexadecimal_char;
+    t.classes[(unsigned char)'0'] |= binary_char;
+    t.classes[(unsigned char)'1'] |= binary_char;
+    return t;
   }
 
-  static bool
-  is_newline(char c)
+  static constexpr Char_table char_table = make_char_table();
+
+  static inline bool
+  has_class(char c, unsigned k)
   {
-    return c == '\n';
+    return char_table.classes[(unsigned char)c] & k;
   }
 
-  static bool
+  static inline bool
+  is_whitespace(char c)
+  {
+    return has_class(c, space_char | newline_char);
+  }
+
+  static inline bool
   is_nondigit(char c)
   {
-    return std::isalpha(c) || c == '_';
+    return has_class(c, nondigit_char);
   }
 
-  static bool
+  static inline bool
   is_digit(char c)
   {
-    return std::isdigit(c);
+    return has_class(c, digit_char);
   }
 
-  static bool
+  static inline bool
   is_alphanumeric(char c)
   {
-    return std::isalnum(c);
+    return has_class(c, nondigit_char | digit_char);
   }
 
-  static bool
+  static inline bool
   is_binary_digit(char c)
   {
-    return c == '0' || c == '1';
+    return has_class(c, binary_char);
   }
 
-  static bool
+  static inline bool
   is_hexadecimal_digit(char c)
   {
-    return std::isxdigit(c);
+    return has_class(c, hexadecimal_char);
+  }
+
+  // ------------------------------------------------------------------------ //
+  // Character scanning
+  //
+  // Each scan function returns the first character in [first, last) that
+  // does not belong to some run of characters. The vector loops stop short
+  // of the end of the input so that they never read past it; the scalar
+  // loops finish the run and rely on the sentinel to stop at the end.
+  //
+  // Whitespace and identifiers come in short runs, so they are scanned 16
+  // bytes at a time with SSE2, which is always available on x86-64.
+  // Comments are long, so they are scanned 32 bytes at a time when AVX2 is
+  // available at runtime.
+
+#if defined(__SSE2__)
+  /// Returns a mask of the whitespace characters in `v`.
+  static inline unsigned
+  get_whitespace_mask(__m128i v)
+  {
+    __m128i sp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i tab = _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'));
+    __m128i nl = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(sp, tab), nl));
+  }
+
+  /// Returns a mask of the identifier characters in `v`. Letters are
+  /// folded to lower case before their range is checked. Characters
+  /// outside the basic character set are negative and fail every range.
+  static inline unsigned
+  get_alphanumeric_mask(__m128i v)
+  {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                  _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), lower));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                  _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), v));
+    __m128i under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), under));
+  }
+#endif
+
+  /// Skips spaces, tabs, and newlines.
+  static inline const char*
+  scan_whitespace(const char* first, const char* last)
+  {
+#if defined(__SSE2__)
+    for (; last - first >= 16; first += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+      unsigned mask = get_whitespace_mask(v);
+      if (mask != 0xffff)
+        return first + __builtin_ctz(~mask);
+    }
+#endif
+    while (is_whitespace(*first))
+      ++first;
+    return first;
+  }
+
+  /// Skips letters, digits, and underscores.
+  static inline const char*
+  scan_alphanumeric(const char* first, const char* last)
+  {
+#if defined(__SSE2__)
+    for (; last - first >= 16; first += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+      unsigned mask = get_alphanumeric_mask(v);
+      if (mask != 0xffff)
+        return first + __builtin_ctz(~mask);
+    }
+#endif
+    while (is_alphanumeric(*first))
+      ++first;
+    return first;
+  }
+
+  /// Returns the first newline in [first, last), or last if there is none.
+  static const char*
+  scan_line_scalar(const char* first, const char* last)
+  {
+    const void* p = std::memchr(first, '\n', last - first);
+    return p ? static_cast<const char*>(p) : last;
+  }
+
+#if defined(BEAKER_X86_SIMD)
+  __attribute__((target("avx2"))) static const char*
+  scan_line_avx2(const char* first, const char* last)
+  {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    for (; last - first >= 32; first += 32) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+      unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl));
+      if (mask)
+        return first + __builtin_ctz(mask);
+    }
+    return scan_line_scalar(first, last);
+  }
+#endif
+
+  /// Skips to the end of the current line.
+  static const char*
+  scan_line(const char* first, const char* last)
+  {
+#if defined(BEAKER_X86_SIMD)
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2)
+      return scan_line_avx2(first, last);
+#endif
+    return scan_line_scalar(first, last);
+  }
+
+  // ------------------------------------------------------------------------ //
+  // Keywords
+  //
+  // Keywords are recognized by a perfect hash over the characters of a word,
+  // computed at compile time. A word is classified before it is interned, so
+  // keywords never reach the symbol table.
+
+  namespace
+  {
+    struct Keyword
+    {
+      const char* spelling;
+      std::size_t length;
+      Token::Name name;
+    };
+
+    constexpr Keyword keywords[] = {
+      {"auto", 4, Token::auto_kw},
+      {"assert", 6, Token::assert_kw},
+      {"bool", 4, Token::bool_kw},
+      {"break", 5, Token::break_kw},
+      {"case", 4, Token::case_kw},
+      {"char", 4, Token::char_kw},
+      {"char8_t", 7, Token::char8_t_kw},
+      {"char16_t", 8, Token::char16_t_kw},
+      {"char32_t", 8, Token::char32_t_kw},
+      {"concept", 7, Token::concept_kw},
+      {"const", 5, Token::const_kw},
+      {"continue", 8, Token::continue_kw},
+      {"default", 7, Token::default_kw},
+      {"delete", 6, Token::delete_kw},
+      {"do", 2, Token::do_kw},
+      {"double", 6, Token::double_kw},
+      {"else", 4, Token::else_kw},
+      {"enum", 4, Token::enum_kw},
+      {"export", 6, Token::export_kw},
+      {"extern", 6, Token::extern_kw},
+      {"false", 5, Token::false_kw},
+      {"float", 5, Token::float_kw},
+      {"for", 3, Token::for_kw},
+      {"func", 4, Token::func_kw},
+      {"goto", 4, Token::goto_kw},
+      {"if", 2, Token::if_kw},
+      {"import", 6, Token::import_kw},
+      {"int", 3, Token::int_kw},
+      {"int8", 4, Token::int8_kw},
+      {"int16", 5, Token::int16_kw},
+      {"int32", 5, Token::int32_kw},
+      {"int64", 5, Token::int64_kw},
+      {"int128", 6, Token::int128_kw},
+      {"namespace", 9, Token::namespace_kw},
+      {"new", 3, Token::new_kw},
+      {"operator", 8, Token::operator_kw},
+      {"ref", 3, Token::ref_kw},
+      {"requires", 8, Token::requires_kw},
+      {"return", 6, Token::return_kw},
+      {"switch", 6, Token::switch_kw},
+      {"template", 8, Token::template_kw},
+      {"true", 4, Token::true_kw},
+      {"typename", 8, Token::typename_kw},
+      {"union", 5, Token::union_kw},
+      {"unit", 4, Token::unit_kw},
+      {"using", 5, Token::using_kw},
+      {"val", 3, Token::val_kw},
+      {"var", 3, Token::var_kw},
+      {"virtual", 7, Token::virtual_kw},
+      {"volatile", 8, Token::volatile_kw},
+      {"while", 5, Token::while_kw},
+    };
+
+    constexpr std::size_t keyword_count = sizeof(keywords) / sizeof(Keyword);
+
+    /// The number of slots in the keyword table. This must be a power of 2
+    /// no greater than 256.
+    constexpr std::size_t keyword_slots = 256;
+
+    /// The hash of a keyword is the FNV-1a hash of its characters, starting
+    /// from `seed`, reduced to a slot index by taking its high bits.
+    constexpr std::size_t
+    hash_keyword(const char* str, std::size_t len, std::uint32_t seed)
+    {
+      std::uint32_t h = seed;
+      for (std::size_t i = 0; i != len; ++i)
+        h = (h ^ (unsigned char)str[i]) * 16777619u;
+      return (h >> 24) & (keyword_slots - 1);
+    }
+
+    /// Maps slots to keywords. A slot holds 1 + the index of its keyword in
+    /// the keyword list, or 0 if it is empty. The seed is 0 if no perfect
+    /// hash was found.
+    struct Keyword_table
+    {
+      std::uint32_t seed;
+      std::uint8_t slots[keyword_slots];
+      std::size_t min_length;
+      std::size_t max_length;
+    };
+
+    /// Returns true if the keywords hash without collisions under `seed`,
+    /// storing the resulting slots in `t`.
+    constexpr bool
+    fill_keyword_table(Keyword_table& t, std::uint32_t seed)
+    {
+      for (std::size_t i = 0; i != keyword_slots; ++i)
+        t.slots[i] = 0;
+      for (std::size_t i = 0; i != keyword_count; ++i) {
+        std::size_t h = hash_keyword(keywords[i].spelling, keywords[i].length, seed);
+        if (t.slots[h])
+          return false;
+        t.slots[h] = i + 1;
+      }
+      t.seed = seed;
+      return true;
+    }
+
+    /// Searches for a seed that gives a perfect hash of the keywords.
+    constexpr Keyword_table
+    make_keyword_table()
+    {
+      Keyword_table t {};
+      t.min_length = keywords[0].length;
+      t.max_length = keywords[0].length;
+      for (std::size_t i = 0; i != keyword_count; ++i) {
+        if (keywords[i].length < t.min_length)
+          t.min_length = keywords[i].length;
+        if (keywords[i].length > t.max_length)
+          t.max_length = keywords[i].length;
+      }
+      for (std::uint32_t seed = 2166136261u; seed != 2166136261u + 4096; ++seed) {
+        if (fill_keyword_table(t, seed))
+          return t;
+      }
+      t.seed = 0;
+      return t;
+    }
+
+    constexpr Keyword_table keyword_table = make_keyword_table();
+
+    static_assert(keyword_count < 256, "too many keywords");
+    static_assert(keyword_table.seed != 0, "no perfect hash for the keywords");
+
+  } // namespace
+
+  Token::Name
+  get_keyword(const char* first, const char* last)
+  {
+    std::size_t len = last - first;
+    if (len < keyword_table.min_length || len > keyword_table.max_length)
+      return Token::identifier;
+    std::size_t h = hash_keyword(first, len, keyword_table.seed);
+    std::uint8_t k = keyword_table.slots[h];
+    if (k == 0)
+      return Token::identifier;
+    const Keyword& kw = keywords[k - 1];
+    if (kw.length != len || std::memcmp(kw.spelling, first, len) != 0)
+      return Token::identifier;
+    return kw.name;
   }
 
   // ------------------------------------------------------------------------ //
@@ -70,68 +389,23 @@ namespace beaker
   }
 
   Lexer::Lexer(Context& cxt, const File& f)
+    : Lexer(cxt, f, get_start_of_input(f))
+  { }
+
+  Lexer::Lexer(Context& cxt, const File& f, const char* first)
     : m_cxt(cxt), 
+      m_syms(cxt.get_symbol_table()),
       m_base(f.get_base_offset()),
       m_begin(get_start_of_input(f)), 
-      m_curr(m_begin), 
+      m_curr(first), 
       m_end(get_end_of_input(f)), 
       m_loc()
   {
-    m_reserved.insert({
-      {m_cxt.get_symbol("auto"), Token::auto_kw},
-      {m_cxt.get_symbol("assert"), Token::assert_kw},
-      {m_cxt.get_symbol("bool"), Token::bool_kw},
-      {m_cxt.get_symbol("break"), Token::break_kw},
-      {m_cxt.get_symbol("case"), Token::case_kw},
-      {m_cxt.get_symbol("char"), Token::char_kw},
-      {m_cxt.get_symbol("char8_t"), Token::char8_t_kw},
-      {m_cxt.get_symbol("char16_t"), Token::char16_t_kw},
-      {m_cxt.get_symbol("char32_t"), Token::char32_t_kw},
-      {m_cxt.get_symbol("concept"), Token::concept_kw},
-      {m_cxt.get_symbol("const"), Token::const_kw},
-      {m_cxt.get_symbol("continue"), Token::continue_kw},
-      {m_cxt.get_symbol("default"), Token::default_kw},
-      {m_cxt.get_symbol("delete"), Token::delete_kw},
-      {m_cxt.get_symbol("do"), Token::do_kw},
-      {m_cxt.get_symbol("double"), Token::double_kw},
-      {m_cxt.get_symbol("else"), Token::else_kw},
-      {m_cxt.get_symbol("enum"), Token::enum_kw},
-      {m_cxt.get_symbol("export"), Token::export_kw},
-      {m_cxt.get_symbol("extern"), Token::extern_kw},
-      {m_cxt.get_symbol("false"), Token::false_kw},
-      {m_cxt.get_symbol("float"), Token::float_kw},
-      {m_cxt.get_symbol("for"), Token::for_kw},
-      {m_cxt.get_symbol("func"), Token::func_kw},
-      {m_cxt.get_symbol("goto"), Token::goto_kw},
-      {m_cxt.get_symbol("if"), Token::if_kw},
-      {m_cxt.get_symbol("int"), Token::int_kw},
-      {m_cxt.get_symbol("int8"), Token::int8_kw},
-      {m_cxt.get_symbol("int16"), Token::int16_kw},
-      {m_cxt.get_symbol("int32"), Token::int32_kw},
-      {m_cxt.get_symbol("int64"), Token::int64_kw},
-      {m_cxt.get_symbol("int128"), Token::int128_kw},
-      {m_cxt.get_symbol("namespace"), Token::namespace_kw},
-      {m_cxt.get_symbol("new"), Token::new_kw},
-      {m_cxt.get_symbol("operator"), Token::operator_kw},
-      {m_cxt.get_symbol("ref"), Token::ref_kw},
-      {m_cxt.get_symbol("requires"), Token::requires_kw},
-      {m_cxt.get_symbol("return"), Token::return_kw},
-      {m_cxt.get_symbol("switch"), Token::switch_kw},
-      {m_cxt.get_symbol("template"), Token::template_kw},
-      {m_cxt.get_symbol("true"), Token::true_kw},
-      {m_cxt.get_symbol("typename"), Token::typename_kw},
-      {m_cxt.get_symbol("union"), Token::union_kw},
-      {m_cxt.get_symbol("unit"), Token::union_kw},
-      {m_cxt.get_symbol("using"), Token::using_kw},
-      {m_cxt.get_symbol("val"), Token::val_kw},
-      {m_cxt.get_symbol("var"), Token::var_kw},
-      {m_cxt.get_symbol("virtual"), Token::virtual_kw},
-      {m_cxt.get_symbol("volatile"), Token::volatile_kw},
-      {m_cxt.get_symbol("while"), Token::while_kw},
-    });
-  }
-
-  // Returns true if past the end of file.
+    assert(m_begin <= m_curr && m_curr <= m_end);
+  }
+
+  // Returns true if past the end of file. This only needs to be checked
+  // when the current character is the null character.
   bool
   Lexer::eof() const
   {
@@ -142,18 +416,15 @@ namespace beaker
   char
   Lexer::peek() const 
   { 
-    return eof() ? 0 : *m_curr; 
+    return *m_curr; 
   }
 
-  // Returns the nth character past the current character or 0 if past the
-  // end of file.
+  // Returns the nth character past the current character. The characters
+  // before it must not be the sentinel.
   char 
   Lexer::peek(int n) const 
   { 
-    if (n < m_end - m_curr)
-      return *(m_curr + n);
-    else
-      return 0;
+    return *(m_curr + n);
   }
 
   char
@@ -198,22 +469,30 @@ namespace beaker
     return Location(m_base + (m_curr - m_begin));
   }
 
+  void
+  Lexer::error(Location loc, const std::string& msg) const
+  {
+    throw Source_error(m_cxt.get_source_location(loc), msg);
+  }
+
   Token
   Lexer::scan()
   {
-    while (!eof()) {
+    while (true) {
       // Note the start location of the token.
       m_loc = get_location();
 
       // Analyze the current character.
       switch (*m_curr) {
+      case '\0':
+        if (eof())
+          return {};
+        goto invalid;
+
       case ' ':
       case '\t':
-        skip_space();
-        continue;
-
       case '\n':
-        skip_newline();
+        skip_space();
         continue;
 
       case '#':
@@ -322,39 +601,30 @@ namespace beaker
         if (is_digit(*m_curr))
           return lex_number();
 
+      invalid:
         std::stringstream ss;
         ss << "invalid character '" << *m_curr << '\'';
-        throw std::runtime_error(ss.str());
+        error(m_loc, ss.str());
       }
       }
     }
-    return {};
   }
 
 
   void
   Lexer::skip_space()
   {
-    assert(is_space(*m_curr));
-    ignore();
-    while (!eof() && is_space(*m_curr))
-      ignore();
-  }
-
-  void
-  Lexer::skip_newline()
-  {
-    assert(*m_curr == '\n');
+    assert(is_whitespace(*m_curr));
     ignore();
+    if (is_whitespace(*m_curr))
+      m_curr = scan_whitespace(m_curr, m_end);
   }
 
   void
   Lexer::skip_comment()
   {
     assert(*m_curr == '#');
-    ignore();
-    while (!eof() && !is_newline(*m_curr))
-      ignore();
+    m_curr = scan_line(m_curr + 1, m_end);
   }
 
   Token
@@ -384,24 +654,21 @@ namespace beaker
     assert(is_nondigit(*m_curr));
     
     const char* start = m_curr;
-    accept();
-    while (!eof() && is_alphanumeric(*m_curr))
-      accept();
+    m_curr = scan_alphanumeric(m_curr + 1, m_end);
 
-    // Determine whether [start, m_curr) is an identifier or a reserved word.
-    std::string str(start, m_curr);
-    Symbol sym = m_cxt.get_symbol(str);
-    auto iter = m_reserved.find(sym);
-    if (iter != m_reserved.end())
-      return Token(iter->second, m_loc, sym->size());
-    else 
-      return Token(Token::identifier, m_loc, sym);
+    // Determine whether [start, m_curr) is a reserved word. Only identifiers
+    // are interned.
+    Token::Name kw = get_keyword(start, m_curr);
+    if (kw != Token::identifier)
+      return Token(kw, m_loc, m_curr - start);
+    Symbol sym = m_syms.get(start, m_curr - start);
+    return Token(Token::identifier, m_loc, sym);
   }
 
   Token
   Lexer::lex_number()
   {
-    assert(isdigit(*m_curr));
+    assert(is_digit(*m_curr));
     const char* start = m_curr;
 
     // Check for a prefix; that determines the alphabet of the subsequent lex.
@@ -419,13 +686,12 @@ namespace beaker
 
     // This is a decimal whole number. We detect fractions later.
     accept();
-    while (!eof() && is_digit(*m_curr))
+    while (is_digit(*m_curr))
       accept();
 
     // The integer is in [start, m_curr).
     if (peek() != '.') {
-      std::string str(start, m_curr);
-      Symbol sym = m_cxt.get_symbol(str);
+      Symbol sym = m_syms.get(start, m_curr - start);
       return Token(Token::decimal_integer, m_loc, sym);
     }
 
@@ -433,14 +699,13 @@ namespace beaker
     //
     // FIXME: There must be at least one digit.
     accept();
-    while (!eof() && is_digit(*m_curr))
+    while (is_digit(*m_curr))
       accept();
 
     // FIXME: Lex the exponent.
 
     // The floating point number is in [start, m_curr).
-    std::string str(start, m_curr);
-    Symbol sym = m_cxt.get_symbol(str);
+    Symbol sym = m_syms.get(start, m_curr - start);
     return Token(Token::decimal_float, m_loc, sym);
   }
 
@@ -453,11 +718,10 @@ namespace beaker
     // FIXME: There must be at least one digit.
 
     const char* start = m_curr;
-    while (!eof() && is_binary_digit(*m_curr))
+    while (is_binary_digit(*m_curr))
       accept();
 
-    std::string str(start, m_curr);
-    Symbol sym = m_cxt.get_symbol(str);
+    Symbol sym = m_syms.get(start, m_curr - start);
     return Token(Token::binary_integer, m_loc, sym);
   }
 
@@ -470,11 +734,10 @@ namespace beaker
     // FIXME: There must be at least one digit.
 
     const char* start = m_curr;
-    while (!eof() && is_hexadecimal_digit(*m_curr))
+    while (is_hexadecimal_digit(*m_curr))
       accept();
 
-    std::string str(start, m_curr);
-    Symbol sym = m_cxt.get_symbol(str);
+    Symbol sym = m_syms.get(start, m_curr - start);
     return Token(Token::hexadecimal_integer, m_loc, sym);
   }
 
@@ -488,9 +751,10 @@ namespace beaker
   Lexer::scan_escape_sequence()
   {
     assert(*m_curr == '\\');
+    Location loc = get_location();
     accept();
-    if (eof())
-      throw std::runtime_error("unterminated escape-sequence");
+    if (*m_curr == 0 && eof())
+      error(loc, "unterminated escape-sequence");
     switch (*m_curr) { // Note the increment.
     case '\'':
     case '\"':
@@ -504,7 +768,7 @@ namespace beaker
     case 'v':
       return accept();
     default:
-      throw std::runtime_error("invalid escape-sequence");
+      error(loc, "invalid escape-sequence");
     }
   }
 
@@ -521,19 +785,18 @@ namespace beaker
     assert(*m_curr == '\'');
     const char* start = m_curr;
     accept();
-    while (!eof() && *m_curr != '\'') {
+    while (*m_curr != '\'') {
+      if (*m_curr == 0 && eof())
+        error(m_loc, "unterminated character-literal");
       if (*m_curr == '\\')
         scan_escape_sequence();
       else
         scan_character_char();
     }
-    if (eof())
-      throw std::runtime_error("unterminated character-literal");
     accept();
 
     // The character literal is in [start, m_curr).
-    std::string str(start, m_curr);
-    Symbol sym = m_cxt.get_symbol(str);
+    Symbol sym = m_syms.get(start, m_curr - start);
     return Token(Token::character, m_loc, sym);
   }
 
@@ -551,21 +814,154 @@ namespace beaker
     accept();
 
     const char* start = m_curr;
-    accept();
-    while (!eof() && *m_curr != '"') {
+    while (*m_curr != '"') {
+      if (*m_curr == 0 && eof())
+        error(m_loc, "unterminated string-literal");
       if (*m_curr == '\\')
         scan_escape_sequence();
       else
         accept();
     }
-    if (eof())
-      throw std::runtime_error("unterminated string-literal");
     accept();
 
     // The string literal is in [start, m_curr).
-    std::string str(start, m_curr);
-    Symbol sym = m_cxt.get_symbol(str);
+    Symbol sym = m_syms.get(start, m_curr - start);
     return Token(Token::string, m_loc, sym);
   }
 
-} // namespace beaker
\ No newline at end of file
+  // ------------------------------------------------------------------------ //
+  // Parallel lexing
+  //
+  // A file is split into chunks that begin just after a newline, and each
+  // chunk is lexed on its own thread. Symbols are interned directly in the
+  // symbol table of the context, which is safe to share. The lexer
+  // for a chunk keeps the tokens that start within the chunk and records
+  // where the last of them ends.
+  //
+  // Splitting is speculative: a chunk boundary may fall within a string or
+  // character literal, or the previous chunk may not have ended before it.
+  // Chunks are validated in order while stitching. A chunk is only accepted
+  // if the previous chunk ended at or before its boundary and it lexed
+  // without error. Otherwise it is lexed again, serially, from the end of
+  // the previous chunk, which also produces the real diagnostic if the
+  // input is invalid.
+
+  /// Files smaller than this are not split.
+  static constexpr std::size_t min_chunk_size = 1 << 20;
+
+  /// The result of lexing one chunk.
+  struct Lexed_chunk
+  {
+    /// The offset of the first character of the chunk, relative to the
+    /// start of the file.
+    std::size_t first;
+
+    /// The offset past the last character of the chunk.
+    std::size_t last;
+
+    /// The tokens starting in [first, last).
+    Token_buffer toks;
+
+    /// The offset past the end of the last token.
+    std::size_t stop;
+
+    /// True if lexing the chunk failed.
+    bool failed;
+  };
+
+  /// Appends to `toks` the tokens that start in [first, last), lexed
+  /// starting at `first`. Returns the offset past the end of the last
+  /// token.
+  static std::size_t
+  lex_chunk(Context& cxt, 
+            const File& f, 
+            std::size_t first, 
+            std::size_t last, 
+            Token_buffer& toks)
+  {
+    const unsigned base = f.get_base_offset();
+    Lexer lex(cxt, f, f.get_text().data() + first);
+    std::size_t stop = first;
+    while (Token tok = lex()) {
+      if (tok.get_location().get_offset() - base >= last)
+        break;
+      toks.push_back(tok);
+      stop = lex.get_location().get_offset() - base;
+    }
+    return stop;
+  }
+
+  /// Returns the offset just past the first newline at or after `n` in
+  /// `text`, or the end of the text if there is none.
+  static std::size_t
+  get_chunk_boundary(Text_view text, std::size_t n)
+  {
+    const void* p = std::memchr(text.data() + n, '\n', text.size() - n);
+    if (!p)
+      return text.size();
+    return static_cast<const char*>(p) - text.data() + 1;
+  }
+
+  Token_buffer
+  lex_file(Context& cxt, const File& f, unsigned jobs)
+  {
+    Text_view text = f.get_text();
+    Token_buffer toks;
+    std::size_t count = std::min<std::size_t>(jobs, text.size() / min_chunk_size);
+    if (count <= 1) {
+      Lexer lex(cxt, f);
+      toks.reserve(text.size() / 5 + 1);
+      while (Token tok = lex())
+        toks.push_back(tok);
+      toks.push_back(Token(Token::eof, Location(f.get_limit_offset())));
+      return toks;
+    }
+
+    // Split the text into chunks.
+    std::vector<std::unique_ptr<Lexed_chunk>> chunks;
+    std::size_t first = 0;
+    for (std::size_t i = 1; i <= count && first != text.size(); ++i) {
+      std::size_t last = i == count 
+        ? text.size() 
+        : get_chunk_boundary(text, std::max(first, text.size() / count * i));
+      chunks.emplace_back(new Lexed_chunk {first, last, {}, first, false});
+      first = last;
+    }
+
+    // Lex each chunk speculatively.
+    auto lex = [&cxt, &f](Lexed_chunk& c) {
+      try {
+        c.toks.reserve((c.last - c.first) / 5 + 1);
+        c.stop = lex_chunk(cxt, f, c.first, c.last, c.toks);
+      }
+      catch (...) {
+        c.failed = true;
+      }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < chunks.size(); ++i)
+      threads.emplace_back(lex, std::ref(*chunks[i]));
+    lex(*chunks[0]);
+    for (std::thread& t : threads)
+      t.join();
+
+    // Stitch the chunks together, relexing those that were split badly.
+    std::size_t size = 0;
+    for (const auto& c : chunks)
+      size += c->toks.size();
+    toks.reserve(size + 1);
+    std::size_t stop = 0;
+    for (const auto& c : chunks) {
+      if (!c->failed && stop <= c->first) {
+        toks.append(c->toks);
+        stop = std::max(stop, c->stop);
+      }
+      else {
+        stop = lex_chunk(cxt, f, stop, c->last, toks);
+      }
+    }
+    toks.push_back(Token(Token::eof, Location(f.get_limit_offset())));
+    return toks;
+  }
+
+} // namespace beaker
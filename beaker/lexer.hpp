@@ -2,13 +2,22 @@
 
 #include <beaker/token.hpp>
 
-#include <unordered_map>
-
 namespace beaker
 {
   class File;
   class Context;
 
+  /// Returns the keyword spelled by the characters in [first, last), or
+  /// Token::identifier if they do not spell a keyword.
+  Token::Name get_keyword(const char* first, const char* last);
+
+
+  /// Lexes the entire file `f` into a token buffer, ending with the
+  /// end-of-file token. If `jobs` is greater than 1, a large file is split
+  /// into chunks that are lexed concurrently.
+  Token_buffer lex_file(Context& cxt, const File& f, unsigned jobs = 1);
+
+
   /// The lexer is responsible for transforming input characters into output
   /// tokens. Note that whitespace is excluded from the output (i.e., it is
   /// not significant to syntactic and semantic analysis).
@@ -20,10 +29,19 @@ namespace beaker
   class Lexer
   {
   public:
+    /// Constructs a lexer for `f`. Symbols are interned in the symbol table
+    /// of `cxt`.
     Lexer(Context& cxt, const File& f);
 
+    /// Constructs a lexer that starts at `first` in `f`. The first character
+    /// must not be within a token.
+    Lexer(Context& cxt, const File& f, const char* first);
+
     Token operator()() { return scan(); }
 
+    /// Returns the current location
+    Location get_location() const;
+
   private:
     Token scan();
 
@@ -38,12 +56,8 @@ namespace beaker
     char ignore();
     void ignore(int n);
 
-    /// Returns the current location
-    Location get_location() const;
-
     // Skip functions -- advance past certain lexical constructs
     void skip_space();
-    void skip_newline();
     void skip_comment();
 
     // Accept functions -- yield a token.
@@ -61,10 +75,16 @@ namespace beaker
     char scan_character_char();
     char scan_string_char();
 
+    /// Throws an error with the message `msg` at `loc`.
+    [[noreturn]] void error(Location loc, const std::string& msg) const;
+
   private:
-    /// Used to create symbols.
+    /// Used to diagnose errors.
     Context& m_cxt;
 
+    /// Used to create symbols.
+    Symbol_table& m_syms;
+
     /// The base offset for constructing locations. This is -1 if lexing
     /// from a source outside of a file.
     unsigned m_base;
@@ -82,9 +102,6 @@ namespace beaker
 
     /// The location of the current token.
     Location m_loc;
-
-    /// Stores information about reserved words.
-    std::unordered_map<Symbol, Token::Name> m_reserved;
   };
 
 } // namespace beaker
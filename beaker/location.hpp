@@ -33,8 +33,25 @@ public:
     return m_offset != -1;
   }
 
+  /// Returns the offset. The file containing the offset, and the line and
+  /// column within that file, are determined by the Source_manager.
+  unsigned get_offset() const { return m_offset; }
+
 private:
   unsigned m_offset;
 };
 
+/// Returns true if `a` and `b` denote the same offset.
+inline bool
+operator==(Location a, Location b)
+{
+  return a.get_offset() == b.get_offset();
+}
+
+inline bool
+operator!=(Location a, Location b)
+{
+  return !(a == b);
+}
+
 } // namespace beaker
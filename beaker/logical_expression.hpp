@@ -8,6 +8,8 @@ namespace beaker
   class Conditional_expression : public Ternary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == cond_kind; }
+
     Conditional_expression(Type* t, 
                            Expression* e1, 
                            Expression* e2, 
@@ -32,6 +34,8 @@ namespace beaker
   class Logical_and_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == and_kind; }
+
     Logical_and_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(and_kind, t, lhs, rhs, op)
     { }
@@ -42,6 +46,8 @@ namespace beaker
   class Logical_or_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == or_kind; }
+
     Logical_or_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(or_kind, t, lhs, rhs, op)
     { }
@@ -52,6 +58,8 @@ namespace beaker
   class Logical_not_expression : public Unary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == not_kind; }
+
     Logical_not_expression(Type* t, Expression* e, const Token& op)
       : Unary_operator(not_kind, t, e, op)
     { }
@@ -2,37 +2,716 @@
 #include <beaker/file.hpp>
 #include <beaker/module_parser.hpp>
 #include <beaker/declaration.hpp>
+#include <beaker/print.hpp>
+#include <beaker/module_interface.hpp>
+#include <beaker/snapshot.hpp>
 #include <beaker/generation.hpp>
+#include <beaker/cache.hpp>
 
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace beaker;
 
-int 
+/// Options that control the compilation of every input file.
+struct Options
+{
+  /// The number of files to compile concurrently.
+  unsigned jobs = 1;
+
+  /// The number of threads used to lex each large file.
+  unsigned lex_jobs = 1;
+
+  /// The number of threads used to parse the definitions in each file.
+  unsigned parse_jobs = 1;
+
+  /// The kind of output to produce.
+  Generator::Output_kind output_kind = Generator::ir_output;
+
+  /// The optimization level.
+  Generator::Optimization_level opt_level = Generator::O0;
+
+  /// True if the time spent in each optimization pass is reported.
+  bool time_passes = false;
+
+  /// True if statistics about the interning tables are reported.
+  bool intern_stats = false;
+
+  /// True if the memory used by syntax trees is reported.
+  bool memory_report = false;
+
+  /// True if only the interface of each module is written. Function bodies
+  /// are not parsed, and no code is generated.
+  bool interface = false;
+
+  /// True if function bodies are skipped by the module parser and parsed
+  /// afterwards, before translation.
+  bool skip_bodies = false;
+
+  /// True if a binary interface file is written for each module.
+  bool emit_interface = false;
+
+  /// True if a snapshot of the analyzed syntax trees is written for each
+  /// module.
+  bool emit_snapshot = false;
+
+  /// Directories searched for the interfaces of imported modules, after
+  /// the directory of the importing file.
+  std::vector<std::string> import_dirs;
+
+  /// The explicitly named output file, if any.
+  std::string output;
+
+  /// The directory of the compilation cache, if caching is enabled.
+  std::string cache_dir;
+
+  /// The maximum size of the compilation cache in bytes.
+  std::uint64_t cache_size = std::uint64_t(1) << 30;
+
+  /// True if cache statistics are reported.
+  bool cache_stats = false;
+
+  /// The compilation cache, if enabled.
+  Compilation_cache* cache = nullptr;
+
+  /// Describes the compiler and the options that affect its output. This
+  /// is part of the key for cached outputs.
+  std::string cache_config;
+};
+
+/// The result of compiling a single input file.
+struct Compilation
+{
+  /// The path to the input file.
+  std::string input;
+
+  /// The path to the output file, or "-" for standard output.
+  std::string output;
+
+  /// The emitted module.
+  llvm::SmallString<0> text;
+
+  /// The pass timing report, if requested.
+  std::string timing;
+
+  /// The interning statistics and memory report, if requested.
+  std::string stats;
+
+  /// The location of the diagnostic, if known.
+  std::string location;
+
+  /// The diagnostic, if compilation failed.
+  std::string error;
+
+  /// True if compilation failed.
+  bool failed = false;
+};
+
+using Compilation_seq = std::vector<Compilation>;
+
+/// Returns the file extension for outputs of kind `k`.
+static const char*
+get_output_extension(Generator::Output_kind k)
+{
+  switch (k) {
+  case Generator::ir_output:
+    return ".ll";
+  case Generator::bitcode_output:
+    return ".bc";
+  case Generator::assembly_output:
+    return ".s";
+  case Generator::object_output:
+    return ".o";
+  }
+  __builtin_unreachable();
+}
+
+/// Returns the output path for `input`. Textual IR is written to standard
+/// output unless a file is named. Otherwise, the output is written to the
+/// current directory in a file named after the input.
+static std::string
+get_output_path(const Options& opts, const std::string& input)
+{
+  if (!opts.output.empty())
+    return opts.output;
+  if (opts.interface || opts.output_kind == Generator::ir_output)
+    return "-";
+  llvm::SmallString<128> path = llvm::sys::path::filename(input);
+  llvm::sys::path::replace_extension(path, get_output_extension(opts.output_kind));
+  return path.str().str();
+}
+
+/// Returns true if `input` names a snapshot, which is loaded rather than
+/// translated.
+static bool
+is_snapshot(const std::string& input)
+{
+  return llvm::sys::path::extension(input) == ".bks";
+}
+
+/// Writes `text` to the file at `path`.
+static void
+write_output(const std::string& path, llvm::StringRef text)
+{
+  std::error_code ec;
+  llvm::raw_fd_ostream os(path, ec, llvm::sys::fs::OF_None);
+  if (ec) {
+    std::stringstream ss;
+    ss << "cannot open output file '" << path << "': " << ec.message();
+    throw std::runtime_error(ss.str());
+  }
+  os << text;
+}
+
+/// Returns a string that identifies this build of the compiler and the
+/// options that affect its output. The executable's size and modification
+/// time stand in for a version, so that cached outputs are invalidated
+/// whenever the compiler is rebuilt.
+static std::string
+get_cache_config(const Options& opts, const char* argv0)
+{
+  std::stringstream ss;
+  ss << "beaker";
+  std::string exe = llvm::sys::fs::getMainExecutable(argv0, (void*)&get_cache_config);
+  llvm::sys::fs::file_status st;
+  if (!llvm::sys::fs::status(exe, st)) {
+    auto time = st.getLastModificationTime().time_since_epoch().count();
+    ss << '-' << st.getSize() << '-' << time;
+  }
+  ss << ";llvm-" << LLVM_VERSION_STRING
+     << ";target=" << llvm::sys::getDefaultTargetTriple()
+     << ";output=" << opts.output_kind
+     << ";opt=" << opts.opt_level;
+  return ss.str();
+}
+
+/// Parses a size in bytes with an optional K, M, or G suffix. Returns 0 if
+/// the size is invalid.
+static std::uint64_t
+parse_size(const char* str)
+{
+  char* end;
+  std::uint64_t n = std::strtoull(str, &end, 10);
+  switch (*end) {
+  case 'K': case 'k':
+    n <<= 10; ++end;
+    break;
+  case 'M': case 'm':
+    n <<= 20; ++end;
+    break;
+  case 'G': case 'g':
+    n <<= 30; ++end;
+    break;
+  }
+  return *end == 0 ? n : 0;
+}
+
+/// Writes a line of statistics about an interning table to `os`.
+static void
+write_statistics(std::ostream& os, const char* what, const Intern_statistics& s)
+{
+  os << what << ": " << s.size << " of " << s.capacity << " slots used, "
+     << s.lookups << " lookups, " << s.hits << " hits, "
+     << s.probes << " probes\n";
+}
+
+/// Writes the memory used by the syntax trees of `input` to `os`. The
+/// trees are entirely contained in the context's arena.
+static void
+write_memory_report(std::ostream& os, Context& cxt, const File& input)
+{
+  Text_view text = input.get_text();
+  std::size_t lines = std::count(text.begin(), text.end(), '\n');
+  if (lines == 0)
+    lines = 1;
+  const Arena& arena = cxt.get_arena();
+  os << "  syntax trees: " << arena.size() << " bytes in "
+     << arena.capacity() << " reserved, "
+     << std::fixed << std::setprecision(1)
+     << double(arena.size()) / lines << " bytes per line ("
+     << lines << " lines)\n";
+}
+
+/// Writes the interface of the module `tu` to `os`. This is the name and
+/// type of each function and data declaration, none of which depend on
+/// function bodies.
+static void
+write_interface(std::ostream& os, const Declaration* tu)
+{
+  const Translation_unit* mod = static_cast<const Translation_unit*>(tu);
+  for (const Declaration* d : mod->get_declarations()) {
+    switch (d->get_kind()) {
+    case Declaration::func_kind:
+      os << "func ";
+      break;
+    case Declaration::val_kind:
+      os << "val ";
+      break;
+    case Declaration::var_kind:
+      os << "var ";
+      break;
+    case Declaration::ref_kind:
+      os << "ref ";
+      break;
+    default:
+      continue;
+    }
+    const Typed_declaration* td = static_cast<const Typed_declaration*>(d);
+    os << td->get_name() << " : " << *td->get_type() << ";\n";
+  }
+}
+
+/// Generates, optimizes, and emits the code for the module `tu`.
+static void
+generate(const Options& opts, Compilation& comp, Context& cxt, Declaration* tu)
+{
+  Generator gen(cxt);
+  gen.generate_module(tu, comp.input);
+
+  if (opts.intern_stats) {
+    std::stringstream ss;
+    if (!opts.memory_report)
+      ss << comp.input << ":\n";
+    write_statistics(ss, "  symbols", cxt.get_symbol_table().get_statistics());
+    write_statistics(ss, "  types", cxt.get_type_statistics());
+    write_statistics(ss, "  expressions", cxt.get_expression_statistics());
+    comp.stats += ss.str();
+  }
+
+  if (opts.time_passes) {
+    llvm::raw_string_ostream ts(comp.timing);
+    gen.optimize_module(opts.opt_level, &ts);
+  }
+  else {
+    gen.optimize_module(opts.opt_level);
+  }
+
+  llvm::raw_svector_ostream os(comp.text);
+  gen.emit_module(os, opts.output_kind);
+}
+
+/// Translates a single input file. Each translation has its own context,
+/// parser, and code generator, so no state is shared with other files
+/// being compiled at the same time.
+///
+/// When caching is enabled, a previous output for the same text and
+/// configuration is reused without translating the file.
+///
+/// Output destined for a file is written by the worker. Output destined
+/// for standard output is retained so that it can be written in order.
+static void
+compile(const Options& opts, Compilation& comp)
+{
+  try {
+    // The translation context.
+    Context cxt;
+    cxt.add_import_directory(llvm::sys::path::parent_path(comp.input).str());
+    for (const std::string& dir : opts.import_dirs)
+      cxt.add_import_directory(dir);
+
+    // A snapshot has already been analyzed, so it is neither cached nor
+    // parsed.
+    if (is_snapshot(comp.input)) {
+      Declaration* tu = load_snapshot(cxt, comp.input);
+      generate(opts, comp, cxt, tu);
+      if (comp.output != "-") {
+        write_output(comp.output, comp.text);
+        comp.text.clear();
+      }
+      return;
+    }
+
+    // The input file.
+    const File& input = cxt.get_source_manager().add_file(comp.input);
+
+    // The module is named after its input, so that is part of the key.
+    std::string config;
+    bool cached = opts.cache && !opts.interface && !opts.emit_interface && !opts.emit_snapshot;
+    if (cached) {
+      config = opts.cache_config + ";input=" + comp.input;
+      std::string out;
+      if (opts.cache->lookup(config, input.get_text(), out)) {
+        if (comp.output != "-")
+          write_output(comp.output, out);
+        else
+          comp.text = out;
+        return;
+      }
+    }
+
+    // Run the parser.
+    //
+    // FIXME: Can we make this a single declaration? Probably not because of
+    // the sharing.
+    Parse_context pc(cxt, input, opts.lex_jobs);
+    Module_parser mp(pc, opts.parse_jobs);
+    mp.skip_function_bodies(opts.interface || opts.skip_bodies);
+    Declaration* tu = mp.parse_module();
+    // tu->dump();
+
+    // Parse the skipped function bodies, unless only the interface is
+    // needed. With one parsing job, each body is requested in turn, as by a
+    // client that needs only some of them. Otherwise, they are parsed
+    // together.
+    if (opts.skip_bodies && !opts.interface) {
+      if (opts.parse_jobs > 1) {
+        mp.parse_function_bodies();
+      }
+      else {
+        for (Declaration* d : static_cast<Translation_unit*>(tu)->get_declarations()) {
+          if (mp.has_skipped_body(d))
+            mp.parse_function_body(d);
+        }
+      }
+    }
+
+    // The syntax trees are complete, so report their size before any
+    // translation that might fail.
+    if (opts.memory_report) {
+      std::stringstream ss;
+      ss << comp.input << ":\n";
+      write_memory_report(ss, cxt, input);
+      comp.stats = ss.str();
+    }
+
+    // The interface is written to the current directory, in a file named
+    // after the input.
+    if (opts.emit_interface) {
+      llvm::SmallString<128> path = llvm::sys::path::filename(comp.input);
+      llvm::sys::path::replace_extension(path, ".bki");
+      std::stringstream ss;
+      write_module_interface(ss, static_cast<Translation_unit*>(tu));
+      write_output(path.str().str(), ss.str());
+    }
+
+    // Likewise the snapshot.
+    if (opts.emit_snapshot) {
+      llvm::SmallString<128> path = llvm::sys::path::filename(comp.input);
+      llvm::sys::path::replace_extension(path, ".bks");
+      std::stringstream ss;
+      write_snapshot(ss, static_cast<Translation_unit*>(tu));
+      write_output(path.str().str(), ss.str());
+    }
+
+    if (opts.interface) {
+      std::stringstream ss;
+      write_interface(ss, tu);
+      if (comp.output != "-")
+        write_output(comp.output, ss.str());
+      else
+        comp.text = ss.str();
+      return;
+    }
+
+    generate(opts, comp, cxt, tu);
+
+    // The output of a module with imports depends on their interfaces, which
+    // are not part of the key.
+    if (cached && static_cast<Translation_unit*>(tu)->get_imports().empty())
+      opts.cache->store(config, input.get_text(), comp.text.data(), comp.text.size());
+
+    if (comp.output != "-") {
+      write_output(comp.output, comp.text);
+      comp.text.clear();
+    }
+  }
+  catch (Source_error& err) {
+    comp.location = err.get_location();
+    comp.error = err.what();
+    comp.failed = true;
+  }
+  catch (std::exception& err) {
+    comp.error = err.what();
+    comp.failed = true;
+  }
+}
+
+/// Compiles each input on a pool of worker threads. Workers claim the next
+/// uncompiled input until none remain.
+static void
+compile_all(const Options& opts, Compilation_seq& comps)
+{
+  std::atomic<std::size_t> next(0);
+  auto work = [&opts, &comps, &next]() {
+    for (;;) {
+      std::size_t n = next++;
+      if (n >= comps.size())
+        return;
+      compile(opts, comps[n]);
+    }
+  };
+
+  unsigned jobs = opts.jobs;
+  if (jobs > comps.size())
+    jobs = comps.size();
+
+  // Don't bother spawning threads for a single job.
+  if (jobs <= 1) {
+    work();
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(jobs);
+  for (unsigned i = 0; i < jobs; ++i)
+    workers.emplace_back(work);
+  for (std::thread& t : workers)
+    t.join();
+}
+
+static void
+usage()
+{
+  std::cerr << "usage: beaker-compile [options] <input-files>\n"
+            << "options:\n"
+            << "  -j <jobs>      compile up to <jobs> files at once\n"
+            << "  -lex-jobs <n>  lex each large file on up to <n> threads\n"
+            << "  -parse-jobs <n>\n"
+            << "                 parse the definitions in each file on up to\n"
+            << "                 <n> threads\n"
+            << "  -o <file>      write output to <file>\n"
+            << "  -O<level>      optimize at level 0, 1, 2, or 3\n"
+            << "  -time-passes   report the time spent in each pass\n"
+            << "  -intern-stats  report the use of the interning tables\n"
+            << "  -memory-report report the memory used by syntax trees\n"
+            << "  -interface     write the declarations of each module without\n"
+            << "                 parsing function bodies\n"
+            << "  -skip-bodies   parse function bodies after the rest of each\n"
+            << "                 module\n"
+            << "  -emit-interface\n"
+            << "                 also write the binary interface of each module\n"
+            << "                 to <name>.bki in the current directory\n"
+            << "  -emit-snapshot\n"
+            << "                 also write a snapshot of the analyzed module\n"
+            << "                 to <name>.bks in the current directory; a\n"
+            << "                 .bks input is compiled without parsing\n"
+            << "  -I <dir>       search <dir> for the interfaces of imported\n"
+            << "                 modules\n"
+            << "  -c             emit an object file\n"
+            << "  -S             emit target assembly\n"
+            << "  -emit-llvm-bc  emit LLVM bitcode\n"
+            << "  -emit-llvm     emit textual LLVM IR (default)\n"
+            << "  -cache-dir <dir>\n"
+            << "                 reuse outputs cached in <dir>\n"
+            << "  -cache-size <n>[K|M|G]\n"
+            << "                 limit the cache to <n> bytes (default 1G)\n"
+            << "  -cache-stats   report cache hits and misses\n";
+}
+
+int
 main(int argc, const char* argv[])
 {
-  if (argc < 2) {
-    std::cerr << "usage: beaker-compile <input-files>\n";
+  Options opts;
+
+  // By default, use one worker per hardware thread.
+  opts.jobs = std::thread::hardware_concurrency();
+  if (opts.jobs == 0)
+    opts.jobs = 1;
+
+  Compilation_seq comps;
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    if (std::strncmp(arg, "-j", 2) == 0) {
+      const char* val = arg + 2;
+      if (*val == 0) {
+        if (++i == argc) {
+          usage();
+          return 1;
+        }
+        val = argv[i];
+      }
+      int n = std::atoi(val);
+      if (n <= 0) {
+        std::cerr << "error: invalid number of jobs '" << val << "'\n";
+        return 1;
+      }
+      opts.jobs = n;
+    }
+    else if (std::strcmp(arg, "-lex-jobs") == 0) {
+      if (++i == argc) {
+        usage();
+        return 1;
+      }
+      int n = std::atoi(argv[i]);
+      if (n <= 0) {
+        std::cerr << "error: invalid number of lexing jobs '" << argv[i] << "'\n";
+        return 1;
+      }
+      opts.lex_jobs = n;
+    }
+    else if (std::strcmp(arg, "-parse-jobs") == 0) {
+      if (++i == argc) {
+        usage();
+        return 1;
+      }
+      int n = std::atoi(argv[i]);
+      if (n <= 0) {
+        std::cerr << "error: invalid number of parsing jobs '" << argv[i] << "'\n";
+        return 1;
+      }
+      opts.parse_jobs = n;
+    }
+    else if (std::strcmp(arg, "-o") == 0) {
+      if (++i == argc) {
+        usage();
+        return 1;
+      }
+      opts.output = argv[i];
+    }
+    else if (std::strcmp(arg, "-O") == 0) {
+      opts.opt_level = Generator::O2;
+    }
+    else if (std::strcmp(arg, "-O0") == 0) {
+      opts.opt_level = Generator::O0;
+    }
+    else if (std::strcmp(arg, "-O1") == 0) {
+      opts.opt_level = Generator::O1;
+    }
+    else if (std::strcmp(arg, "-O2") == 0) {
+      opts.opt_level = Generator::O2;
+    }
+    else if (std::strcmp(arg, "-O3") == 0) {
+      opts.opt_level = Generator::O3;
+    }
+    else if (std::strcmp(arg, "-time-passes") == 0) {
+      opts.time_passes = true;
+    }
+    else if (std::strcmp(arg, "-intern-stats") == 0) {
+      opts.intern_stats = true;
+    }
+    else if (std::strcmp(arg, "-memory-report") == 0) {
+      opts.memory_report = true;
+    }
+    else if (std::strcmp(arg, "-interface") == 0) {
+      opts.interface = true;
+    }
+    else if (std::strcmp(arg, "-skip-bodies") == 0) {
+      opts.skip_bodies = true;
+    }
+    else if (std::strcmp(arg, "-emit-interface") == 0) {
+      opts.emit_interface = true;
+    }
+    else if (std::strcmp(arg, "-emit-snapshot") == 0) {
+      opts.emit_snapshot = true;
+    }
+    else if (std::strcmp(arg, "-I") == 0) {
+      if (++i == argc) {
+        usage();
+        return 1;
+      }
+      opts.import_dirs.push_back(argv[i]);
+    }
+    else if (std::strcmp(arg, "-c") == 0) {
+      opts.output_kind = Generator::object_output;
+    }
+    else if (std::strcmp(arg, "-S") == 0) {
+      opts.output_kind = Generator::assembly_output;
+    }
+    else if (std::strcmp(arg, "-emit-llvm-bc") == 0) {
+      opts.output_kind = Generator::bitcode_output;
+    }
+    else if (std::strcmp(arg, "-emit-llvm") == 0) {
+      opts.output_kind = Generator::ir_output;
+    }
+    else if (std::strcmp(arg, "-cache-dir") == 0) {
+      if (++i == argc) {
+        usage();
+        return 1;
+      }
+      opts.cache_dir = argv[i];
+    }
+    else if (std::strcmp(arg, "-cache-size") == 0) {
+      if (++i == argc) {
+        usage();
+        return 1;
+      }
+      opts.cache_size = parse_size(argv[i]);
+      if (opts.cache_size == 0) {
+        std::cerr << "error: invalid cache size '" << argv[i] << "'\n";
+        return 1;
+      }
+    }
+    else if (std::strcmp(arg, "-cache-stats") == 0) {
+      opts.cache_stats = true;
+    }
+    else if (arg[0] == '-' && arg[1] != 0) {
+      std::cerr << "error: unknown option '" << arg << "'\n";
+      return 1;
+    }
+    else {
+      comps.emplace_back();
+      comps.back().input = arg;
+    }
+  }
+
+  if (comps.empty()) {
+    usage();
+    return 1;
+  }
+  if (!opts.output.empty() && comps.size() > 1) {
+    std::cerr << "error: cannot specify -o with multiple input files\n";
     return 1;
   }
-  
-  // The global translation context.
-  Context cxt;
-  
-  // The input file.
-  //
-  // FIXME: Register the input file with the context.
-  File input(argv[1]);
-
-  // Run the parser.
-  //
-  // FIXME: Can we make this a single declaration? Probably not because of
-  // the sharing.
-  Parse_context pc(cxt, input);
-  Module_parser mp(pc);
-  Declaration* tu = mp.parse_module();
-  // tu->dump();
 
-  Generator gen(cxt);
-  gen.generate_module(tu);
+  for (Compilation& comp : comps)
+    comp.output = get_output_path(opts, comp.input);
+
+  std::unique_ptr<Compilation_cache> cache;
+  if (!opts.cache_dir.empty()) {
+    try {
+      cache.reset(new Compilation_cache(opts.cache_dir, opts.cache_size));
+    }
+    catch (std::exception& err) {
+      std::cerr << "error: " << err.what() << '\n';
+      return 1;
+    }
+    opts.cache = cache.get();
+    opts.cache_config = get_cache_config(opts, argv[0]);
+  }
+
+  compile_all(opts, comps);
+
+  // Report results in the order the inputs were given, regardless of the
+  // order in which they were compiled.
+  int status = 0;
+  for (const Compilation& comp : comps) {
+    std::cerr << comp.timing << comp.stats;
+    if (comp.failed) {
+      const std::string& where = comp.location.empty() ? comp.input : comp.location;
+      std::cerr << where << ": error: " << comp.error << '\n';
+      status = 1;
+      continue;
+    }
+    llvm::outs() << comp.text;
+  }
+
+  if (cache) {
+    cache->trim();
+    if (opts.cache_stats) {
+      Cache_statistics stats = cache->get_statistics();
+      std::cerr << "cache: " << stats.hits << " hits, " 
+                << stats.misses << " misses, "
+                << stats.stores << " stores, "
+                << stats.evictions << " evictions, "
+                << stats.size << " of " << cache->get_limit() << " bytes used\n";
+    }
+  }
+  return status;
 }
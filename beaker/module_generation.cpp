@@ -11,9 +11,7 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/IRBuilder.h>
-#include <llvm/Support/raw_ostream.h>
-
-#include <iostream>
+#include <llvm/Target/TargetMachine.h>
 
 namespace beaker
 {
@@ -40,11 +38,22 @@ namespace beaker
     m_globals.emplace(d, c);
   }
 
+  /// Declarations imported from other modules are declared in the module
+  /// when they are first used. Declarations of this module that are used
+  /// before their definitions are generated at their first use.
   llvm::Constant*
   Module_context::lookup(const Typed_declaration* d)
   {
-    assert(m_globals.count(d) != 0);
-    return m_globals.find(d)->second;
+    auto iter = m_globals.find(d);
+    if (iter != m_globals.end())
+      return iter->second;
+    if (!d->is_imported()) {
+      generate_global(d);
+      return m_globals.find(d)->second;
+    }
+    llvm::Constant* c = generate_import(d);
+    m_globals.emplace(d, c);
+    return c;
   }
 
   llvm::Function*
@@ -138,24 +147,25 @@ namespace beaker
   }
 
   void
-  Module_context::generate_module(const Translation_unit* d)
+  Module_context::generate_module(const Translation_unit* d, 
+                                  const std::string& name)
   { 
     assert(!m_llvm);
 
-    // Create the module.
-    //
-    // FIXME: The name of the output file depends on configuration.
-    m_llvm = new llvm::Module("a.ll", *get_llvm_context());
+    // Create the module and configure it for the target.
+    m_llvm = new llvm::Module(name, *get_llvm_context());
+    llvm::TargetMachine* tm = get_global_context().get_target_machine();
+    m_llvm->setTargetTriple(tm->getTargetTriple().str());
+    m_llvm->setDataLayout(tm->createDataLayout());
     
-    // Generate top-level declarations.
-    for (const Declaration* tld : d->get_declarations())
+    // Generate top-level declarations. Global data is initialized
+    // statically, so the module has no constructors.
+    for (const Declaration* tld : d->get_declarations()) {
+      // Skip declarations already generated by an earlier use.
+      if (tld->is_typed() && m_globals.count(static_cast<const Typed_declaration*>(tld)))
+        continue;
       generate_global(tld);
-
-    // Generate global ctors and dtors.
-    generate_constructors();
-    
-    // FIXME: Actually write the module into an output file.
-    llvm::outs() << *m_llvm;
+    }
   }
 
   void
@@ -169,6 +179,14 @@ namespace beaker
 
     case Declaration::func_kind:
       return generate_function(static_cast<const Function_declaration*>(d));
+
+    case Declaration::import_kind:
+      // Imported declarations are generated when used.
+      return;
+
+    case Declaration::assert_kind:
+      // Assertions at namespace scope are checked during analysis.
+      return;
     
     default:
       break;
@@ -190,70 +208,26 @@ namespace beaker
     fn.generate(d);
   }
 
-  void
-  Module_context::add_constructor(const Variable_declaration* d)
-  {
-    m_ctors.push_back(d);
-  }
-
-  llvm::Function*
-  Module_context::generate_constructor(const Variable_declaration* d, std::size_t n)
-  {
-    // Generate the declaration. Note that the name is based on index and
-    // not the name of the declaration.
-    std::string name = "__bkr_global_var_init_" + std::to_string(n) + "__";
-    llvm::FunctionType* type = get_llvm_void_function_type();
-    llvm::Function* fn = make_internal_function(name, type);
-
-    // Generate the function definition.
-    Function_context cxt(*this, fn);
-    cxt.generate_definition(d->get_initializer());
-
-    return fn;
-  }
-
-  void
-  Module_context::generate_constructors()
+  /// Generates an external declaration of a function or variable defined
+  /// in another module.
+  llvm::Constant*
+  Module_context::generate_import(const Typed_declaration* d)
   {
-    if (m_ctors.empty())
-      return;
-
-    // Generate the constructors.
-    std::vector<llvm::Function*> ctors;
-    ctors.reserve(m_ctors.size());
-    for (const Variable_declaration* d : m_ctors) {
-      llvm::Function* ctor = generate_constructor(d, ctors.size());
-      ctors.push_back(ctor);
+    std::string name = generate_external_name(d);
+    llvm::Type* type = generate_type(d);
+    switch (d->get_kind()) {
+    case Declaration::func_kind: {
+      llvm::Type* fn = type->getPointerElementType();
+      return make_external_function(name, llvm::cast<llvm::FunctionType>(fn));
     }
-
-    // FIXME: Are there any other constructors to initialize?
-
-    // Generate the global variable initialization function.
-    std::string name = "__bkr_global_vars_init__";
-    llvm::FunctionType* type = get_llvm_void_function_type();
-    llvm::Function* fn = make_internal_function(name, type);
-
-    // Generate the definition as a sequence of calls to constructors.
-    Function_context cxt(*this, fn);
-    cxt.start_definition();
-    llvm::IRBuilder<> ir(cxt.get_current_block());
-    for (llvm::Function* ctor : ctors) {
-      ir.CreateCall(ctor, llvm::None);
+    case Declaration::var_kind: {
+      auto link = llvm::GlobalValue::ExternalLinkage;
+      return new llvm::GlobalVariable(*m_llvm, type, false, link, nullptr, name);
     }
-    ir.CreateRetVoid();
-    cxt.finish_definition();
-
-    /// Build the initializer for the global constructors.
-    llvm::Constant* elems[] {
-      get_llvm_int(get_llvm_i32_type(), 1 << 16),
-      fn,
-      get_llvm_null_byte_pointer()
-    };
-    llvm::Constant* inits[] { 
-      get_llvm_struct(get_llvm_global_xtor_type(), elems)
-    };
-    llvm::Constant* init = get_llvm_array(inits);
-    make_llvm_global_ctors(init);
+    default:
+      break;
+    }
+    __builtin_unreachable();
   }
 
 } // namespace beaker
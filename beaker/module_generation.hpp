@@ -96,8 +96,9 @@ namespace beaker
     /// Generate a constant from an object.
     llvm::Constant* generate_constant(const Object* o);
 
-    /// Recursively generate the contents of the translation unit.
-    void generate_module(const Translation_unit* tu);
+    /// Recursively generate the contents of the translation unit into a
+    /// new module with the given name.
+    void generate_module(const Translation_unit* tu, const std::string& name);
 
     /// Generates code corresponding for the declaration `d`.
     void generate_global(const Declaration* d);
@@ -108,27 +109,8 @@ namespace beaker
     /// Generates a function.
     void generate_function(const Function_declaration* d);
 
-    // Functions
-
-    /// Returns a function that acts as a constructor for the module. This
-    /// will also append the function to the list of constructors for the
-    /// module.
-    llvm::Function* get_constructor(const char* name);
-
-    // Constructors and destructors
-
-    /// Called by variable initialization to generate a dynamic initialization
-    /// function for given global variable.
-    void add_constructor(const Variable_declaration* d);
-
-    /// Generates a dynamic initialization function.
-    llvm::Function* generate_constructor(const Variable_declaration* d, std::size_t);
-
-    /// Generates the constructors for the module.
-    void generate_constructors();
-
-    /// Generates the initializer for the llvm.global.ctors module.
-    llvm::Constant* generate_constructors(const std::vector<llvm::Function*>& fns);
+    /// Generates the declaration of an imported function or variable.
+    llvm::Constant* generate_import(const Typed_declaration* d);
 
   private:
     /// The parent context.
@@ -139,9 +121,6 @@ namespace beaker
 
     /// Global name bindings.
     Global_map m_globals;
-
-    /// The list of global variables requiring global initialization.
-    std::vector<const Variable_declaration*> m_ctors;
   };
 
 } // namespace beaker
@@ -0,0 +1,399 @@
+#include "module_interface.hpp"
+#include "declaration.hpp"
+#include "type.hpp"
+#include "context.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace beaker
+{
+  namespace
+  {
+    /// The extension of interface files.
+    constexpr const char* interface_extension = ".bki";
+
+    /// Identifies interface files.
+    constexpr char interface_magic[4] = {'B', 'K', 'I', 0};
+
+    /// The version of the interface format. This is stored in the byte
+    /// order of the host, so a file written on a host of different byte
+    /// order is rejected as being of the wrong version.
+    constexpr std::uint32_t interface_version = 2;
+
+    /// The header of an interface file. The header is followed by the type
+    /// records, the operand lists, the declaration records, and the name
+    /// spellings, in that order. Every record is 4-byte aligned.
+    struct Interface_header
+    {
+      char magic[4];
+      std::uint32_t version;
+
+      /// The number of type records.
+      std::uint32_t types;
+
+      /// The number of entries in the operand lists.
+      std::uint32_t lists;
+
+      /// The number of declaration records.
+      std::uint32_t decls;
+
+      /// The number of characters in the name spellings.
+      std::uint32_t strings;
+    };
+
+    /// Describes a type. A reference type names its object type in `first`.
+    /// A function type has `count` parameter types, followed by its return
+    /// type, in the operand lists starting at `first`. Operands are the
+    /// indexes of earlier types.
+    struct Type_record
+    {
+      std::uint32_t kind;
+      std::uint32_t first;
+      std::uint32_t count;
+    };
+
+    /// Describes an exported declaration.
+    struct Declaration_record
+    {
+      /// The offset of the name's spelling.
+      std::uint32_t name;
+
+      /// The length of the name's spelling.
+      std::uint32_t length;
+
+      /// The kind of declaration.
+      std::uint32_t kind;
+
+      /// The index of the declaration's type.
+      std::uint32_t type;
+    };
+
+    /// Compares the `n1` characters at `s1` with the `n2` characters at
+    /// `s2` lexicographically. Declarations are sorted in this order.
+    int
+    compare_names(const char* s1, std::size_t n1, const char* s2, std::size_t n2)
+    {
+      if (int cmp = std::memcmp(s1, s2, std::min(n1, n2)))
+        return cmp;
+      return n1 < n2 ? -1 : n1 > n2;
+    }
+
+
+    /// Accumulates the tables of an interface file.
+    class Interface_writer
+    {
+    public:
+      std::uint32_t add_type(const Type* t);
+      void add_declaration(const Typed_declaration* d);
+      void write(std::ostream& os);
+
+    private:
+      /// The index of each type in the table.
+      std::unordered_map<const Type*, std::uint32_t> m_index;
+
+      std::vector<Type_record> m_types;
+      std::vector<std::uint32_t> m_lists;
+      std::vector<Declaration_record> m_decls;
+      std::string m_strings;
+    };
+
+    /// Adds `t` to the table after its operands, unless it is already
+    /// there. Returns the index of `t`.
+    std::uint32_t
+    Interface_writer::add_type(const Type* t)
+    {
+      auto iter = m_index.find(t);
+      if (iter != m_index.end())
+        return iter->second;
+
+      Type_record r {std::uint32_t(t->get_kind()), 0, 0};
+      switch (t->get_kind()) {
+      case Type::ref_kind:
+        r.first = add_type(static_cast<const Reference_type*>(t)->get_object_type());
+        break;
+
+      case Type::func_kind: {
+        const Function_type* f = static_cast<const Function_type*>(t);
+        std::vector<std::uint32_t> ops;
+        for (const Type* p : f->get_parameter_types())
+          ops.push_back(add_type(p));
+        ops.push_back(add_type(f->get_return_type()));
+        r.first = m_lists.size();
+        r.count = ops.size() - 1;
+        m_lists.insert(m_lists.end(), ops.begin(), ops.end());
+        break;
+      }
+
+      default:
+        break;
+      }
+
+      std::uint32_t n = m_types.size();
+      m_types.push_back(r);
+      m_index.emplace(t, n);
+      return n;
+    }
+
+    void
+    Interface_writer::add_declaration(const Typed_declaration* d)
+    {
+      Symbol sym = d->get_name();
+      Declaration_record r {
+        std::uint32_t(m_strings.size()),
+        std::uint32_t(sym->size()),
+        std::uint32_t(d->get_kind()),
+        add_type(d->get_type())
+      };
+      m_strings.append(sym->data(), sym->size());
+      m_decls.push_back(r);
+    }
+
+    template<typename T>
+    void
+    write_table(std::ostream& os, const std::vector<T>& v)
+    {
+      os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+
+    /// Writes the file. The declarations are sorted by name so that they
+    /// can be found by binary search.
+    void
+    Interface_writer::write(std::ostream& os)
+    {
+      const char* strs = m_strings.data();
+      std::sort(m_decls.begin(), m_decls.end(),
+        [strs](const Declaration_record& a, const Declaration_record& b) {
+          return compare_names(strs + a.name, a.length, strs + b.name, b.length) < 0;
+        });
+
+      // Pad the spellings so that files are a multiple of 4 bytes.
+      m_strings.resize((m_strings.size() + 3) & ~std::size_t(3));
+
+      Interface_header h;
+      std::memcpy(h.magic, interface_magic, sizeof(h.magic));
+      h.version = interface_version;
+      h.types = m_types.size();
+      h.lists = m_lists.size();
+      h.decls = m_decls.size();
+      h.strings = m_strings.size();
+      os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+      write_table(os, m_types);
+      write_table(os, m_lists);
+      write_table(os, m_decls);
+      os.write(m_strings.data(), m_strings.size());
+    }
+
+  } // namespace
+
+  void
+  write_module_interface(std::ostream& os, const Translation_unit* tu)
+  {
+    Interface_writer w;
+    for (const Declaration* d : tu->get_declarations()) {
+      switch (d->get_kind()) {
+      case Declaration::func_kind:
+      case Declaration::var_kind:
+        w.add_declaration(static_cast<const Typed_declaration*>(d));
+        break;
+      default:
+        break;
+      }
+    }
+    w.write(os);
+  }
+
+  std::string
+  find_module_interface(const std::vector<std::string>& dirs,
+                        const std::string& name)
+  {
+    for (const std::string& dir : dirs) {
+      std::string path = dir.empty() ? name : dir + '/' + name;
+      path += interface_extension;
+      if (::access(path.c_str(), R_OK) == 0)
+        return path;
+    }
+    return std::string();
+  }
+
+  /// Only the header is read. The sizes it gives must account for the
+  /// whole file.
+  Module_interface::Module_interface(const std::string& path)
+    : m_file(path),
+      m_types(), m_type_count(),
+      m_lists(), m_list_count(),
+      m_decls(), m_decl_count(),
+      m_strings(), m_string_count()
+  {
+    Text_view text = m_file.get_text();
+    if (text.size() < sizeof(Interface_header))
+      invalid();
+    assert(reinterpret_cast<std::uintptr_t>(text.data()) % 4 == 0);
+
+    const Interface_header* h = reinterpret_cast<const Interface_header*>(text.data());
+    if (std::memcmp(h->magic, interface_magic, sizeof(h->magic)) != 0)
+      invalid();
+    if (h->version != interface_version)
+      invalid();
+
+    std::uint64_t size = sizeof(Interface_header)
+                       + std::uint64_t(h->types) * sizeof(Type_record)
+                       + std::uint64_t(h->lists) * sizeof(std::uint32_t)
+                       + std::uint64_t(h->decls) * sizeof(Declaration_record)
+                       + h->strings;
+    if (size != text.size())
+      invalid();
+
+    const char* p = text.data() + sizeof(Interface_header);
+    m_types = p;
+    m_type_count = h->types;
+    p += h->types * sizeof(Type_record);
+    m_lists = reinterpret_cast<const std::uint32_t*>(p);
+    m_list_count = h->lists;
+    p += h->lists * sizeof(std::uint32_t);
+    m_decls = p;
+    m_decl_count = h->decls;
+    p += h->decls * sizeof(Declaration_record);
+    m_strings = p;
+    m_string_count = h->strings;
+  }
+
+  /// Returns the index of the declaration of `sym`, or the number of
+  /// declarations if there is none.
+  std::uint32_t
+  Module_interface::find(Symbol sym) const
+  {
+    const Declaration_record* decls = static_cast<const Declaration_record*>(m_decls);
+    std::uint32_t lo = 0;
+    std::uint32_t hi = m_decl_count;
+    while (lo < hi) {
+      std::uint32_t mid = lo + (hi - lo) / 2;
+      const Declaration_record& r = decls[mid];
+      if (r.name > m_string_count || r.length > m_string_count - r.name)
+        invalid();
+      int cmp = compare_names(m_strings + r.name, r.length, sym->data(), sym->size());
+      if (cmp == 0)
+        return mid;
+      if (cmp < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return m_decl_count;
+  }
+
+  Named_declaration*
+  Module_interface::load_declaration(Context& cxt,
+                                     Import_declaration* owner,
+                                     Symbol sym)
+  {
+    std::uint32_t n = find(sym);
+    if (n == m_decl_count)
+      return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto iter = m_loaded_decls.find(n);
+    if (iter != m_loaded_decls.end())
+      return iter->second;
+
+    const Declaration_record& r = static_cast<const Declaration_record*>(m_decls)[n];
+    Type* t = load_type(cxt, r.type);
+    Named_declaration* d;
+    switch (r.kind) {
+    case Declaration::func_kind: {
+      if (!t->is_function())
+        invalid();
+      auto* fn = cxt.make<Function_declaration>(owner, sym, Location(), Location());
+      fn->set_type(static_cast<Function_type*>(t));
+      d = fn;
+      break;
+    }
+
+    case Declaration::var_kind: {
+      if (t->is_function() || t->is_auto())
+        invalid();
+      auto* var = cxt.make<Variable_declaration>(owner, sym, Location(), Location());
+      var->set_type(t);
+      d = var;
+      break;
+    }
+
+    default:
+      invalid();
+    }
+
+    m_loaded_decls.emplace(n, d);
+    return d;
+  }
+
+  /// Returns the nth type in the table, loading its operands first.
+  Type*
+  Module_interface::load_type(Context& cxt, std::uint32_t n)
+  {
+    if (n >= m_type_count)
+      invalid();
+    auto iter = m_loaded_types.find(n);
+    if (iter != m_loaded_types.end())
+      return iter->second;
+
+    const Type_record& r = static_cast<const Type_record*>(m_types)[n];
+    Type* t;
+    switch (r.kind) {
+    case Type::unit_kind:
+      t = cxt.get_unit_type();
+      break;
+    case Type::bool_kind:
+      t = cxt.get_bool_type();
+      break;
+    case Type::int_kind:
+      t = cxt.get_int_type();
+      break;
+    case Type::float_kind:
+      t = cxt.get_float_type();
+      break;
+
+    case Type::ref_kind:
+      if (r.first >= n)
+        invalid();
+      t = cxt.get_reference_type(load_type(cxt, r.first));
+      break;
+
+    case Type::func_kind: {
+      if (r.first > m_list_count || r.count >= m_list_count - r.first)
+        invalid();
+      const std::uint32_t* ops = m_lists + r.first;
+      Type_seq parms;
+      parms.reserve(r.count);
+      for (std::uint32_t i = 0; i <= r.count; ++i) {
+        if (ops[i] >= n)
+          invalid();
+        if (i < r.count)
+          parms.push_back(load_type(cxt, ops[i]));
+      }
+      Type* ret = load_type(cxt, ops[r.count]);
+      t = cxt.get_function_type(std::move(parms), ret);
+      break;
+    }
+
+    default:
+      invalid();
+    }
+
+    m_loaded_types.emplace(n, t);
+    return t;
+  }
+
+  void
+  Module_interface::invalid() const
+  {
+    std::stringstream ss;
+    ss << "invalid module interface '" << get_path() << "'";
+    throw std::runtime_error(ss.str());
+  }
+
+} // namespace beaker
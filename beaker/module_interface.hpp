@@ -0,0 +1,105 @@
+#pragma once
+
+#include <beaker/common.hpp>
+#include <beaker/file.hpp>
+#include <beaker/symbol.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace beaker
+{
+  class Translation_unit;
+
+  /// Writes the binary interface of the module `tu` to `os`. The interface
+  /// contains the name and type of each function and variable declared in
+  /// the module. Values and references are not exported, since they have
+  /// no storage; importers would need their initializers.
+  void write_module_interface(std::ostream& os, const Translation_unit* tu);
+
+  /// Returns the path of the interface of the module `name` in the first of
+  /// `dirs` that contains one, or the empty string if none does.
+  std::string find_module_interface(const std::vector<std::string>& dirs,
+                                    const std::string& name);
+
+
+  /// The binary interface of a module, which is mapped into memory.
+  ///
+  /// The interface is a table of types, whose operands precede them, and
+  /// an index of declarations sorted by name. Nothing is read when the
+  /// interface is opened. A declaration and the types it needs are created
+  /// only when its name is first looked up, and records are validated as
+  /// they are read, so the cost of an import is proportional to the number
+  /// of names used rather than the size of the module.
+  ///
+  /// Declarations may be loaded concurrently.
+  class Module_interface
+  {
+  public:
+    /// Opens the interface file at `path`.
+    explicit Module_interface(const std::string& path);
+
+    Module_interface(const Module_interface&) = delete;
+    Module_interface& operator=(const Module_interface&) = delete;
+
+    /// Returns the path of the interface file.
+    const std::string& get_path() const { return m_file.get_path(); }
+
+    /// Returns the number of declarations exported by the module.
+    std::size_t size() const { return m_decl_count; }
+
+    /// Returns the declaration of `sym` exported by the module, or null if
+    /// there is none. The declaration is created in the context, and owned
+    /// by `owner`, the first time it is requested.
+    Named_declaration* load_declaration(Context& cxt,
+                                        Import_declaration* owner,
+                                        Symbol sym);
+
+  private:
+    std::uint32_t find(Symbol sym) const;
+    Type* load_type(Context& cxt, std::uint32_t n);
+
+    [[noreturn]] void invalid() const;
+
+    /// The interface file.
+    File m_file;
+
+    /// The table of types.
+    const void* m_types;
+
+    /// The number of types.
+    std::uint32_t m_type_count;
+
+    /// The operands of function types.
+    const std::uint32_t* m_lists;
+
+    /// The number of operands.
+    std::uint32_t m_list_count;
+
+    /// The table of declarations, sorted by name.
+    const void* m_decls;
+
+    /// The number of declarations.
+    std::uint32_t m_decl_count;
+
+    /// The spellings of declaration names.
+    const char* m_strings;
+
+    /// The number of characters in the spellings.
+    std::uint32_t m_string_count;
+
+    /// The types that have been loaded, by index.
+    std::unordered_map<std::uint32_t, Type*> m_loaded_types;
+
+    /// The declarations that have been loaded, by index.
+    std::unordered_map<std::uint32_t, Named_declaration*> m_loaded_decls;
+
+    /// Guards the loaded types and declarations.
+    std::mutex m_lock;
+  };
+
+} // namespace beaker
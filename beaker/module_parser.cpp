@@ -3,13 +3,24 @@
 #include "expression_parser.hpp"
 #include "function_parser.hpp"
 #include "data_parser.hpp"
+#include "context.hpp"
 
+#include <atomic>
+#include <exception>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 namespace beaker
 {
+  Module_parser::~Module_parser()
+  {
+    for (Deferred_parse* p : m_skipped_bodies)
+      delete p;
+  }
+
   /// module:
   ///   declaration-seq[opt]
   ///
@@ -51,6 +62,8 @@ namespace beaker
   /// declaration:
   ///   function-definition
   ///   variable-definition
+  ///   assertion
+  ///   import-declaration
   Declaration* 
   Module_parser::parse_declaration()
   {
@@ -63,13 +76,15 @@ namespace beaker
       return parse_data_definition();
     case Token::assert_kw:
       return parse_assertion();
+    case Token::import_kw:
+      return parse_import();
     default:
       break;
     }
 
     std::stringstream ss;
-    ss << "expected declaration, but got '" << peek() << "'\n";
-    throw std::runtime_error(ss.str());
+    ss << "expected declaration, but got '" << peek() << "'";
+    syntax_error(ss.str());
   }
 
   static bool
@@ -100,12 +115,12 @@ namespace beaker
     Declaration* data = m_act.on_data_identification(kw, id);
     
     // Consume the tokens denoting the type.
-    Token_seq type = consume_to(Token::equal);
-    defer_data_type(data, std::move(type));
+    Token_range type = consume_to(Token::equal);
+    defer_data_type(data, type);
 
     // Consume the initializer and trailing semicolon.
-    Token_seq init = consume_thru(Token::semicolon);
-    defer_data_initializer(data, std::move(init));
+    Token_range init = consume_thru(Token::semicolon);
+    defer_data_initializer(data, init);
 
     return nullptr;
   }
@@ -125,12 +140,12 @@ namespace beaker
     Declaration* fn = m_act.on_function_identification(kw, id);
 
     // Consume up to the opening brace.
-    Token_seq sig = consume_to(Token::lbrace);
-    defer_function_signature(fn, std::move(sig));
+    Token_range sig = consume_to(Token::lbrace);
+    defer_function_signature(fn, sig);
 
     // Consume the definition.
-    Token_seq def = consume_thru(Token::rbrace);
-    defer_function_definition(fn, std::move(def));
+    Token_range def = consume_thru(Token::rbrace);
+    defer_function_definition(fn, def);
 
     return fn;
   }
@@ -146,28 +161,84 @@ namespace beaker
     return m_act.on_assertion(expr, kw, semi);
   }
 
+  /// import-declaration:
+  ///   'import' identifier ';'
+  Declaration*
+  Module_parser::parse_import()
+  {
+    Token kw = require(Token::import_kw);
+    Token id = match(Token::identifier);
+    Token semi = match(Token::semicolon);
+    return m_act.on_import(kw, id, semi);
+  }
+
+  void
+  Module_parser::defer_data_type(Declaration* d, Token_range toks)
+  {
+    m_deferred_decls.emplace(new Deferred_data_type(d, toks));
+  }
+
+  void
+  Module_parser::defer_data_initializer(Declaration* d, Token_range toks)
+  {
+    m_deferred_defs.push_back(new Deferred_data_initializer(d, toks));
+  }
+
   void
-  Module_parser::defer_data_type(Declaration* d, Token_seq&& toks)
+  Module_parser::defer_function_signature(Declaration* d, Token_range toks)
   {
-    m_deferred_decls.emplace(new Deferred_data_type(m_cxt, d, std::move(toks)));
+    m_deferred_decls.emplace(new Deferred_function_signature(d, toks));
   }
 
+  /// When function bodies are skipped, the body is set aside until it is
+  /// requested.
   void
-  Module_parser::defer_data_initializer(Declaration* d, Token_seq&& toks)
+  Module_parser::defer_function_definition(Declaration* d, Token_range toks)
+  {
+    Deferred_parse* p = new Deferred_function_definition(d, toks);
+    if (m_skip_bodies) {
+      m_skipped_index.emplace(d, m_skipped_bodies.size());
+      m_skipped_bodies.push_back(p);
+      return;
+    }
+    m_deferred_defs.push_back(p);
+  }
+
+  /// Returns true if the body of the function `d` was skipped and has not
+  /// yet been parsed.
+  bool
+  Module_parser::has_skipped_body(const Declaration* d) const
   {
-    m_deferred_defs.emplace(new Deferred_data_initializer(m_cxt, d, std::move(toks)));
+    return m_skipped_index.count(d) != 0;
   }
 
+  /// Parses the skipped body of the function `d`. This has no effect if
+  /// the body has already been parsed.
   void
-  Module_parser::defer_function_signature(Declaration* d, Token_seq&& toks)
+  Module_parser::parse_function_body(Declaration* d)
   {
-    m_deferred_decls.emplace(new Deferred_function_signature(m_cxt, d, std::move(toks)));
+    auto iter = m_skipped_index.find(d);
+    if (iter == m_skipped_index.end())
+      return;
+    std::unique_ptr<Deferred_parse> p(m_skipped_bodies[iter->second]);
+    m_skipped_bodies[iter->second] = nullptr;
+    m_skipped_index.erase(iter);
+    p->parse(m_cxt);
   }
 
+  /// Parses every skipped function body that has not yet been parsed, in
+  /// the same way as the definitions of a full parse.
   void
-  Module_parser::defer_function_definition(Declaration* d, Token_seq&& toks)
+  Module_parser::parse_function_bodies()
   {
-    m_deferred_defs.emplace(new Deferred_function_definition(m_cxt, d, std::move(toks)));
+    for (Deferred_parse*& p : m_skipped_bodies) {
+      if (p)
+        m_deferred_defs.push_back(p);
+      p = nullptr;
+    }
+    m_skipped_bodies.clear();
+    m_skipped_index.clear();
+    parse_deferred_definitions();
   }
 
   void
@@ -176,10 +247,66 @@ namespace beaker
     parse_deferred_actions(m_deferred_decls);
   }
   
+  /// Parses the deferred definitions on up to `m_jobs` threads. Every name
+  /// has been declared with its type, so the definitions are independent of
+  /// each other. Each worker replays definitions in its own parse context,
+  /// and creates nodes in its own arena. Workers claim the next unparsed
+  /// definition until none remain.
+  ///
+  /// Every definition is parsed even if some fail. The error of the first
+  /// failing definition in source order is rethrown, so that diagnostics
+  /// do not depend on the number of threads.
   void
   Module_parser::parse_deferred_definitions()
   {
-    parse_deferred_actions(m_deferred_defs);
+    std::vector<Deferred_parse*> defs;
+    defs.swap(m_deferred_defs);
+    std::vector<std::exception_ptr> errors(defs.size());
+
+    std::atomic<std::size_t> next(0);
+    auto work = [&defs, &errors, &next](Parse_context& cxt) {
+      for (;;) {
+        std::size_t n = next++;
+        if (n >= defs.size())
+          return;
+        try {
+          defs[n]->parse(cxt);
+        }
+        catch (...) {
+          errors[n] = std::current_exception();
+        }
+      }
+    };
+
+    unsigned jobs = m_jobs;
+    if (jobs > defs.size())
+      jobs = defs.size();
+
+    // Don't bother spawning threads for a single job.
+    if (jobs <= 1) {
+      work(m_cxt);
+    }
+    else {
+      Context& cxt = m_act.get_context();
+      std::vector<std::thread> workers;
+      workers.reserve(jobs);
+      for (unsigned i = 0; i < jobs; ++i) {
+        workers.emplace_back([this, &cxt, &work]() {
+          Worker_arena arena(cxt);
+          Parse_context pc(m_cxt);
+          work(pc);
+        });
+      }
+      for (std::thread& t : workers)
+        t.join();
+    }
+
+    for (Deferred_parse* p : defs)
+      delete p;
+    for (std::exception_ptr& e : errors) {
+      if (e)
+        std::rethrow_exception(e);
+    }
   }
 
   void
@@ -188,41 +315,57 @@ namespace beaker
     while (!q.empty()) {
       Deferred_parse *p = q.front();
       q.pop();
-      p->parse();
+      p->parse(m_cxt);
       delete p;
     }
   }
 
+  /// Diagnoses the tokens left over when the deferred parse in `p` does not
+  /// consume its entire range.
+  static void
+  finish_deferred_parse(Parser& p)
+  {
+    if (p.next_token_is_not(Token::eof)) {
+      std::stringstream ss;
+      ss << "unexpected '" << p.peek() << "'";
+      p.syntax_error(ss.str());
+    }
+  }
+
   void
-  Deferred_data_type::parse()
+  Deferred_data_type::parse(Parse_context& cxt)
   {
-    Data_parser p(m_cxt);
-    p.inject(m_toks);
+    Data_parser p(cxt);
+    p.replay(m_toks);
     p.parse_deferred_data_type(m_decl);
+    finish_deferred_parse(p);
   }
 
   void
-  Deferred_data_initializer::parse()
+  Deferred_data_initializer::parse(Parse_context& cxt)
   {
-    Data_parser p(m_cxt);
-    p.inject(m_toks);
+    Data_parser p(cxt);
+    p.replay(m_toks);
     p.parse_deferred_data_initializer(m_decl);
+    finish_deferred_parse(p);
   }
 
   void
-  Deferred_function_signature::parse()
+  Deferred_function_signature::parse(Parse_context& cxt)
   {
-    Function_parser p(m_cxt);
-    p.inject(m_toks);
+    Function_parser p(cxt);
+    p.replay(m_toks);
     p.parse_deferred_function_signature(m_decl);
+    finish_deferred_parse(p);
   }
 
   void
-  Deferred_function_definition::parse()
+  Deferred_function_definition::parse(Parse_context& cxt)
   {
-    Function_parser p(m_cxt);
-    p.inject(m_toks);
+    Function_parser p(cxt);
+    p.replay(m_toks);
     p.parse_deferred_function_body(m_decl);
+    finish_deferred_parse(p);
   }
 
 } // namespace beaker
\ No newline at end of file
@@ -3,46 +3,80 @@
 #include <beaker/parser.hpp>
 
 #include <queue>
+#include <unordered_map>
 #include <vector>
 
 namespace beaker
 {
   /// Parses the top-level contents of a module. This is a multi-phase parse.
+  ///
+  /// The definitions parsed in the third phase are independent of each
+  /// other, so they may be parsed concurrently.
+  ///
+  /// When function bodies are skipped, only the interface of the module is
+  /// parsed in the third phase. The tokens of each function body are kept,
+  /// and the body is parsed only when requested. The parse context must
+  /// outlive the parser for this to work.
   class Module_parser : public Parser
   {
   public:
-    Module_parser(Parse_context& cxt)
-      : Parser(cxt)
+    /// Creates a module parser that parses deferred definitions on up to
+    /// `jobs` threads.
+    Module_parser(Parse_context& cxt, unsigned jobs = 1)
+      : Parser(cxt), m_jobs(jobs), m_skip_bodies(false)
     { }
 
+    ~Module_parser();
+
+    /// Determines whether function bodies are parsed with the module.
+    void skip_function_bodies(bool b) { m_skip_bodies = b; }
+
     Declaration* parse_module();  
 
+    bool has_skipped_body(const Declaration* d) const;
+    void parse_function_body(Declaration* d);
+    void parse_function_bodies();
+
     Declaration* parse_declaration();
     Declaration_seq parse_declaration_seq();
     Declaration* parse_data_definition();
     Declaration* parse_function_definition();
     Declaration* parse_assertion();
+    Declaration* parse_import();
 
   private:
-    void defer_data_type(Declaration* d, Token_seq&& toks);
-    void defer_data_initializer(Declaration* d, Token_seq&& toks);
-    void defer_function_signature(Declaration* d, Token_seq&& toks);
-    void defer_function_definition(Declaration* d, Token_seq&& toks);
+    void defer_data_type(Declaration* d, Token_range toks);
+    void defer_data_initializer(Declaration* d, Token_range toks);
+    void defer_function_signature(Declaration* d, Token_range toks);
+    void defer_function_definition(Declaration* d, Token_range toks);
 
     void parse_deferred_declarations();
     void parse_deferred_definitions();
     void parse_deferred_actions(std::queue<Deferred_parse*>& q);
 
   private:
+    /// The maximum number of threads used to parse deferred definitions.
+    unsigned m_jobs;
+
     /// A queue of deferred parsing actions, which is used to parse the
     /// types of functions and variables. This represents the second pass
     /// over the input after we have established the kind of each name.
     std::queue<Deferred_parse*> m_deferred_decls;
 
-    /// A queue of deferred parsing actions, which is used to parse the
+    /// A list of deferred parsing actions, which is used to parse the
     /// definitions of functions and variables. This represents the third
     /// pass over the input after we have established the type of each name.
-    std::queue<Deferred_parse*> m_deferred_defs;
+    std::vector<Deferred_parse*> m_deferred_defs;
+
+    /// True if function bodies are not parsed with the module.
+    bool m_skip_bodies;
+
+    /// The skipped function bodies in source order. An entry is null once
+    /// its body has been parsed.
+    std::vector<Deferred_parse*> m_skipped_bodies;
+
+    /// Maps each function to the index of its skipped body.
+    std::unordered_map<const Declaration*, std::size_t> m_skipped_index;
   };
 
 
@@ -50,13 +84,9 @@ namespace beaker
   class Deferred_module_parse : public Deferred_parse
   {
   public:
-    Deferred_module_parse(Parse_context& cxt, Declaration* d, Token_seq&& toks)
-      : Deferred_parse(d, std::move(toks)), m_cxt(cxt)
+    Deferred_module_parse(Declaration* d, Token_range toks)
+      : Deferred_parse(d, toks)
     { }
-
-  protected:
-    /// The shared parse state.
-    Parse_context& m_cxt;
   };
 
 
@@ -66,7 +96,7 @@ namespace beaker
   public:
     using Deferred_module_parse::Deferred_module_parse;
 
-    void parse() override;
+    void parse(Parse_context& cxt) override;
   };
 
 
@@ -76,7 +106,7 @@ namespace beaker
   public:
     using Deferred_module_parse::Deferred_module_parse;
 
-    void parse() override;
+    void parse(Parse_context& cxt) override;
   };
 
 
@@ -86,7 +116,7 @@ namespace beaker
   public:
     using Deferred_module_parse::Deferred_module_parse;
 
-    void parse() override;
+    void parse(Parse_context& cxt) override;
   };
 
 
@@ -96,7 +126,7 @@ namespace beaker
   public:
     using Deferred_module_parse::Deferred_module_parse;
 
-    void parse() override;
+    void parse(Parse_context& cxt) override;
   };
 
 } // namespace beaker
@@ -1,4 +1,5 @@
 #include "parser.hpp"
+#include "context.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -6,30 +7,36 @@
 
 namespace beaker
 {
-  Parse_context::Parse_context(Context& cxt, const File& f)
-    : m_lex(cxt, f), m_act(cxt), m_tok()
-  {
-    fetch();
-  }
-
+  Parse_context::Parse_context(Context& cxt, const File& f, unsigned jobs)
+    : m_toks(std::make_shared<Token_buffer>(lex_file(cxt, f, jobs))), 
+      m_act(cxt), 
+      m_pos(0), 
+      m_last(m_toks->size() - 1)
+  { }
+
+  Parse_context::Parse_context(const Parse_context& cxt)
+    : m_toks(cxt.m_toks), 
+      m_act(cxt.m_act.get_context()), 
+      m_pos(m_toks->size() - 1), 
+      m_last(m_pos)
+  { }
+
+  /// Returns the name of the lookahead token. At the end of the replayed
+  /// range, this is end-of-file, as for peek().
   Token::Name
   Parse_context::lookahead()
   {
-    assert(!m_tok.empty());
-    return m_tok.front().get_name();
+    if (m_pos == m_last)
+      return Token::eof;
+    return m_toks->get_name(m_pos);
   }
 
   Token::Name
   Parse_context::lookahead(int n)
   {
-    if (n < m_tok.size())
-      return m_tok[n].get_name();
-    n = n - m_tok.size() + 1;
-    while (n != 0) {
-      fetch();
-      --n;
-    }
-    return m_tok.back().get_name();
+    if ((std::size_t)n < m_last - m_pos)
+      return m_toks->get_name(m_pos + n);
+    return Token::eof;
   }
 
   bool
@@ -80,7 +87,7 @@ namespace beaker
     std::stringstream ss;
     ss << "expected '" << Token::get_token_spelling(n)
        << "' but got '" << peek() << "'";
-    throw std::runtime_error(ss.str());
+    syntax_error(ss.str());
   }
 
   /// If lookahead matches n, then accept the token and update. Otherwise, 
@@ -101,43 +108,52 @@ namespace beaker
     return consume();
   }
 
-  /// Consumes the current token, returning it.
+  /// Consumes the current token, returning it. The end-of-file token is
+  /// never consumed.
   Token
   Parse_context::consume()
   {
     Token tok = peek();
-    m_tok.pop_front();
-    if (m_tok.empty())
-      fetch();
+    if (m_pos != m_last)
+      ++m_pos;
     return tok;
   }
 
-  const Token&
+  /// Returns the lookahead token. At the end of the replayed range, this is
+  /// an end-of-file token at the location of the token that follows it.
+  Token
   Parse_context::peek()
   {
-    assert(!m_tok.empty());
-    return m_tok.front();
+    if (m_pos == m_last)
+      return Token(Token::eof, m_toks->get_location(m_pos));
+    return m_toks->get_token(m_pos);
   }
 
-  void
-  Parse_context::fetch()
+  static bool
+  is_closing(Token::Name n)
   {
-    m_tok.push_back(m_lex());
+    return n == Token::rparen || n == Token::rbrace || n == Token::rbracket;
   }
 
   /// Consume tokens until we reach the next non-nested token with name `n`.
-  /// That matching token is not consumed.
+  /// That matching token is not consumed. Returns the range of consumed
+  /// tokens.
   ///
   /// A nested token is one that occurs within parentheses, braces, or 
   /// brackets. For example, given a sequence "{ expr; } expr;", 
   /// `consume_to(Token::semicolon` will match the last semicolon, not the
-  /// first.
-  void
-  Parse_context::consume_to(Token_seq& toks, Token::Name n)
+  /// first. If `n` is a closing token, the match may also be the one that
+  /// closes the outermost group, as in "{ { } }" for `Token::rbrace`.
+  Token_range
+  Parse_context::consume_to(Token::Name n)
   {
+    std::size_t first = m_pos;
     int nesting = 0;
-    while (next_token_is_not(n)) {
-      switch (lookahead()) {
+    while (m_pos != m_last) {
+      Token::Name k = m_toks->get_name(m_pos);
+      if (k == n && (nesting == 0 || (nesting == 1 && is_closing(n))))
+        break;
+      switch (k) {
       default:
         break;
       case Token::lparen:
@@ -152,41 +168,36 @@ namespace beaker
         --nesting;
         break;
       }
-      toks.push_back(consume());
+      ++m_pos;
     }
-    assert(next_token_is(n));
+    return {first, m_pos};
   }
 
   /// Consume all of the tokens up to and including `n`.
-  void
-  Parse_context::consume_thru(Token_seq& toks, Token::Name n)
-  {
-    consume_to(toks, n);
-    toks.push_back(consume());
-  }
-
-  Token_seq
-  Parse_context::consume_to(Token::Name n)
+  Token_range
+  Parse_context::consume_thru(Token::Name n)
   {
-    Token_seq toks;
-    consume_to(toks, n);
-    return toks;
+    Token_range toks = consume_to(n);
+    consume();
+    return {toks.begin, m_pos};
   }
 
-  Token_seq
-  Parse_context::consume_thru(Token::Name n)
+  /// Makes `toks` the remaining tokens of the input. This is used to parse
+  /// the tokens previously consumed by a deferred parse.
+  void
+  Parse_context::replay(Token_range toks)
   {
-    Token_seq toks;
-    consume_thru(toks, n);
-    return toks;
+    assert(toks.end < m_toks->size());
+    m_pos = toks.begin;
+    m_last = toks.end;
   }
 
-  /// Insert the tokens into the token stream so that they are the next
-  /// tokens lexed.
   void
-  Parse_context::inject(const Token_seq& toks)
+  Parse_context::syntax_error(const std::string& msg)
   {
-    m_tok.insert(m_tok.begin(), toks.begin(), toks.end());
+    Location loc = peek().get_location();
+    Context& cxt = m_act.get_context();
+    throw Source_error(cxt.get_source_location(loc), msg);
   }
 
   // ------------------------------------------------------------------------ //
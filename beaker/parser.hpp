@@ -4,25 +4,41 @@
 #include <beaker/lexer.hpp>
 #include <beaker/semantics.hpp>
 
-#include <deque>
+#include <memory>
 #include <vector>
 
 namespace beaker
 {
   /// The shared context of all parsers.
+  ///
+  /// The input file is lexed in its entirety when the context is created.
+  /// Parsers walk the resulting token buffer with an index. Deferred parses
+  /// record the range of tokens they consumed and later replay that range.
+  ///
+  /// Deferred parses may be run concurrently, each thread with its own
+  /// parse context. These share the tokens of the original context, but
+  /// each has its own index and semantic actions.
   class Parse_context
   {
   public:
-    Parse_context(Context& cxt, const File& f);
+    /// Creates a parse context for `f`, lexing its contents on up to `jobs`
+    /// threads.
+    Parse_context(Context& cxt, const File& f, unsigned jobs = 1);
 
-    /// Returns the underlying lexer.
-    Lexer& get_lexer() { return m_lex; }
+    /// Creates a parse context that shares the tokens of `cxt`, in which
+    /// deferred parses can be replayed.
+    explicit Parse_context(const Parse_context& cxt);
+
+    Parse_context& operator=(const Parse_context&) = delete;
+
+    /// Returns the tokens of the input file.
+    const Token_buffer& get_tokens() const { return *m_toks; }
 
     /// Returns the semantic actions.
     Semantics &get_semantics() { return m_act; }
 
     /// Returns the lookahead token.
-    const Token& peek();
+    Token peek();
 
     /// Returns the name of the lookahead token.
     Token::Name lookahead();
@@ -54,27 +70,28 @@ namespace beaker
 
     Token consume();
 
-    Token_seq consume_to(Token::Name n);
-    Token_seq consume_thru(Token::Name n);
+    Token_range consume_to(Token::Name n);
+    Token_range consume_thru(Token::Name n);
 
-    void consume_to(Token_seq& toks, Token::Name n);
-    void consume_thru(Token_seq& toks, Token::Name n);
+    void replay(Token_range toks);
 
-    void inject(const Token_seq& toks);
+    /// Throws a syntax error with the message `msg` at the lookahead token.
+    [[noreturn]] void syntax_error(const std::string& msg);
 
   private:
-    void fetch();
+    /// The tokens of the input file, which are shared with the contexts
+    /// of concurrent deferred parses.
+    std::shared_ptr<const Token_buffer> m_toks;
 
-  private:
-    /// The lexer. This returns one token at a time.
-    Lexer m_lex;
-    
     // The semantic actions for parsing.
     Semantics m_act;
 
-    /// Stores the sequence of lookahead tokens. This typically holds a single
-    /// token unless we've looked beyond that.
-    std::deque<Token> m_tok; 
+    /// The index of the lookahead token.
+    std::size_t m_pos;
+
+    /// The index past the last token that can be parsed. Tokens at or after
+    /// this index are seen as the end-of-file.
+    std::size_t m_last;
   };
 
 
@@ -82,19 +99,22 @@ namespace beaker
   class Deferred_parse
   {
   protected:
-    Deferred_parse(Declaration* decl, Token_seq&& toks)
-      : m_decl(decl), m_toks(std::move(toks))
+    Deferred_parse(Declaration* decl, Token_range toks)
+      : m_decl(decl), m_toks(toks)
     { }
 
   public:
     virtual ~Deferred_parse() = default;
 
-    /// Called to invoke the parsing action. 
-    virtual void parse() = 0;
+    /// Called to invoke the parsing action, replaying the tokens in `cxt`.
+    virtual void parse(Parse_context& cxt) = 0;
+
+    /// Returns the declaration whose parse was deferred.
+    Declaration* get_declaration() const { return m_decl; }
 
   protected:
     Declaration* m_decl;
-    Token_seq m_toks;
+    Token_range m_toks;
   };
 
 
@@ -113,7 +133,7 @@ namespace beaker
     Semantics& get_semantics() const { return m_act; }
 
     /// Returns the current token.
-    const Token& peek() { return m_cxt.peek(); }
+    Token peek() { return m_cxt.peek(); }
 
     /// Returns the name of the next token.
     Token::Name lookahead() { return m_cxt.lookahead(); }
@@ -155,19 +175,16 @@ namespace beaker
     Token consume() { return m_cxt.consume(); }
 
     /// Consume tokens up to but not including `n`.
-    Token_seq consume_to(Token::Name n) { return m_cxt.consume_to(n); }
+    Token_range consume_to(Token::Name n) { return m_cxt.consume_to(n); }
 
     /// Consume tokens up to and including `n`.
-    Token_seq consume_thru(Token::Name n) { return m_cxt.consume_thru(n); }
+    Token_range consume_thru(Token::Name n) { return m_cxt.consume_thru(n); }
 
-    /// Consume tokens up to but not including `n`.
-    void consume_to(Token_seq& toks, Token::Name n) { return m_cxt.consume_to(toks, n); }
-    
-    /// Consume tokens up to and including `n`.
-    void consume_thru(Token_seq& toks, Token::Name n)  { return m_cxt.consume_thru(toks, n); }
+    /// Makes `toks` the remaining tokens of the input.
+    void replay(Token_range toks) { return m_cxt.replay(toks); }
 
-    /// Injects tokens into the token stream.
-    void inject(const Token_seq& toks) { return m_cxt.inject(toks); }
+    /// Diagnoses a syntax error at the current token.
+    [[noreturn]] void syntax_error(const std::string& msg) { m_cxt.syntax_error(msg); }
 
   protected:
     /// The shared parse state.
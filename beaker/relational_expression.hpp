@@ -8,6 +8,8 @@ namespace beaker
   class Equal_to_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == eq_kind; }
+
     Equal_to_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(eq_kind, t, lhs, rhs, op)
     { }
@@ -18,6 +20,8 @@ namespace beaker
   class Not_equal_to_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == ne_kind; }
+
     Not_equal_to_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(ne_kind, t, lhs, rhs, op)
     { }
@@ -28,6 +32,8 @@ namespace beaker
   class Less_than_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == lt_kind; }
+
     Less_than_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(lt_kind, t, lhs, rhs, op)
     { }
@@ -38,6 +44,8 @@ namespace beaker
   class Not_less_than_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == nl_kind; }
+
     Not_less_than_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(nl_kind, t, lhs, rhs, op)
     { }
@@ -48,6 +56,8 @@ namespace beaker
   class Greater_than_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == gt_kind; }
+
     Greater_than_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(gt_kind, t, lhs, rhs, op)
     { }
@@ -58,6 +68,8 @@ namespace beaker
   class Not_greater_than_expression : public Binary_operator
   {
   public:
+    static bool classof(const Expression* p) { return p->get_kind() == ng_kind; }
+
     Not_greater_than_expression(Type* t, Expression* lhs, Expression* rhs, const Token& op)
       : Binary_operator(ng_kind, t, lhs, rhs, op)
     { }
@@ -0,0 +1,210 @@
+#include <beaker/context.hpp>
+#include <beaker/file.hpp>
+#include <beaker/module_parser.hpp>
+#include <beaker/declaration.hpp>
+#include <beaker/generation.hpp>
+
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace beaker;
+
+/// Returns the value of `e`, or throws if it holds an error.
+template<typename T>
+static T
+check(llvm::Expected<T> e)
+{
+  if (!e)
+    throw std::runtime_error(llvm::toString(e.takeError()));
+  return std::move(*e);
+}
+
+/// Throws if `err` holds an error.
+static void
+check(llvm::Error err)
+{
+  if (err)
+    throw std::runtime_error(llvm::toString(std::move(err)));
+}
+
+/// The result types supported for entry functions.
+enum Entry_kind
+{
+  unit_entry,
+  bool_entry,
+  int_entry,
+};
+
+/// Verifies that `entry` names a function defined in `mod` that can be
+/// called without arguments and that returns an int, a bool, or nothing.
+static Entry_kind
+check_entry(const llvm::Module& mod, const std::string& entry)
+{
+  const llvm::Function* fn = mod.getFunction(entry);
+  if (!fn || fn->isDeclaration()) {
+    std::stringstream ss;
+    ss << "no definition of entry function '" << entry << "'";
+    throw std::runtime_error(ss.str());
+  }
+  llvm::Type* ret = fn->getReturnType();
+  if (fn->arg_size() != 0 ||
+      !(ret->isVoidTy() || ret->isIntegerTy(1) || ret->isIntegerTy(32))) {
+    std::stringstream ss;
+    ss << "entry function '" << entry << "' must take no arguments and "
+       << "return 'int', 'bool', or 'unit'";
+    throw std::runtime_error(ss.str());
+  }
+  if (ret->isVoidTy())
+    return unit_entry;
+  if (ret->isIntegerTy(1))
+    return bool_entry;
+  return int_entry;
+}
+
+/// Compiles the file at `path` and executes `entry` in a JIT, after
+/// running the module's global constructors. Returns the result of `entry`
+/// as the exit status.
+static int
+run(const std::string& path,
+    const std::string& entry,
+    Generator::Optimization_level opt)
+{
+  // The translation context.
+  Context cxt;
+
+  // The input file.
+  const File& input = cxt.get_source_manager().add_file(path);
+
+  // Run the parser.
+  Parse_context pc(cxt, input);
+  Module_parser mp(pc);
+  Declaration* tu = mp.parse_module();
+
+  // Generate and optimize the module.
+  Generator gen(cxt);
+  gen.generate_module(tu, path);
+  gen.optimize_module(opt);
+  Entry_kind kind = check_entry(*gen.get_module(), entry);
+
+  // The JIT compiles whatever it is given, so never hand it a malformed
+  // module.
+  gen.verify_module();
+
+  // Hand the module and its context over to the JIT.
+  std::unique_ptr<llvm::Module> mod = gen.release_module();
+  llvm::orc::ThreadSafeModule tsm(std::move(mod), gen.release_llvm_context());
+
+  std::unique_ptr<llvm::orc::LLJIT> jit = check(llvm::orc::LLJITBuilder().create());
+  llvm::orc::JITDylib& lib = jit->getMainJITDylib();
+
+  // Resolve external references against the host process.
+  char prefix = jit->getDataLayout().getGlobalPrefix();
+  lib.addGenerator(check(
+    llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(prefix)));
+
+  check(jit->addIRModule(std::move(tsm)));
+
+  // Run the global constructors (i.e., llvm.global_ctors).
+  check(jit->initialize(lib));
+
+  // Call the entry function. An i1 result is only defined in its low bit,
+  // so read it through an 8-bit result and mask the rest.
+  llvm::JITTargetAddress addr = check(jit->lookup(entry)).getAddress();
+  int status = 0;
+  switch (kind) {
+  case unit_entry:
+    reinterpret_cast<void(*)()>(addr)();
+    break;
+  case bool_entry:
+    status = reinterpret_cast<std::uint8_t(*)()>(addr)() & 1;
+    break;
+  case int_entry:
+    status = reinterpret_cast<std::int32_t(*)()>(addr)();
+    break;
+  }
+
+  // Run the global destructors, if any.
+  check(jit->deinitialize(lib));
+  return status;
+}
+
+static void
+usage()
+{
+  std::cerr << "usage: beaker-run [options] <input-file>\n"
+            << "options:\n"
+            << "  -e <name>   call <name> instead of 'main'\n"
+            << "  -O<level>   optimize at level 0, 1, 2, or 3\n";
+}
+
+int
+main(int argc, const char* argv[])
+{
+  std::string entry = "main";
+  Generator::Optimization_level opt = Generator::O0;
+  std::string path;
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "-e") == 0) {
+      if (++i == argc) {
+        usage();
+        return 1;
+      }
+      entry = argv[i];
+    }
+    else if (std::strcmp(arg, "-O") == 0 || std::strcmp(arg, "-O2") == 0) {
+      opt = Generator::O2;
+    }
+    else if (std::strcmp(arg, "-O0") == 0) {
+      opt = Generator::O0;
+    }
+    else if (std::strcmp(arg, "-O1") == 0) {
+      opt = Generator::O1;
+    }
+    else if (std::strcmp(arg, "-O3") == 0) {
+      opt = Generator::O3;
+    }
+    else if (arg[0] == '-' && arg[1] != 0) {
+      std::cerr << "error: unknown option '" << arg << "'\n";
+      return 1;
+    }
+    else if (path.empty()) {
+      path = arg;
+    }
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (path.empty()) {
+    usage();
+    return 1;
+  }
+
+  try {
+    return run(path, entry, opt);
+  }
+  catch (Source_error& err) {
+    const std::string& where = err.get_location().empty() ? path : err.get_location();
+    std::cerr << where << ": error: " << err.what() << '\n';
+    return 1;
+  }
+  catch (std::exception& err) {
+    std::cerr << path << ": error: " << err.what() << '\n';
+    return 1;
+  }
+}
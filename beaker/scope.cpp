@@ -2,5 +2,36 @@
 
 namespace beaker
 {
+  void
+  Block_scope_stack::enter(Statement* s)
+  {
+    m_blocks.push_back({s, std::uint32_t(m_bindings.size())});
+  }
+
+  /// The bindings of the block are popped in reverse order, restoring the
+  /// head of each chain to the binding it hid.
+  void
+  Block_scope_stack::leave()
+  {
+    assert(!m_blocks.empty());
+    std::uint32_t first = m_blocks.back().first;
+    for (std::size_t n = m_bindings.size(); n > first; --n) {
+      const Binding& b = m_bindings[n - 1];
+      m_heads[b.decl->get_name()->id()] = b.hidden;
+    }
+    m_bindings.resize(first);
+    m_blocks.pop_back();
+  }
+
+  void
+  Block_scope_stack::declare(Named_declaration* d)
+  {
+    assert(!m_blocks.empty());
+    std::uint32_t id = d->get_name()->id();
+    if (id >= m_heads.size())
+      m_heads.resize(id + 1);
+    m_bindings.push_back({d, m_heads[id]});
+    m_heads[id] = m_bindings.size();
+  }
 
 } // namespace beaker
@@ -2,6 +2,9 @@
 
 #include "declaration.hpp"
 
+#include <cstdint>
+#include <vector>
+
 namespace beaker
 {
   /// The base class of scope objects. Scopes can be derived in order to
@@ -65,41 +68,105 @@ namespace beaker
   }
 
 
-  /// Represents scopes associated with a statement.
-  class Block_scope : public Scope
+  /// Represents the scopes of the nested blocks of a function body.
+  ///
+  /// Rather than giving each block its own lookup table, every symbol has
+  /// a chain of the declarations of that name visible in the open blocks,
+  /// innermost first. Lookup reads the head of the chain, no matter how
+  /// deeply blocks are nested. The chains are threaded through a single
+  /// stack of bindings, and their heads are kept in a vector indexed by
+  /// symbol id, so entering and leaving blocks allocates nothing once the
+  /// stack has grown.
+  class Block_scope_stack
   {
   public:
-    Block_scope(Statement* s, Scope* p)
-      : Scope(p), m_stmt(s)
-    { }
+    /// Returns true if no block is open.
+    bool is_empty() const { return m_blocks.empty(); }
 
-    /// Returns the underlying statement
-    Statement* get_statement() const { return m_stmt; }
+    /// Returns the innermost open block, or nullptr if there is none.
+    Statement* get_current_block() const;
 
-    /// Search this scope for a declaration.
-    Declaration_set lookup(Symbol sym) const override;
+    /// Opens a scope for the block `s`.
+    void enter(Statement* s);
 
-    /// Registers the declaration for name lookup in this scope.
-    void declare(Named_declaration* d) override;
+    /// Closes the scope of the innermost block. Declarations in that
+    /// block are no longer visible, and the declarations they hide are
+    /// visible again.
+    void leave();
 
-  private:
-    /// The associated statement.
-    Statement* m_stmt;
+    /// Returns the innermost visible declaration of `sym`, or nullptr if
+    /// there is none.
+    Named_declaration* lookup(Symbol sym) const;
+
+    /// Returns the declaration of `sym` in the innermost block, or nullptr
+    /// if there is none.
+    Named_declaration* lookup_current(Symbol sym) const;
+
+    /// Makes `d` visible in the innermost block.
+    void declare(Named_declaration* d);
 
-    /// The set of declarations in this scope.
-    Declaration_map m_lookup;
+  private:
+    /// Makes a declaration visible.
+    struct Binding
+    {
+      /// The declaration.
+      Named_declaration* decl;
+
+      /// One more than the index of the binding hidden by this one, or
+      /// 0 if it hides none.
+      std::uint32_t hidden;
+    };
+
+    /// An open block.
+    struct Block
+    {
+      /// The block statement.
+      Statement* stmt;
+
+      /// The index of the first binding in the block.
+      std::uint32_t first;
+    };
+
+    /// Returns one more than the index of the innermost binding of `sym`,
+    /// or 0 if there is none.
+    std::uint32_t get_head(Symbol sym) const;
+
+    /// The bindings of the open blocks, outermost first.
+    std::vector<Binding> m_bindings;
+
+    /// The open blocks, outermost first.
+    std::vector<Block> m_blocks;
+
+    /// The head of each symbol's chain, indexed by id, as returned by
+    /// get_head(). Symbols beyond the end have no bindings.
+    std::vector<std::uint32_t> m_heads;
   };
 
-  inline Declaration_set 
-  Block_scope::lookup(Symbol sym) const 
-  { 
-    return m_lookup.lookup(sym); 
+  inline Statement*
+  Block_scope_stack::get_current_block() const
+  {
+    return m_blocks.empty() ? nullptr : m_blocks.back().stmt;
   }
-  
-  inline void 
-  Block_scope::declare(Named_declaration* d) 
-  { 
-    m_lookup.declare(d); 
+
+  inline std::uint32_t
+  Block_scope_stack::get_head(Symbol sym) const
+  {
+    return sym->id() < m_heads.size() ? m_heads[sym->id()] : 0;
+  }
+
+  inline Named_declaration*
+  Block_scope_stack::lookup(Symbol sym) const
+  {
+    std::uint32_t n = get_head(sym);
+    return n ? m_bindings[n - 1].decl : nullptr;
+  }
+
+  inline Named_declaration*
+  Block_scope_stack::lookup_current(Symbol sym) const
+  {
+    assert(!m_blocks.empty());
+    std::uint32_t n = get_head(sym);
+    return n > m_blocks.back().first ? m_bindings[n - 1].decl : nullptr;
   }
 
 } // namespace beaker
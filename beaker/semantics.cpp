@@ -8,6 +8,7 @@
 #include "conversion.hpp"
 #include "context.hpp"
 #include "print.hpp"
+#include "module_interface.hpp"
 
 #include <algorithm>
 #include <iostream>
@@ -16,12 +17,13 @@
 namespace beaker
 {
   Semantics::Semantics(Context& cxt)
-    : m_cxt(cxt), m_scope(), m_decl()
+    : m_cxt(cxt), m_scope(), m_blocks(), m_decl()
   { }
 
   Semantics::~Semantics()
   {
     assert(!m_scope); // Imbalanced scope stack
+    assert(m_blocks.is_empty()); // Imbalanced block stack
     assert(!m_decl); // Imbalanced declaration stack
   }
 
@@ -29,6 +31,7 @@ namespace beaker
   Semantics::enter_scope(Declaration* d)
   {
     assert(d->is_scoped());
+    assert(m_blocks.is_empty()); // Declarations are not local.
     assert(m_decl != d->cast_as_scoped()); // Already on the stack.
     
     // Make d the current declaration.
@@ -43,7 +46,7 @@ namespace beaker
   Semantics::enter_scope(Statement* s)
   {
     // Push a new block scope on the stack.
-    m_scope = new Block_scope(s, m_scope);
+    m_blocks.enter(s);
   }
 
   void
@@ -52,6 +55,11 @@ namespace beaker
     assert(d->is_scoped());
     assert(m_decl == d->cast_as_scoped()); // Imbalanced stack
 
+    // Discard block scopes left open by a definition whose parse failed
+    // part way through.
+    while (!m_blocks.is_empty())
+      leave_scope(static_cast<Statement*>(nullptr));
+
     // Pop the current scope.
     //
     // FIXME: Check that the scope also refers to d.
@@ -70,11 +78,8 @@ namespace beaker
   Semantics::leave_scope(Statement* s)
   {
     // FIXME: Check that the scope refers to s.
-    assert(m_scope); // Imbalanced stack
-    
-    Scope* prev = m_scope;
-    m_scope = m_scope->get_parent();
-    delete prev;
+    assert(!m_blocks.is_empty()); // Imbalanced stack
+    m_blocks.leave();
   }
 
   void
@@ -114,33 +119,69 @@ namespace beaker
   Semantics::get_current_function()
   {
     Declaration* d = m_decl->cast_as_declaration();
-    if (auto* fn = dynamic_cast<Function_declaration*>(d))
-      return fn;
-    return nullptr;
+    return dyn_cast<Function_declaration>(d);
   }
 
   Block_statement*
   Semantics::get_current_block()
   {
-    if (auto* bs = dynamic_cast<Block_scope*>(m_scope))
-      return static_cast<Block_statement*>(bs->get_statement());
-    return nullptr;
+    return static_cast<Block_statement*>(m_blocks.get_current_block());
   }
 
   // Lookup
 
-  Declaration_set
+  /// Blocks are searched first, in constant time. Only declarations have
+  /// scopes enclosing the blocks, and they are never nested more than a
+  /// function within the translation unit. Names not declared in the
+  /// translation unit may be declared by an imported module.
+  Named_declaration*
   Semantics::unqualified_lookup(Symbol sym)
   {
+    if (Named_declaration* d = m_blocks.lookup(sym))
+      return d;
     Scope* s = m_scope;
+    Scope* outer = nullptr;
     while (s) {
       Declaration_set decls = s->lookup(sym);
       if (!decls.is_empty())
-        return decls;
+        return decls.get_single_declaration();
+      outer = s;
       s = s->get_parent();
     }
-    return {};
+    if (outer) {
+      auto* ds = static_cast<Declaration_scope*>(outer);
+      Declaration* d = ds->get_declaration()->cast_as_declaration();
+      if (d->is_translation_unit())
+        return imported_lookup(static_cast<Translation_unit*>(d), sym);
+    }
+    return nullptr;
+  }
+
+  /// Modules are searched in order of import. A declaration is loaded from
+  /// the first module that exports the name, and is remembered so that
+  /// later lookups do not search the imports.
+  Named_declaration*
+  Semantics::imported_lookup(Translation_unit* tu, Symbol sym)
+  {
+    Declaration_set decls = m_imported.lookup(sym);
+    if (!decls.is_empty())
+      return decls.get_single_declaration();
+    for (Import_declaration* imp : tu->get_imports()) {
+      Module_interface* mi = imp->get_interface();
+      if (Named_declaration* d = mi->load_declaration(m_cxt, imp, sym)) {
+        m_imported.declare(d);
+        return d;
+      }
+    }
+    return nullptr;
   }
 
+  // Diagnostics
+
+  void
+  Semantics::error(Location loc, const std::string& msg) const
+  {
+    throw Source_error(m_cxt.get_source_location(loc), msg);
+  }
 
 } // namespace beaker
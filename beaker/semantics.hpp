@@ -3,11 +3,11 @@
 #include <beaker/common.hpp>
 #include <beaker/token.hpp>
 #include <beaker/dump.hpp>
+#include <beaker/declaration.hpp>
+#include <beaker/scope.hpp>
 
 namespace beaker
 {
-  class Scope;
-  class Declaration_set;
   class Int_type;
   class Float_type;
   class Function_type;
@@ -155,8 +155,9 @@ namespace beaker
     /// Invoked to analyze an id-expression.
     Expression* on_id_expression(const Token& id);
 
-    /// Invoked to construct an id-expression from a declaration.
-    Expression* make_id_expression(Named_declaration* d);
+    /// Invoked to construct an id-expression from the declaration `d`
+    /// found by the lookup of `id`.
+    Expression* make_id_expression(Named_declaration* d, const Token& id);
 
     /// Invoked to construct an id-expression from a declaration.
     Expression* make_id_expression(Typed_declaration* d);
@@ -281,6 +282,9 @@ namespace beaker
     /// Called to analyze an assertion.
     Declaration* on_assertion(Expression* e, const Token& kw, const Token& semi);
 
+    /// Called to analyze the import of a module.
+    Declaration* on_import(const Token& kw, const Token& id, const Token& semi);
+
     // Scope and declaration
 
     /// Make `d` the active declarative region.
@@ -326,9 +330,12 @@ namespace beaker
 
     // Lookup
 
-    /// Perform unqualified lookup and return a set of declarations
-    /// corresponding to the given name.
-    Declaration_set unqualified_lookup(Symbol s);
+    /// Perform unqualified lookup and return the declaration of the given
+    /// name, or nullptr if there is none.
+    Named_declaration* unqualified_lookup(Symbol s);
+
+    /// Search the modules imported by `tu` for a declaration of `s`.
+    Named_declaration* imported_lookup(Translation_unit* tu, Symbol s);
 
     // Conversions
 
@@ -413,6 +420,18 @@ namespace beaker
     /// Checks that `e1` and `e2` have the same value type.
     Expression_pair require_same_value(Expression* e1, Expression* e2);
 
+    // Diagnostics
+
+    /// Throws an error with the message `msg` at the source location of
+    /// `loc`.
+    [[noreturn]] void error(Location loc, const std::string& msg) const;
+
+    // Constant folding
+
+    /// Returns the folded value of the operator expression or conversion
+    /// `e` if its operands have known values, or `e` otherwise.
+    Expression* fold(Expression* e);
+
     // Initialization
 
     /// Initialize the variable `d` with `e`.
@@ -427,11 +446,18 @@ namespace beaker
     /// The translation context. This provides access to compiler resources.
     Context& m_cxt;
 
-    /// The current scope.
+    /// The current declaration scope.
     Scope* m_scope;
 
+    /// The scopes of the open blocks in the current function.
+    Block_scope_stack m_blocks;
+
     /// The current declaration.
     Scoped_declaration* m_decl;
+
+    /// The imported declarations found by lookup. These are kept apart
+    /// from the imports, which are shared with other threads.
+    Declaration_map m_imported;
   };
 
 } // namespace beaker
@@ -0,0 +1,1783 @@
+#include "snapshot.hpp"
+#include "type.hpp"
+#include "type_specifier.hpp"
+#include "expression.hpp"
+#include "arithmetic_expression.hpp"
+#include "bitwise_expression.hpp"
+#include "logical_expression.hpp"
+#include "relational_expression.hpp"
+#include "conversion.hpp"
+#include "initializer.hpp"
+#include "statement.hpp"
+#include "declaration.hpp"
+#include "module_interface.hpp"
+#include "context.hpp"
+#include "file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace beaker
+{
+  namespace
+  {
+    /// Identifies snapshot files.
+    constexpr char snapshot_magic[4] = {'B', 'K', 'S', 0};
+
+    /// The version of the snapshot format. As with interfaces, this is
+    /// stored in the byte order of the host.
+    constexpr std::uint32_t snapshot_version = 3;
+
+    /// Denotes the absence of a node.
+    constexpr std::uint32_t none = ~std::uint32_t(0);
+
+    /// The header of a snapshot file. The header is followed by the tables
+    /// in the order of their sizes below, then by the symbol spellings.
+    /// Every record is 4-byte aligned.
+    struct Snapshot_header
+    {
+      char magic[4];
+      std::uint32_t version;
+      std::uint32_t symbols;
+      std::uint32_t types;
+      std::uint32_t lists;
+      std::uint32_t decls;
+      std::uint32_t specs;
+      std::uint32_t exprs;
+      std::uint32_t stmts;
+      std::uint32_t strings;
+    };
+
+    /// Describes a symbol by the offset and length of its spelling.
+    struct Symbol_record
+    {
+      std::uint32_t name;
+      std::uint32_t length;
+    };
+
+    /// Describes a type, as in interface files. A reference type names its
+    /// object type in `first`. A function type has `count` parameter types,
+    /// followed by its return type, in the lists starting at `first`.
+    struct Type_record
+    {
+      std::uint32_t kind;
+      std::uint32_t first;
+      std::uint32_t count;
+    };
+
+    /// Flags of declaration records.
+    enum Declaration_flags : std::uint32_t
+    {
+      /// The declaration is loaded from the interface of its owner, which
+      /// is an import. Only its kind and name are recorded.
+      imported_decl = 1,
+
+      /// The declaration is visible to lookup in its owner.
+      visible_decl = 2,
+    };
+
+    /// Describes a declaration. The fields used depend on the kind:
+    ///
+    ///   functions -- name, type, the return type specifier in `spec`, the
+    ///   parameters in `first` and `count`, and the body.
+    ///
+    ///   data -- name, type, `spec`, and the initializer in `init`.
+    ///
+    ///   parameters -- name, and the underlying declaration in `first`.
+    ///
+    ///   assertions -- the condition in `init`.
+    ///
+    ///   imports -- name.
+    ///
+    /// Scoped declarations list their nested declarations in `members`.
+    struct Declaration_record
+    {
+      std::uint32_t kind;
+      std::uint32_t flags;
+      std::uint32_t owner;
+      std::uint32_t name;
+      std::uint32_t type;
+      std::uint32_t spec;
+      std::uint32_t init;
+      std::uint32_t body;
+      std::uint32_t first;
+      std::uint32_t count;
+      std::uint32_t members;
+      std::uint32_t member_count;
+    };
+
+    /// Describes a type specifier. A reference specifier names its operand
+    /// in `first`. A function specifier has `count` parameter specifiers,
+    /// followed by its return specifier, in the lists starting at `first`.
+    struct Specifier_record
+    {
+      std::uint32_t kind;
+      std::uint32_t type;
+      std::uint32_t first;
+      std::uint32_t count;
+    };
+
+    /// Describes an expression. Operands are expressions, except that the
+    /// operand of an id-expression is a declaration. The value holds the
+    /// low and high words of a literal, or the kind of a conversion.
+    struct Expression_record
+    {
+      std::uint32_t kind;
+      std::uint32_t type;
+      std::uint32_t ops[3];
+      std::uint32_t value[2];
+    };
+
+    /// Describes a statement. Conditions and returned values are
+    /// expressions, and the operand of a declaration statement is a
+    /// declaration; the other operands are statements. A block lists its
+    /// statements starting at `first`.
+    struct Statement_record
+    {
+      std::uint32_t kind;
+      std::uint32_t ops[3];
+      std::uint32_t first;
+      std::uint32_t count;
+    };
+
+
+    /// Accumulates the tables of a snapshot. Each node is added after the
+    /// nodes it refers to, except for declarations, which are added before
+    /// their contents so that they can be named from within them.
+    class Snapshot_writer
+    {
+    public:
+      std::uint32_t add_symbol(Symbol sym);
+      std::uint32_t add_type(const Type* t);
+      std::uint32_t add_declaration(const Declaration* d);
+      std::uint32_t add_specifier(const Type_specifier* ts);
+      std::uint32_t add_expression(const Expression* e);
+      std::uint32_t add_statement(const Statement* s);
+      void write(std::ostream& os);
+
+    private:
+      std::uint32_t add_list(const std::vector<std::uint32_t>& v);
+      std::uint32_t add_members(const Scoped_declaration* sd);
+
+      /// The index of each node in its table.
+      std::unordered_map<Symbol, std::uint32_t> m_symbol_index;
+      std::unordered_map<const Type*, std::uint32_t> m_type_index;
+      std::unordered_map<const Declaration*, std::uint32_t> m_decl_index;
+      std::unordered_map<const Type_specifier*, std::uint32_t> m_spec_index;
+      std::unordered_map<const Expression*, std::uint32_t> m_expr_index;
+      std::unordered_map<const Statement*, std::uint32_t> m_stmt_index;
+
+      std::vector<Symbol_record> m_symbols;
+      std::vector<Type_record> m_types;
+      std::vector<std::uint32_t> m_lists;
+      std::vector<Declaration_record> m_decls;
+      std::vector<Specifier_record> m_specs;
+      std::vector<Expression_record> m_exprs;
+      std::vector<Statement_record> m_stmts;
+      std::string m_strings;
+    };
+
+    std::uint32_t
+    Snapshot_writer::add_symbol(Symbol sym)
+    {
+      auto iter = m_symbol_index.find(sym);
+      if (iter != m_symbol_index.end())
+        return iter->second;
+
+      Symbol_record r {std::uint32_t(m_strings.size()), std::uint32_t(sym->size())};
+      m_strings.append(sym->data(), sym->size());
+      std::uint32_t n = m_symbols.size();
+      m_symbols.push_back(r);
+      m_symbol_index.emplace(sym, n);
+      return n;
+    }
+
+    std::uint32_t
+    Snapshot_writer::add_type(const Type* t)
+    {
+      if (!t)
+        return none;
+      auto iter = m_type_index.find(t);
+      if (iter != m_type_index.end())
+        return iter->second;
+
+      Type_record r {std::uint32_t(t->get_kind()), 0, 0};
+      switch (t->get_kind()) {
+      case Type::ref_kind:
+        r.first = add_type(static_cast<const Reference_type*>(t)->get_object_type());
+        break;
+
+      case Type::func_kind: {
+        const Function_type* f = static_cast<const Function_type*>(t);
+        std::vector<std::uint32_t> ops;
+        for (const Type* p : f->get_parameter_types())
+          ops.push_back(add_type(p));
+        ops.push_back(add_type(f->get_return_type()));
+        r.count = ops.size() - 1;
+        r.first = add_list(ops);
+        break;
+      }
+
+      default:
+        break;
+      }
+
+      std::uint32_t n = m_types.size();
+      m_types.push_back(r);
+      m_type_index.emplace(t, n);
+      return n;
+    }
+
+    /// The owner of `d` is added first, and then `d`, so that owners
+    /// precede their members. Adding the owner or the underlying
+    /// declaration of a parameter may add `d` itself.
+    std::uint32_t
+    Snapshot_writer::add_declaration(const Declaration* d)
+    {
+      if (!d)
+        return none;
+      auto iter = m_decl_index.find(d);
+      if (iter != m_decl_index.end())
+        return iter->second;
+
+      std::uint32_t owner = add_declaration(d->get_enclosing_declaration());
+      std::uint32_t first = none;
+      if (d->get_kind() == Declaration::parm_kind)
+        first = add_declaration(static_cast<const Parameter*>(d)->get_declaration());
+      iter = m_decl_index.find(d);
+      if (iter != m_decl_index.end())
+        return iter->second;
+
+      std::uint32_t n = m_decls.size();
+      m_decls.emplace_back();
+      m_decl_index.emplace(d, n);
+
+      Declaration_record r {
+        std::uint32_t(d->get_kind()), 0, owner,
+        none, none, none, none, none, first, 0, none, 0
+      };
+      if (d->is_imported()) {
+        r.flags = imported_decl;
+        r.name = add_symbol(static_cast<const Named_declaration*>(d)->get_name());
+        m_decls[n] = r;
+        return n;
+      }
+
+      switch (d->get_kind()) {
+      case Declaration::tu_kind:
+        break;
+
+      case Declaration::func_kind: {
+        const Function_declaration* fn = static_cast<const Function_declaration*>(d);
+        r.name = add_symbol(fn->get_name());
+        r.type = add_type(fn->get_type());
+        r.spec = add_specifier(fn->get_return());
+        std::vector<std::uint32_t> parms;
+        for (const Parameter* p : fn->get_parameters())
+          parms.push_back(add_declaration(p));
+        r.first = add_list(parms);
+        r.count = parms.size();
+        r.body = add_statement(fn->get_body());
+        break;
+      }
+
+      case Declaration::val_kind:
+      case Declaration::var_kind:
+      case Declaration::ref_kind: {
+        const Data_declaration* data = static_cast<const Data_declaration*>(d);
+        r.name = add_symbol(data->get_name());
+        r.type = add_type(data->get_type());
+        r.spec = add_specifier(data->get_type_specifier());
+        r.init = add_expression(data->get_initializer());
+        break;
+      }
+
+      case Declaration::parm_kind:
+        r.name = add_symbol(static_cast<const Parameter*>(d)->get_name());
+        break;
+
+      case Declaration::assert_kind:
+        r.init = add_expression(static_cast<const Assertion*>(d)->get_condition());
+        break;
+
+      case Declaration::import_kind:
+        r.name = add_symbol(static_cast<const Import_declaration*>(d)->get_name());
+        break;
+      }
+
+      if (const Scoped_declaration* sd = d->get_as_scoped()) {
+        r.members = add_members(sd);
+        r.member_count = sd->get_declarations().size();
+      }
+      m_decls[n] = r;
+      return n;
+    }
+
+    /// Returns true if `d` is found by lookup in `sd`.
+    bool
+    is_visible(const Scoped_declaration* sd, const Declaration* d)
+    {
+      if (d->get_kind() == Declaration::assert_kind)
+        return false;
+      Symbol sym = static_cast<const Named_declaration*>(d)->get_name();
+      for (const auto& entry : sd->lookup(sym)) {
+        if (entry.second == d)
+          return true;
+      }
+      return false;
+    }
+
+    /// Adds the nested declarations of `sd`, and returns the position of
+    /// their list.
+    std::uint32_t
+    Snapshot_writer::add_members(const Scoped_declaration* sd)
+    {
+      std::vector<std::uint32_t> members;
+      for (const Declaration* d : sd->get_declarations()) {
+        std::uint32_t n = add_declaration(d);
+        if (is_visible(sd, d))
+          m_decls[n].flags |= visible_decl;
+        members.push_back(n);
+      }
+      return add_list(members);
+    }
+
+    std::uint32_t
+    Snapshot_writer::add_specifier(const Type_specifier* ts)
+    {
+      if (!ts)
+        return none;
+      auto iter = m_spec_index.find(ts);
+      if (iter != m_spec_index.end())
+        return iter->second;
+
+      Specifier_record r {std::uint32_t(ts->get_kind()), add_type(ts->get_type()), 0, 0};
+      switch (ts->get_kind()) {
+      case Type_specifier::simple_kind:
+        break;
+
+      case Type_specifier::ref_kind: {
+        auto* ref = static_cast<const Reference_type_specifier*>(ts);
+        r.first = add_specifier(ref->get_value_type());
+        break;
+      }
+
+      case Type_specifier::func_kind: {
+        auto* fn = static_cast<const Function_type_specifier*>(ts);
+        std::vector<std::uint32_t> ops;
+        for (const Type_specifier* p : fn->get_parameter_types())
+          ops.push_back(add_specifier(p));
+        ops.push_back(add_specifier(fn->get_return_type()));
+        r.count = ops.size() - 1;
+        r.first = add_list(ops);
+        break;
+      }
+      }
+
+      std::uint32_t n = m_specs.size();
+      m_specs.push_back(r);
+      m_spec_index.emplace(ts, n);
+      return n;
+    }
+
+    /// Canonical expressions are shared, so each is added once. Adding the
+    /// operands may add `e` itself, through the initializer of a named
+    /// declaration. Snapshots do not record locations, so located
+    /// expressions are added as the expressions they use.
+    std::uint32_t
+    Snapshot_writer::add_expression(const Expression* e)
+    {
+      if (!e)
+        return none;
+      e = get_used_expression(e);
+      auto iter = m_expr_index.find(e);
+      if (iter != m_expr_index.end())
+        return iter->second;
+
+      Expression_record r {
+        std::uint32_t(e->get_kind()), add_type(e->get_type()), {none, none, none}, {0, 0}
+      };
+      switch (e->get_kind()) {
+      case Expression::bool_kind:
+        r.value[0] = static_cast<const Bool_literal*>(e)->get_value();
+        break;
+
+      case Expression::int_kind: {
+        std::uint64_t val = static_cast<const Int_literal*>(e)->get_value();
+        r.value[0] = std::uint32_t(val);
+        r.value[1] = std::uint32_t(val >> 32);
+        break;
+      }
+
+      case Expression::id_kind:
+      case Expression::init_kind:
+        r.ops[0] = add_declaration(static_cast<const Id_expression*>(e)->get_declaration());
+        break;
+
+      case Expression::fold_kind: {
+        const Folded_expression* f = static_cast<const Folded_expression*>(e);
+        std::uint64_t val = f->get_value().get_int();
+        r.ops[0] = add_expression(f->get_expression());
+        r.value[0] = std::uint32_t(val);
+        r.value[1] = std::uint32_t(val >> 32);
+        break;
+      }
+
+      case Expression::neg_kind:
+      case Expression::rec_kind:
+      case Expression::bit_not_kind:
+      case Expression::not_kind:
+        r.ops[0] = add_expression(static_cast<const Unary_expression*>(e)->get_operand());
+        break;
+
+      case Expression::imp_conv: {
+        const Conversion* c = static_cast<const Conversion*>(e);
+        r.ops[0] = add_expression(c->get_source());
+        r.value[0] = c->get_conversion_kind();
+        break;
+      }
+
+      case Expression::cond_kind: {
+        const Ternary_expression* t = static_cast<const Ternary_expression*>(e);
+        r.ops[0] = add_expression(t->get_first());
+        r.ops[1] = add_expression(t->get_second());
+        r.ops[2] = add_expression(t->get_third());
+        break;
+      }
+
+      case Expression::empty_init:
+      case Expression::def_init:
+        r.ops[0] = add_expression(static_cast<const Initializer*>(e)->get_object());
+        break;
+
+      case Expression::val_init: {
+        const Value_initializer* init = static_cast<const Value_initializer*>(e);
+        r.ops[0] = add_expression(init->get_object());
+        r.ops[1] = add_expression(init->get_value());
+        break;
+      }
+
+      default: {
+        const Binary_expression* b = static_cast<const Binary_expression*>(e);
+        r.ops[0] = add_expression(b->get_lhs());
+        r.ops[1] = add_expression(b->get_rhs());
+        break;
+      }
+      }
+
+      iter = m_expr_index.find(e);
+      if (iter != m_expr_index.end())
+        return iter->second;
+      std::uint32_t n = m_exprs.size();
+      m_exprs.push_back(r);
+      m_expr_index.emplace(e, n);
+      return n;
+    }
+
+    std::uint32_t
+    Snapshot_writer::add_statement(const Statement* s)
+    {
+      if (!s)
+        return none;
+      auto iter = m_stmt_index.find(s);
+      if (iter != m_stmt_index.end())
+        return iter->second;
+
+      Statement_record r {std::uint32_t(s->get_kind()), {none, none, none}, 0, 0};
+      switch (s->get_kind()) {
+      case Statement::block_kind: {
+        std::vector<std::uint32_t> ss;
+        for (const Statement* s1 : static_cast<const Block_statement*>(s)->get_statements())
+          ss.push_back(add_statement(s1));
+        r.first = add_list(ss);
+        r.count = ss.size();
+        break;
+      }
+
+      case Statement::when_kind: {
+        const When_statement* w = static_cast<const When_statement*>(s);
+        r.ops[0] = add_expression(w->get_condition());
+        r.ops[1] = add_statement(w->get_true_branch());
+        break;
+      }
+
+      case Statement::if_kind: {
+        const If_statement* i = static_cast<const If_statement*>(s);
+        r.ops[0] = add_expression(i->get_condition());
+        r.ops[1] = add_statement(i->get_true_branch());
+        r.ops[2] = add_statement(i->get_false_branch());
+        break;
+      }
+
+      case Statement::while_kind: {
+        const While_statement* w = static_cast<const While_statement*>(s);
+        r.ops[0] = add_expression(w->get_condition());
+        r.ops[1] = add_statement(w->get_body());
+        break;
+      }
+
+      case Statement::break_kind:
+      case Statement::cont_kind:
+        break;
+
+      case Statement::ret_kind:
+        r.ops[0] = add_expression(static_cast<const Return_statement*>(s)->get_return_value());
+        break;
+
+      case Statement::expr_kind:
+        r.ops[0] = add_expression(static_cast<const Expression_statement*>(s)->get_expression());
+        break;
+
+      case Statement::decl_kind:
+        r.ops[0] = add_declaration(static_cast<const Declaration_statement*>(s)->get_declaration());
+        break;
+      }
+
+      std::uint32_t n = m_stmts.size();
+      m_stmts.push_back(r);
+      m_stmt_index.emplace(s, n);
+      return n;
+    }
+
+    std::uint32_t
+    Snapshot_writer::add_list(const std::vector<std::uint32_t>& v)
+    {
+      std::uint32_t n = m_lists.size();
+      m_lists.insert(m_lists.end(), v.begin(), v.end());
+      return n;
+    }
+
+    template<typename T>
+    void
+    write_table(std::ostream& os, const std::vector<T>& v)
+    {
+      os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+
+    void
+    Snapshot_writer::write(std::ostream& os)
+    {
+      // Pad the spellings so that files are a multiple of 4 bytes.
+      m_strings.resize((m_strings.size() + 3) & ~std::size_t(3));
+
+      Snapshot_header h;
+      std::memcpy(h.magic, snapshot_magic, sizeof(h.magic));
+      h.version = snapshot_version;
+      h.symbols = m_symbols.size();
+      h.types = m_types.size();
+      h.lists = m_lists.size();
+      h.decls = m_decls.size();
+      h.specs = m_specs.size();
+      h.exprs = m_exprs.size();
+      h.stmts = m_stmts.size();
+      h.strings = m_strings.size();
+      os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+      write_table(os, m_symbols);
+      write_table(os, m_types);
+      write_table(os, m_lists);
+      write_table(os, m_decls);
+      write_table(os, m_specs);
+      write_table(os, m_exprs);
+      write_table(os, m_stmts);
+      os.write(m_strings.data(), m_strings.size());
+    }
+
+
+    /// Returns true if `t` is the type of a value: bool, int, or float.
+    bool
+    is_value_type(const Type* t)
+    {
+      return t->is_bool() || t->is_integer() || t->is_floating_point();
+    }
+
+    /// Returns true if `t` is a value type or a reference to one. These
+    /// are the types of data declarations.
+    bool
+    is_data_type(const Type* t)
+    {
+      if (t->is_reference())
+        return is_value_type(static_cast<const Reference_type*>(t)->get_object_type());
+      return is_value_type(t);
+    }
+
+    /// Returns true if `n` is a value of the bool or integer type `t`.
+    bool
+    is_in_range(const Type* t, std::intmax_t n)
+    {
+      if (t->is_bool())
+        return n == 0 || n == 1;
+      int r = static_cast<const Int_type*>(t)->get_rank();
+      if (r >= std::numeric_limits<std::intmax_t>::digits + 1)
+        return true;
+      std::intmax_t max = (std::intmax_t(1) << (r - 1)) - 1;
+      return -max - 1 <= n && n <= max;
+    }
+
+    /// Returns true if a conversion of kind `ck` converts an expression of
+    /// type `s` to type `t`.
+    bool
+    is_conversion(Conversion::Conversion_kind ck, const Type* s, const Type* t)
+    {
+      switch (ck) {
+      case Conversion::value_conv:
+        return s->is_reference() && static_cast<const Reference_type*>(s)->get_object_type() == t;
+      case Conversion::bool_conv:
+        return t->is_bool() && (s->is_integer() || s->is_floating_point() || s->is_function());
+      case Conversion::int_prom:
+        return t->is_integer() && s->is_bool();
+      case Conversion::sign_ext:
+      case Conversion::zero_ext:
+      case Conversion::int_trunc:
+        return t->is_integer() && s->is_integer();
+      case Conversion::float_prom:
+        return t->is_floating_point() && s->is_integer();
+      case Conversion::float_dem:
+        return t->is_integer() && s->is_floating_point();
+      case Conversion::float_ext:
+      case Conversion::float_trunc:
+        return t->is_floating_point() && s->is_floating_point();
+      }
+      return false;
+    }
+
+
+    /// Rebuilds the module in a snapshot. Each table is read in order, and
+    /// every operand must precede its use, so that a snapshot cannot
+    /// describe a cycle. The exception is that declarations precede their
+    /// contents, so an initializer may not name the declaration it
+    /// initializes except through its init-expression.
+    ///
+    /// Nodes are rebuilt only if they could have been produced by semantic
+    /// analysis: the type of each operand is checked against the kind of
+    /// expression or statement using it, and the type of each declaration
+    /// against its initializer. Function bodies are checked to name only
+    /// the local declarations in scope.
+    class Snapshot_loader
+    {
+    public:
+      Snapshot_loader(Context& cxt, const std::string& path);
+
+      Translation_unit* load();
+
+    private:
+      template<typename T>
+      const T* get_table(const char*& p, std::uint32_t n);
+
+      void load_symbols();
+      void load_types();
+      void load_declarations();
+      void load_specifiers();
+      void load_expressions();
+      void load_assertions();
+      void load_statements();
+      void complete_declarations();
+      void check_function(std::uint32_t n);
+      void check_statement(std::uint32_t n, const Function_declaration* fn, int loops);
+      void check_locals(std::uint32_t n);
+
+      template<typename T>
+      Declaration* make_data_declaration(const Declaration_record& r);
+
+      Expression* make_expression(const Expression_record& r);
+      Statement* make_statement(const Statement_record& r);
+
+      template<typename T>
+      Expression* make_unary(Type* t, const Expression_record& r);
+
+      template<typename T>
+      Expression* make_binary(Type* t, const Expression_record& r);
+
+      template<typename T>
+      Expression* make_comparison(Type* t, const Expression_record& r);
+
+      const std::uint32_t* get_list(std::uint32_t first, std::uint64_t count);
+      Symbol get_symbol(std::uint32_t n);
+      Type* get_type(std::uint32_t n);
+      Declaration* get_declaration(std::uint32_t n);
+      Scoped_declaration* get_scope(std::uint32_t n);
+      Typed_declaration* get_typed_declaration(std::uint32_t n);
+      Type_specifier* get_specifier(std::uint32_t n);
+      Expression* get_expression(std::uint32_t n);
+      Expression* get_expression(std::uint32_t n, const Type* t);
+      Expression* get_operand(std::uint32_t n);
+      Expression* get_operand(std::uint32_t n, const Type* t);
+      Expression* get_object(std::uint32_t n);
+      Statement* get_statement(std::uint32_t n);
+      Statement* get_substatement(std::uint32_t n);
+
+      [[noreturn]] void invalid() const;
+
+      Context& m_cxt;
+
+      /// The snapshot file.
+      File m_file;
+
+      /// The header of the snapshot.
+      const Snapshot_header* m_header;
+
+      // The tables of the snapshot.
+      const Symbol_record* m_symbol_records;
+      const Type_record* m_type_records;
+      const std::uint32_t* m_lists;
+      const Declaration_record* m_decl_records;
+      const Specifier_record* m_spec_records;
+      const Expression_record* m_expr_records;
+      const Statement_record* m_stmt_records;
+      const char* m_strings;
+
+      // The rebuilt nodes, by index.
+      std::vector<Symbol> m_symbols;
+      std::vector<Type*> m_types;
+      std::vector<Declaration*> m_decls;
+      std::vector<Type_specifier*> m_specs;
+      std::vector<Expression*> m_exprs;
+      std::vector<Statement*> m_stmts;
+
+      /// The local declarations named by each expression, other than by
+      /// init-expressions.
+      std::vector<std::vector<const Declaration*>> m_expr_locals;
+
+      /// The local declarations named by the expression being rebuilt.
+      std::vector<const Declaration*> m_locals;
+
+      /// The local declarations in scope in the function being checked.
+      std::vector<const Declaration*> m_scope;
+
+      /// True for each declaration listed as a member of its owner.
+      std::vector<bool> m_members;
+
+      /// True for each local declaration declared by a statement or as a
+      /// parameter.
+      std::vector<bool> m_declared;
+
+      /// True for each statement used in a function body.
+      std::vector<bool> m_stmt_used;
+
+      /// Stands for the tokens spelling literals and operators, whose
+      /// locations are not saved.
+      Token m_token;
+    };
+
+    /// The sizes in the header must account for the whole file.
+    Snapshot_loader::Snapshot_loader(Context& cxt, const std::string& path)
+      : m_cxt(cxt), m_file(path), m_header()
+    {
+      Text_view text = m_file.get_text();
+      if (text.size() < sizeof(Snapshot_header))
+        invalid();
+      assert(reinterpret_cast<std::uintptr_t>(text.data()) % 4 == 0);
+
+      m_header = reinterpret_cast<const Snapshot_header*>(text.data());
+      const Snapshot_header& h = *m_header;
+      if (std::memcmp(h.magic, snapshot_magic, sizeof(h.magic)) != 0)
+        invalid();
+      if (h.version != snapshot_version)
+        invalid();
+
+      std::uint64_t size = sizeof(Snapshot_header)
+                         + std::uint64_t(h.symbols) * sizeof(Symbol_record)
+                         + std::uint64_t(h.types) * sizeof(Type_record)
+                         + std::uint64_t(h.lists) * sizeof(std::uint32_t)
+                         + std::uint64_t(h.decls) * sizeof(Declaration_record)
+                         + std::uint64_t(h.specs) * sizeof(Specifier_record)
+                         + std::uint64_t(h.exprs) * sizeof(Expression_record)
+                         + std::uint64_t(h.stmts) * sizeof(Statement_record)
+                         + h.strings;
+      if (size != text.size())
+        invalid();
+
+      const char* p = text.data() + sizeof(Snapshot_header);
+      m_symbol_records = get_table<Symbol_record>(p, h.symbols);
+      m_type_records = get_table<Type_record>(p, h.types);
+      m_lists = get_table<std::uint32_t>(p, h.lists);
+      m_decl_records = get_table<Declaration_record>(p, h.decls);
+      m_spec_records = get_table<Specifier_record>(p, h.specs);
+      m_expr_records = get_table<Expression_record>(p, h.exprs);
+      m_stmt_records = get_table<Statement_record>(p, h.stmts);
+      m_strings = p;
+    }
+
+    /// Returns the table of `n` records at `p`, and advances `p` past it.
+    template<typename T>
+    const T*
+    Snapshot_loader::get_table(const char*& p, std::uint32_t n)
+    {
+      const T* table = reinterpret_cast<const T*>(p);
+      p += n * sizeof(T);
+      return table;
+    }
+
+    /// Declarations are created with their types before the expressions
+    /// and statements that refer to them, and completed after. Assertions
+    /// are the exception, since they are created with their conditions.
+    /// Function bodies are checked once every declaration is complete.
+    Translation_unit*
+    Snapshot_loader::load()
+    {
+      load_symbols();
+      load_types();
+      load_declarations();
+      load_specifiers();
+      load_expressions();
+      load_assertions();
+      load_statements();
+      complete_declarations();
+      if (m_decls.empty())
+        invalid();
+      for (std::uint32_t i = 0; i < m_header->decls; ++i) {
+        if (m_decls[i]->is_function() && !m_decls[i]->is_imported())
+          check_function(i);
+      }
+      return static_cast<Translation_unit*>(m_decls[0]);
+    }
+
+    void
+    Snapshot_loader::load_symbols()
+    {
+      m_symbols.reserve(m_header->symbols);
+      for (std::uint32_t i = 0; i < m_header->symbols; ++i) {
+        const Symbol_record& r = m_symbol_records[i];
+        if (r.name > m_header->strings || r.length > m_header->strings - r.name)
+          invalid();
+        m_symbols.push_back(m_cxt.get_symbol(m_strings + r.name, r.length));
+      }
+    }
+
+    void
+    Snapshot_loader::load_types()
+    {
+      m_types.reserve(m_header->types);
+      for (std::uint32_t i = 0; i < m_header->types; ++i) {
+        const Type_record& r = m_type_records[i];
+        Type* t;
+        switch (r.kind) {
+        case Type::unit_kind:
+          t = m_cxt.get_unit_type();
+          break;
+        case Type::bool_kind:
+          t = m_cxt.get_bool_type();
+          break;
+        case Type::int_kind:
+          t = m_cxt.get_int_type();
+          break;
+        case Type::float_kind:
+          t = m_cxt.get_float_type();
+          break;
+        case Type::auto_kind:
+          t = m_cxt.get_auto_type();
+          break;
+
+        case Type::ref_kind: {
+          Type* obj = get_type(r.first);
+          if (!is_value_type(obj))
+            invalid();
+          t = m_cxt.get_reference_type(obj);
+          break;
+        }
+
+        case Type::func_kind: {
+          const std::uint32_t* ops = get_list(r.first, r.count + std::uint64_t(1));
+          Type_seq parms;
+          parms.reserve(r.count);
+          for (std::uint32_t j = 0; j < r.count; ++j) {
+            Type* p = get_type(ops[j]);
+            if (!is_data_type(p))
+              invalid();
+            parms.push_back(p);
+          }
+          Type* ret = get_type(ops[r.count]);
+          if (!is_value_type(ret))
+            invalid();
+          t = m_cxt.get_function_type(std::move(parms), ret);
+          break;
+        }
+
+        default:
+          invalid();
+        }
+        m_types.push_back(t);
+      }
+    }
+
+    /// Creates each declaration in its owner. Imported declarations are
+    /// loaded from the interface of their import.
+    void
+    Snapshot_loader::load_declarations()
+    {
+      m_decls.reserve(m_header->decls);
+      for (std::uint32_t i = 0; i < m_header->decls; ++i) {
+        const Declaration_record& r = m_decl_records[i];
+        if ((i == 0) != (r.kind == Declaration::tu_kind))
+          invalid();
+
+        Declaration* d = nullptr;
+        if (r.flags & imported_decl) {
+          Declaration* owner = get_declaration(r.owner);
+          if (!owner->is_import())
+            invalid();
+          Import_declaration* imp = static_cast<Import_declaration*>(owner);
+          d = imp->get_interface()->load_declaration(m_cxt, imp, get_symbol(r.name));
+          if (!d || d->get_kind() != r.kind)
+            invalid();
+          m_decls.push_back(d);
+          continue;
+        }
+
+        switch (r.kind) {
+        case Declaration::tu_kind:
+          d = m_cxt.make<Translation_unit>();
+          break;
+
+        case Declaration::func_kind: {
+          Scoped_declaration* owner = get_scope(r.owner);
+          if (!owner->is_translation_unit())
+            invalid();
+          Type* t = get_type(r.type);
+          if (!t->is_function())
+            invalid();
+          auto* fn = m_cxt.make<Function_declaration>(owner, get_symbol(r.name),
+                                                      Location(), Location());
+          fn->set_type(static_cast<Function_type*>(t));
+          d = fn;
+          break;
+        }
+
+        case Declaration::val_kind:
+          d = make_data_declaration<Value_declaration>(r);
+          break;
+
+        case Declaration::var_kind:
+          d = make_data_declaration<Variable_declaration>(r);
+          break;
+
+        case Declaration::ref_kind:
+          d = make_data_declaration<Reference_declaration>(r);
+          break;
+
+        case Declaration::parm_kind: {
+          Declaration* inner = get_declaration(r.first);
+          if (!inner->is_data())
+            invalid();
+          d = m_cxt.make<Parameter>(static_cast<Named_declaration*>(inner));
+          break;
+        }
+
+        case Declaration::assert_kind:
+          break;
+
+        case Declaration::import_kind: {
+          Scoped_declaration* owner = get_scope(r.owner);
+          if (!owner->is_translation_unit())
+            invalid();
+          Symbol sym = get_symbol(r.name);
+          Module_interface* mi = m_cxt.get_module_interface(sym);
+          auto* imp = m_cxt.make<Import_declaration>(owner, sym, mi, Location(), Location());
+          static_cast<Translation_unit*>(owner->cast_as_declaration())->add_import(imp);
+          d = imp;
+          break;
+        }
+
+        default:
+          invalid();
+        }
+        m_decls.push_back(d);
+      }
+      m_members.resize(m_decls.size());
+      m_declared.resize(m_decls.size());
+    }
+
+    /// Data is declared at namespace scope or in a function. References
+    /// have reference types, and other data has value types.
+    template<typename T>
+    Declaration*
+    Snapshot_loader::make_data_declaration(const Declaration_record& r)
+    {
+      Scoped_declaration* owner = get_scope(r.owner);
+      if (!owner->is_translation_unit() && !owner->is_function())
+        invalid();
+      T* d = m_cxt.make<T>(owner, get_symbol(r.name), Location(), Location());
+      Type* t = get_type(r.type);
+      if (d->is_reference() ? !t->is_reference() : !is_value_type(t))
+        invalid();
+      d->set_type(t);
+      return d;
+    }
+
+    void
+    Snapshot_loader::load_specifiers()
+    {
+      m_specs.reserve(m_header->specs);
+      for (std::uint32_t i = 0; i < m_header->specs; ++i) {
+        const Specifier_record& r = m_spec_records[i];
+        Type* t = get_type(r.type);
+        Type_specifier* ts;
+        switch (r.kind) {
+        case Type_specifier::simple_kind:
+          if (!is_value_type(t))
+            invalid();
+          ts = m_cxt.get_simple_type_specifier(t);
+          break;
+
+        case Type_specifier::ref_kind: {
+          Type_specifier* obj = get_specifier(r.first);
+          if (!is_value_type(obj->get_type()) || t != m_cxt.get_reference_type(obj->get_type()))
+            invalid();
+          ts = m_cxt.make<Reference_type_specifier>(t, obj, Location());
+          break;
+        }
+
+        case Type_specifier::func_kind: {
+          const std::uint32_t* ops = get_list(r.first, r.count + std::uint64_t(1));
+          std::vector<Type_specifier*> parms;
+          Type_seq types;
+          parms.reserve(r.count);
+          for (std::uint32_t j = 0; j < r.count; ++j) {
+            parms.push_back(get_specifier(ops[j]));
+            types.push_back(parms.back()->get_type());
+          }
+          Type_specifier* ret = get_specifier(ops[r.count]);
+          if (t != m_cxt.get_function_type(std::move(types), ret->get_type()))
+            invalid();
+          ts = m_cxt.make<Function_type_specifier>(t, m_cxt.make_span(parms), ret,
+                                                   Location(), Location(), Location());
+          break;
+        }
+
+        default:
+          invalid();
+        }
+        m_specs.push_back(ts);
+      }
+    }
+
+    void
+    Snapshot_loader::load_expressions()
+    {
+      m_exprs.reserve(m_header->exprs);
+      m_expr_locals.reserve(m_header->exprs);
+      for (std::uint32_t i = 0; i < m_header->exprs; ++i) {
+        m_locals.clear();
+        m_exprs.push_back(make_expression(m_expr_records[i]));
+        m_expr_locals.push_back(m_locals);
+      }
+    }
+
+    /// The operand has the type of the expression.
+    template<typename T>
+    Expression*
+    Snapshot_loader::make_unary(Type* t, const Expression_record& r)
+    {
+      return m_cxt.make_canonical<T>(t, get_operand(r.ops[0], t), m_token);
+    }
+
+    /// The operands have the type of the expression.
+    template<typename T>
+    Expression*
+    Snapshot_loader::make_binary(Type* t, const Expression_record& r)
+    {
+      Expression* e1 = get_operand(r.ops[0], t);
+      Expression* e2 = get_operand(r.ops[1], t);
+      return m_cxt.make_canonical<T>(t, e1, e2, m_token);
+    }
+
+    /// The operands have the same value type.
+    template<typename T>
+    Expression*
+    Snapshot_loader::make_comparison(Type* t, const Expression_record& r)
+    {
+      Expression* e1 = get_operand(r.ops[0]);
+      if (!is_value_type(e1->get_type()))
+        invalid();
+      Expression* e2 = get_operand(r.ops[1], e1->get_type());
+      return m_cxt.make_canonical<T>(t, e1, e2, m_token);
+    }
+
+    /// Expressions are interned as they are by semantic analysis. The type
+    /// of each expression is checked against its kind before its operands
+    /// are checked against that type.
+    Expression*
+    Snapshot_loader::make_expression(const Expression_record& r)
+    {
+      // Only initializers have no type.
+      Type* t = nullptr;
+      if (r.kind < Expression::empty_init)
+        t = get_type(r.type);
+
+      switch (r.kind) {
+      case Expression::bool_kind:
+      case Expression::not_kind:
+      case Expression::and_kind:
+      case Expression::or_kind:
+      case Expression::eq_kind:
+      case Expression::ne_kind:
+      case Expression::lt_kind:
+      case Expression::gt_kind:
+      case Expression::ng_kind:
+      case Expression::nl_kind:
+        if (!t->is_bool())
+          invalid();
+        break;
+
+      case Expression::int_kind:
+      case Expression::neg_kind:
+      case Expression::rec_kind:
+      case Expression::bit_and_kind:
+      case Expression::bit_ior_kind:
+      case Expression::bit_xor_kind:
+      case Expression::bit_not_kind:
+      case Expression::bit_shl_kind:
+      case Expression::bit_shr_kind:
+        if (!t->is_integer())
+          invalid();
+        break;
+
+      case Expression::fold_kind:
+        if (!t->is_bool() && !t->is_integer())
+          invalid();
+        break;
+
+      case Expression::add_kind:
+      case Expression::sub_kind:
+      case Expression::mul_kind:
+      case Expression::quo_kind:
+      case Expression::rem_kind:
+        if (!is_value_type(t))
+          invalid();
+        break;
+
+      case Expression::div_kind:
+        if (!t->is_floating_point())
+          invalid();
+        break;
+
+      case Expression::cond_kind:
+        if (!is_data_type(t))
+          invalid();
+        break;
+
+      case Expression::assign_kind:
+        if (!t->is_reference())
+          invalid();
+        break;
+
+      default:
+        break;
+      }
+
+      switch (r.kind) {
+      case Expression::bool_kind:
+        return m_cxt.make_canonical<Bool_literal>(t, m_token, r.value[0] != 0);
+
+      case Expression::int_kind: {
+        // Literals are never negative.
+        std::intmax_t val = std::intmax_t(r.value[0] | std::uint64_t(r.value[1]) << 32);
+        if (val < 0 || !is_in_range(t, val))
+          invalid();
+        return m_cxt.make_canonical<Int_literal>(t, m_token, val);
+      }
+
+      case Expression::id_kind: {
+        // Variables are named by references to their objects.
+        Typed_declaration* d = get_typed_declaration(r.ops[0]);
+        Type* dt = d->get_type();
+        if (d->is_variable())
+          dt = m_cxt.get_reference_type(dt);
+        if (t != dt)
+          invalid();
+
+        // The initializer of the declaration must precede the name, so
+        // that it cannot be evaluated while evaluating itself.
+        if (d->is_data() && !d->is_imported()) {
+          std::uint32_t init = m_decl_records[r.ops[0]].init;
+          if (init != none && init >= m_exprs.size())
+            invalid();
+          if (static_cast<Data_declaration*>(d)->has_automatic_storage())
+            m_locals.push_back(d);
+        }
+        return m_cxt.make_canonical<Id_expression>(t, d);
+      }
+
+      case Expression::init_kind: {
+        Typed_declaration* d = get_typed_declaration(r.ops[0]);
+        if (!d->is_variable() || d->is_imported())
+          invalid();
+        if (t != m_cxt.get_reference_type(d->get_type()))
+          invalid();
+        return m_cxt.make<Init_expression>(t, d);
+      }
+
+      case Expression::fold_kind: {
+        Expression* e = get_operand(r.ops[0], t);
+        std::intmax_t val = std::intmax_t(r.value[0] | std::uint64_t(r.value[1]) << 32);
+        if (!is_in_range(t, val))
+          invalid();
+        Value v = Value(Int_value(val));
+        return m_cxt.make_canonical<Folded_expression>(t, e, v);
+      }
+
+      case Expression::add_kind:
+        return make_binary<Addition_expression>(t, r);
+      case Expression::sub_kind:
+        return make_binary<Subtraction_expression>(t, r);
+      case Expression::mul_kind:
+        return make_binary<Multiplication_expression>(t, r);
+      case Expression::quo_kind:
+        return make_binary<Quotient_expression>(t, r);
+      case Expression::rem_kind:
+        return make_binary<Remainder_expression>(t, r);
+      case Expression::div_kind:
+        return make_binary<Division_expression>(t, r);
+      case Expression::neg_kind:
+        return make_unary<Negation_expression>(t, r);
+      case Expression::rec_kind:
+        return make_unary<Reciprocal_expression>(t, r);
+
+      case Expression::bit_and_kind:
+        return make_binary<Bitwise_and_expression>(t, r);
+      case Expression::bit_ior_kind:
+        return make_binary<Bitwise_or_expression>(t, r);
+      case Expression::bit_xor_kind:
+        return make_binary<Bitwise_xor_expression>(t, r);
+      case Expression::bit_not_kind:
+        return make_unary<Bitwise_not_expression>(t, r);
+      case Expression::bit_shl_kind:
+        return make_binary<Shift_left_expression>(t, r);
+      case Expression::bit_shr_kind:
+        return make_binary<Shift_right_expression>(t, r);
+
+      case Expression::cond_kind: {
+        Expression* e1 = get_operand(r.ops[0], m_cxt.get_bool_type());
+        Expression* e2 = get_operand(r.ops[1], t);
+        Expression* e3 = get_operand(r.ops[2], t);
+        return m_cxt.make_canonical<Conditional_expression>(t, e1, e2, e3, m_token, m_token);
+      }
+      case Expression::and_kind:
+        return make_binary<Logical_and_expression>(t, r);
+      case Expression::or_kind:
+        return make_binary<Logical_or_expression>(t, r);
+      case Expression::not_kind:
+        return make_unary<Logical_not_expression>(t, r);
+
+      case Expression::eq_kind:
+        return make_comparison<Equal_to_expression>(t, r);
+      case Expression::ne_kind:
+        return make_comparison<Not_equal_to_expression>(t, r);
+      case Expression::lt_kind:
+        return make_comparison<Less_than_expression>(t, r);
+      case Expression::gt_kind:
+        return make_comparison<Greater_than_expression>(t, r);
+      case Expression::ng_kind:
+        return make_comparison<Not_greater_than_expression>(t, r);
+      case Expression::nl_kind:
+        return make_comparison<Not_less_than_expression>(t, r);
+
+      case Expression::assign_kind: {
+        Type* obj = static_cast<Reference_type*>(t)->get_object_type();
+        Expression* e1 = get_operand(r.ops[0], t);
+        Expression* e2 = get_operand(r.ops[1], obj);
+        return m_cxt.make<Assignment_expression>(t, e1, e2, m_token);
+      }
+
+      case Expression::imp_conv: {
+        if (r.value[0] > Conversion::float_trunc)
+          invalid();
+        Conversion::Conversion_kind ck = Conversion::Conversion_kind(r.value[0]);
+        Expression* e = get_operand(r.ops[0]);
+        if (!is_conversion(ck, e->get_type(), t))
+          invalid();
+        return m_cxt.make_canonical<Implicit_conversion>(ck, t, e);
+      }
+
+      case Expression::empty_init:
+        return m_cxt.make<Empty_initializer>(get_object(r.ops[0]));
+      case Expression::def_init:
+        return m_cxt.make<Default_initializer>(get_object(r.ops[0]));
+      case Expression::val_init: {
+        Expression* obj = get_object(r.ops[0]);
+        Type* t = static_cast<Reference_type*>(obj->get_type())->get_object_type();
+        return m_cxt.make<Value_initializer>(obj, get_operand(r.ops[1], t));
+      }
+
+      default:
+        invalid();
+      }
+    }
+
+    /// Assertions at namespace scope cannot name local declarations.
+    void
+    Snapshot_loader::load_assertions()
+    {
+      for (std::uint32_t i = 0; i < m_header->decls; ++i) {
+        const Declaration_record& r = m_decl_records[i];
+        if (r.kind != Declaration::assert_kind || r.flags & imported_decl)
+          continue;
+        Scoped_declaration* owner = get_scope(r.owner);
+        if (!owner->is_translation_unit() && !owner->is_function())
+          invalid();
+        Expression* cond = get_expression(r.init, m_cxt.get_bool_type());
+        if (owner->is_translation_unit() && !m_expr_locals[r.init].empty())
+          invalid();
+        m_decls[i] = m_cxt.make<Assertion>(owner, cond, Location());
+      }
+    }
+
+    void
+    Snapshot_loader::load_statements()
+    {
+      m_stmts.reserve(m_header->stmts);
+      m_stmt_used.resize(m_header->stmts);
+      for (std::uint32_t i = 0; i < m_header->stmts; ++i)
+        m_stmts.push_back(make_statement(m_stmt_records[i]));
+    }
+
+    /// Conditions are bool expressions. Returned values are checked against
+    /// the function when its body is checked.
+    Statement*
+    Snapshot_loader::make_statement(const Statement_record& r)
+    {
+      switch (r.kind) {
+      case Statement::block_kind: {
+        const std::uint32_t* ops = get_list(r.first, r.count);
+        std::vector<Statement*> ss;
+        ss.reserve(r.count);
+        for (std::uint32_t j = 0; j < r.count; ++j)
+          ss.push_back(get_substatement(ops[j]));
+        Block_statement* b = m_cxt.make<Block_statement>();
+        b->set_statements(m_cxt.make_span(ss));
+        return b;
+      }
+
+      case Statement::when_kind:
+        return m_cxt.make<When_statement>(get_expression(r.ops[0], m_cxt.get_bool_type()),
+                                          get_substatement(r.ops[1]),
+                                          Location(), Location(), Location());
+
+      case Statement::if_kind:
+        return m_cxt.make<If_statement>(get_expression(r.ops[0], m_cxt.get_bool_type()),
+                                        get_substatement(r.ops[1]),
+                                        get_substatement(r.ops[2]),
+                                        Location(), Location(), Location(), Location());
+
+      case Statement::while_kind:
+        return m_cxt.make<While_statement>(get_expression(r.ops[0], m_cxt.get_bool_type()),
+                                           get_substatement(r.ops[1]),
+                                           Location(), Location(), Location());
+
+      case Statement::break_kind:
+        return m_cxt.make<Break_statement>(Location(), Location());
+
+      case Statement::cont_kind:
+        return m_cxt.make<Continue_statement>(Location(), Location());
+
+      case Statement::ret_kind:
+        return m_cxt.make<Return_statement>(get_expression(r.ops[0]), Location(), Location());
+
+      case Statement::expr_kind:
+        return m_cxt.make<Expression_statement>(get_expression(r.ops[0]), Location());
+
+      case Statement::decl_kind: {
+        Declaration* d = get_declaration(r.ops[0]);
+        if (!d->is_data() && d->get_kind() != Declaration::assert_kind)
+          invalid();
+        return m_cxt.make<Declaration_statement>(d);
+      }
+
+      default:
+        invalid();
+      }
+    }
+
+    /// Gives each declaration its specifiers, initializer, and body, and
+    /// adds the nested declarations of scoped declarations in their
+    /// original order. Each declaration is a member of at most one scope,
+    /// and every declaration at namespace scope is one.
+    void
+    Snapshot_loader::complete_declarations()
+    {
+      for (std::uint32_t i = 0; i < m_header->decls; ++i) {
+        const Declaration_record& r = m_decl_records[i];
+        if (r.flags & imported_decl)
+          continue;
+
+        Declaration* d = m_decls[i];
+        switch (d->get_kind()) {
+        case Declaration::func_kind: {
+          Function_declaration* fn = static_cast<Function_declaration*>(d);
+          Function_type* t = fn->get_type();
+          if (r.spec != none) {
+            Type_specifier* ts = get_specifier(r.spec);
+            if (ts->get_type() != t->get_return_type())
+              invalid();
+            fn->set_return(ts);
+          }
+
+          // Each parameter declares a distinct local of the function, with
+          // no default argument.
+          const std::uint32_t* ops = get_list(r.first, r.count);
+          const Type_seq& types = t->get_parameter_types();
+          if (r.count != types.size())
+            invalid();
+          std::vector<Parameter*> parms;
+          parms.reserve(r.count);
+          for (std::uint32_t j = 0; j < r.count; ++j) {
+            Declaration* p = get_declaration(ops[j]);
+            if (p->get_kind() != Declaration::parm_kind)
+              invalid();
+            Parameter* parm = static_cast<Parameter*>(p);
+            if (parm->get_enclosing_declaration() != fn || parm->get_type() != types[j])
+              invalid();
+            std::uint32_t n = m_decl_records[ops[j]].first;
+            if (m_declared[n] || m_decl_records[n].init != none)
+              invalid();
+            m_declared[n] = true;
+            parms.push_back(parm);
+          }
+          fn->set_parameters(m_cxt.make_span(parms));
+
+          Statement* s = get_substatement(r.body);
+          if (s->get_kind() != Statement::block_kind)
+            invalid();
+          fn->set_body(s);
+          break;
+        }
+
+        case Declaration::val_kind:
+        case Declaration::var_kind:
+        case Declaration::ref_kind: {
+          // The type of a reference is adjusted from its specifier.
+          Data_declaration* data = static_cast<Data_declaration*>(d);
+          if (r.spec != none) {
+            Type_specifier* ts = get_specifier(r.spec);
+            Type* t = ts->get_type();
+            if (data->is_reference())
+              t = m_cxt.get_reference_type(t);
+            if (t != data->get_type())
+              invalid();
+            data->set_type_specifier(ts);
+          }
+
+          // Variables are initialized through their init-expressions, and
+          // other data is bound to a value of its type.
+          if (r.init != none) {
+            Expression* init;
+            if (data->is_variable()) {
+              if (r.init >= m_exprs.size())
+                invalid();
+              init = m_exprs[r.init];
+              if (init->get_type())
+                invalid();
+              Expression* obj = static_cast<Initializer*>(init)->get_object();
+              if (static_cast<Init_expression*>(obj)->get_declaration() != data)
+                invalid();
+            }
+            else {
+              init = get_expression(r.init, data->get_type());
+            }
+            data->set_initializer(init);
+          }
+
+          // Data at namespace scope is initialized, and its initializer
+          // cannot name local declarations.
+          if (data->has_static_storage()) {
+            if (r.init == none || !m_expr_locals[r.init].empty())
+              invalid();
+          }
+          break;
+        }
+
+        default:
+          break;
+        }
+
+        Scoped_declaration* sd = d->get_as_scoped();
+        if (!sd)
+          continue;
+        const std::uint32_t* ops = get_list(r.members, r.member_count);
+        for (std::uint32_t j = 0; j < r.member_count; ++j) {
+          Declaration* m = get_declaration(ops[j]);
+          if (m->get_owner() != sd || m_members[ops[j]])
+            invalid();
+          m_members[ops[j]] = true;
+          if (m_decl_records[ops[j]].flags & visible_decl) {
+            if (m->get_kind() == Declaration::assert_kind)
+              invalid();
+            Named_declaration* nd = static_cast<Named_declaration*>(m);
+            if (!sd->lookup(nd->get_name()).is_empty())
+              invalid();
+            sd->add_visible_declaration(nd);
+          }
+          else {
+            sd->add_hidden_declaration(m);
+          }
+        }
+      }
+
+      for (std::uint32_t i = 1; i < m_header->decls; ++i) {
+        Declaration* d = m_decls[i];
+        if (d->get_enclosing_declaration()->is_translation_unit() && !m_members[i])
+          invalid();
+      }
+    }
+
+    /// The parameters of the function are in scope in its body.
+    void
+    Snapshot_loader::check_function(std::uint32_t n)
+    {
+      const Function_declaration* fn = static_cast<Function_declaration*>(m_decls[n]);
+      m_scope.clear();
+      for (const Parameter* p : fn->get_parameters())
+        m_scope.push_back(p->get_declaration());
+      check_statement(m_decl_records[n].body, fn, 0);
+    }
+
+    /// Checks that the statement `n` in the body of `fn` names only the
+    /// local declarations in scope, each of which is declared once. The
+    /// number of enclosing loops is `loops`.
+    void
+    Snapshot_loader::check_statement(std::uint32_t n, const Function_declaration* fn, int loops)
+    {
+      const Statement_record& r = m_stmt_records[n];
+      switch (r.kind) {
+      case Statement::block_kind: {
+        std::size_t size = m_scope.size();
+        const std::uint32_t* ops = m_lists + r.first;
+        for (std::uint32_t j = 0; j < r.count; ++j)
+          check_statement(ops[j], fn, loops);
+        m_scope.resize(size);
+        break;
+      }
+
+      case Statement::when_kind:
+        check_locals(r.ops[0]);
+        check_statement(r.ops[1], fn, loops);
+        break;
+
+      case Statement::if_kind:
+        check_locals(r.ops[0]);
+        check_statement(r.ops[1], fn, loops);
+        check_statement(r.ops[2], fn, loops);
+        break;
+
+      case Statement::while_kind:
+        check_locals(r.ops[0]);
+        check_statement(r.ops[1], fn, loops + 1);
+        break;
+
+      case Statement::break_kind:
+      case Statement::cont_kind:
+        if (!loops)
+          invalid();
+        break;
+
+      case Statement::ret_kind:
+        if (m_exprs[r.ops[0]]->get_type() != fn->get_return_type())
+          invalid();
+        check_locals(r.ops[0]);
+        break;
+
+      case Statement::expr_kind:
+        check_locals(r.ops[0]);
+        break;
+
+      case Statement::decl_kind: {
+        // Local variables are generated only with value initializers.
+        Declaration* d = m_decls[r.ops[0]];
+        const Declaration_record& dr = m_decl_records[r.ops[0]];
+        if (d->get_enclosing_declaration() != fn)
+          invalid();
+        if (d->is_data()) {
+          if (m_declared[r.ops[0]] || dr.init == none)
+            invalid();
+          if (d->is_variable() && m_exprs[dr.init]->get_kind() != Expression::val_init)
+            invalid();
+          check_locals(dr.init);
+          m_declared[r.ops[0]] = true;
+          m_scope.push_back(d);
+        }
+        else {
+          check_locals(dr.init);
+        }
+        break;
+      }
+
+      default:
+        break;
+      }
+    }
+
+    /// Checks that the local declarations named by the expression `n` are
+    /// in scope.
+    void
+    Snapshot_loader::check_locals(std::uint32_t n)
+    {
+      for (const Declaration* d : m_expr_locals[n]) {
+        if (std::find(m_scope.begin(), m_scope.end(), d) == m_scope.end())
+          invalid();
+      }
+    }
+
+    /// Returns the `count` list entries starting at `first`.
+    const std::uint32_t*
+    Snapshot_loader::get_list(std::uint32_t first, std::uint64_t count)
+    {
+      if (first > m_header->lists || count > m_header->lists - first)
+        invalid();
+      return m_lists + first;
+    }
+
+    Symbol
+    Snapshot_loader::get_symbol(std::uint32_t n)
+    {
+      if (n >= m_symbols.size())
+        invalid();
+      return m_symbols[n];
+    }
+
+    Type*
+    Snapshot_loader::get_type(std::uint32_t n)
+    {
+      if (n >= m_types.size())
+        invalid();
+      return m_types[n];
+    }
+
+    Declaration*
+    Snapshot_loader::get_declaration(std::uint32_t n)
+    {
+      if (n >= m_decls.size() || !m_decls[n])
+        invalid();
+      return m_decls[n];
+    }
+
+    Scoped_declaration*
+    Snapshot_loader::get_scope(std::uint32_t n)
+    {
+      Scoped_declaration* sd = get_declaration(n)->get_as_scoped();
+      if (!sd)
+        invalid();
+      return sd;
+    }
+
+    Typed_declaration*
+    Snapshot_loader::get_typed_declaration(std::uint32_t n)
+    {
+      Declaration* d = get_declaration(n);
+      if (!d->is_typed())
+        invalid();
+      return static_cast<Typed_declaration*>(d);
+    }
+
+    Type_specifier*
+    Snapshot_loader::get_specifier(std::uint32_t n)
+    {
+      if (n >= m_specs.size())
+        invalid();
+      return m_specs[n];
+    }
+
+    /// Returns the expression `n`, which has a value. Initializers and
+    /// init-expressions are used only to initialize variables.
+    Expression*
+    Snapshot_loader::get_expression(std::uint32_t n)
+    {
+      if (n >= m_exprs.size())
+        invalid();
+      Expression* e = m_exprs[n];
+      if (!e->get_type() || e->get_kind() == Expression::init_kind)
+        invalid();
+      return e;
+    }
+
+    /// Returns the expression `n`, which has type `t`.
+    Expression*
+    Snapshot_loader::get_expression(std::uint32_t n, const Type* t)
+    {
+      Expression* e = get_expression(n);
+      if (e->get_type() != t)
+        invalid();
+      return e;
+    }
+
+    /// Returns the expression `n` as an operand of the expression being
+    /// rebuilt, which names the local declarations named by `n`.
+    Expression*
+    Snapshot_loader::get_operand(std::uint32_t n)
+    {
+      Expression* e = get_expression(n);
+      for (const Declaration* d : m_expr_locals[n]) {
+        if (std::find(m_locals.begin(), m_locals.end(), d) == m_locals.end())
+          m_locals.push_back(d);
+      }
+      return e;
+    }
+
+    Expression*
+    Snapshot_loader::get_operand(std::uint32_t n, const Type* t)
+    {
+      Expression* e = get_operand(n);
+      if (e->get_type() != t)
+        invalid();
+      return e;
+    }
+
+    /// Returns the init-expression `n`, which is the object of an
+    /// initializer.
+    Expression*
+    Snapshot_loader::get_object(std::uint32_t n)
+    {
+      if (n >= m_exprs.size() || m_exprs[n]->get_kind() != Expression::init_kind)
+        invalid();
+      return m_exprs[n];
+    }
+
+    Statement*
+    Snapshot_loader::get_statement(std::uint32_t n)
+    {
+      if (n >= m_stmts.size())
+        invalid();
+      return m_stmts[n];
+    }
+
+    /// Returns the statement `n` as part of a function body. Statements are
+    /// not shared, so each is part of one body at most once.
+    Statement*
+    Snapshot_loader::get_substatement(std::uint32_t n)
+    {
+      Statement* s = get_statement(n);
+      if (m_stmt_used[n])
+        invalid();
+      m_stmt_used[n] = true;
+      return s;
+    }
+
+    void
+    Snapshot_loader::invalid() const
+    {
+      std::stringstream ss;
+      ss << "invalid snapshot '" << m_file.get_path() << "'";
+      throw std::runtime_error(ss.str());
+    }
+
+  } // namespace
+
+  void
+  write_snapshot(std::ostream& os, const Translation_unit* tu)
+  {
+    Snapshot_writer w;
+    w.add_declaration(tu);
+    w.write(os);
+  }
+
+  Translation_unit*
+  load_snapshot(Context& cxt, const std::string& path)
+  {
+    Snapshot_loader loader(cxt, path);
+    return loader.load();
+  }
+
+} // namespace beaker
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <beaker/common.hpp>
+
+#include <iosfwd>
+#include <string>
+
+namespace beaker
+{
+  class Translation_unit;
+
+  /// Writes a snapshot of the analyzed module `tu` to `os`. The snapshot
+  /// holds every declaration, type specifier, expression, and statement of
+  /// the module, and the types and symbols they use.
+  ///
+  /// Source locations are not saved, since they are offsets into source
+  /// files that are not part of the snapshot.
+  void write_snapshot(std::ostream& os, const Translation_unit* tu);
+
+  /// Loads the snapshot at `path` into the context and returns its
+  /// translation unit. The module is ready for code generation; it is
+  /// neither parsed nor analyzed. Modules imported by the snapshot are
+  /// found in the import directories of the context.
+  ///
+  /// The snapshot is mapped into memory. Its nodes refer to one another by
+  /// index rather than by address, so that the file is position
+  /// independent, and every node follows the nodes it refers to, except
+  /// that declarations precede the expressions and statements that name
+  /// them. This allows the tree to be rebuilt in a single pass over each
+  /// table. Symbols, types, and canonical expressions are interned in the
+  /// context as they are rebuilt.
+  Translation_unit* load_snapshot(Context& cxt, const std::string& path);
+
+} // namespace beaker
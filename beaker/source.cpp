@@ -0,0 +1,214 @@
+#include "source.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define BEAKER_X86_SIMD
+#endif
+
+namespace beaker
+{
+  std::ostream&
+  operator<<(std::ostream& os, const Source_location& loc)
+  {
+    return os << loc.file->get_path() << ':' << loc.line << ':' << loc.column;
+  }
+
+  // ------------------------------------------------------------------------ //
+  // Newline scanning
+
+  /// Stores the offsets of the first character of each line.
+  using Line_table = std::vector<unsigned>;
+
+  /// Appends the offset just past each newline in [first, last) to `lines`.
+  /// Offsets are relative to `base`.
+  static void
+  scan_newlines_scalar(const char* base, 
+                       const char* first, 
+                       const char* last, 
+                       Line_table& lines)
+  {
+    while (first != last) {
+      const void* p = std::memchr(first, '\n', last - first);
+      if (!p)
+        break;
+      first = static_cast<const char*>(p) + 1;
+      lines.push_back(first - base);
+    }
+  }
+
+#if defined(BEAKER_X86_SIMD)
+  /// Appends a line start for each bit set in `mask`, which marks the
+  /// newlines in the block starting at `p`.
+  static inline void
+  add_newlines(const char* base, const char* p, unsigned mask, Line_table& lines)
+  {
+    while (mask) {
+      unsigned n = __builtin_ctz(mask);
+      lines.push_back(p - base + n + 1);
+      mask &= mask - 1;
+    }
+  }
+
+  /// Scans 16 bytes at a time.
+  __attribute__((target("sse2"))) static void
+  scan_newlines_sse2(const char* base, 
+                     const char* first, 
+                     const char* last, 
+                     Line_table& lines)
+  {
+    const __m128i nl = _mm_set1_epi8('\n');
+    for (; last - first >= 16; first += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+      unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+      add_newlines(base, first, mask, lines);
+    }
+    scan_newlines_scalar(base, first, last, lines);
+  }
+
+  /// Scans 32 bytes at a time.
+  __attribute__((target("avx2"))) static void
+  scan_newlines_avx2(const char* base, 
+                     const char* first, 
+                     const char* last, 
+                     Line_table& lines)
+  {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    for (; last - first >= 32; first += 32) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+      unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl));
+      add_newlines(base, first, mask, lines);
+    }
+    scan_newlines_scalar(base, first, last, lines);
+  }
+#endif
+
+  /// Builds the line table for `text`, using the widest vector unit that
+  /// is available at runtime.
+  static void
+  build_line_table(Text_view text, Line_table& lines)
+  {
+    // Guess about 40 characters per line to avoid most reallocations.
+    lines.reserve(text.size() / 40 + 1);
+    lines.push_back(0);
+#if defined(BEAKER_X86_SIMD)
+    if (__builtin_cpu_supports("avx2"))
+      return scan_newlines_avx2(text.data(), text.begin(), text.end(), lines);
+    if (__builtin_cpu_supports("sse2"))
+      return scan_newlines_sse2(text.data(), text.begin(), text.end(), lines);
+#endif
+    scan_newlines_scalar(text.data(), text.begin(), text.end(), lines);
+  }
+
+  // ------------------------------------------------------------------------ //
+  // Source manager
+
+  /// A registered file and its lazily computed line table.
+  struct Source_manager::Source_file
+  {
+    Source_file(const std::string& path, unsigned base)
+      : file(path, base)
+    { }
+
+    /// Returns the line table, building it if needed.
+    const Line_table& get_lines() const
+    {
+      std::call_once(once, [this]() {
+        build_line_table(file.get_text(), lines);
+      });
+      return lines;
+    }
+
+    File file;
+    mutable std::once_flag once;
+    mutable Line_table lines;
+  };
+
+  Source_manager::Source_manager()
+    : m_next(0)
+  { }
+
+  Source_manager::~Source_manager()
+  { }
+
+  const File&
+  Source_manager::add_file(const std::string& path)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.emplace_back(new Source_file(path, m_next));
+    const File& f = m_files.back()->file;
+
+    // Reserve the offset past the end of the file (e.g., for the location
+    // of an end-of-file token) so that it is not shared with the next file.
+    m_next = f.get_limit_offset() + 1;
+    return f;
+  }
+
+  auto
+  Source_manager::find(Location loc) const -> const Source_file*
+  {
+    if (!loc)
+      return nullptr;
+
+    unsigned off = loc.get_offset();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = std::upper_bound(m_files.begin(), m_files.end(), off, 
+      [](unsigned off, const std::unique_ptr<Source_file>& sf) {
+        return off < sf->file.get_base_offset();
+      });
+    if (iter == m_files.begin())
+      return nullptr;
+    const Source_file* sf = std::prev(iter)->get();
+    if (off > sf->file.get_limit_offset())
+      return nullptr;
+    return sf;
+  }
+
+  const File*
+  Source_manager::get_file(Location loc) const
+  {
+    if (const Source_file* sf = find(loc))
+      return &sf->file;
+    return nullptr;
+  }
+
+  Source_location
+  Source_manager::get_source_location(Location loc) const
+  {
+    const Source_file* sf = find(loc);
+    if (!sf)
+      return {};
+
+    // Find the last line starting at or before the offset.
+    unsigned off = loc.get_offset() - sf->file.get_base_offset();
+    const Line_table& lines = sf->get_lines();
+    auto iter = std::upper_bound(lines.begin(), lines.end(), off);
+    unsigned line = iter - lines.begin();
+    unsigned column = off - *std::prev(iter) + 1;
+    return {&sf->file, line, column};
+  }
+
+  // ------------------------------------------------------------------------ //
+  // Source errors
+
+  /// Returns the formatted location, or the empty string if `loc` is
+  /// invalid.
+  static std::string
+  format_location(const Source_location& loc)
+  {
+    if (!loc)
+      return {};
+    std::stringstream ss;
+    ss << loc;
+    return ss.str();
+  }
+
+  Source_error::Source_error(const Source_location& loc, const std::string& msg)
+    : std::runtime_error(msg), m_loc(format_location(loc))
+  { }
+
+} // namespace beaker
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <beaker/file.hpp>
+#include <beaker/location.hpp>
+
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace beaker
+{
+  /// A location resolved to a file, line, and column. Lines and columns
+  /// are numbered from 1. Columns count bytes, not characters.
+  struct Source_location
+  {
+    Source_location()
+      : file(), line(), column()
+    { }
+
+    Source_location(const File* f, unsigned l, unsigned c)
+      : file(f), line(l), column(c)
+    { }
+
+    /// Converts to true if the location was resolved.
+    explicit operator bool() const { return file != nullptr; }
+
+    const File* file;
+    unsigned line;
+    unsigned column;
+  };
+
+  /// Writes the location as `path:line:column`.
+  std::ostream& operator<<(std::ostream& os, const Source_location& loc);
+
+
+  /// Owns the source files of a translation and assigns each a disjoint
+  /// range of offsets, so that a single Location identifies both a file and
+  /// a position within it.
+  ///
+  /// The line table of a file is built the first time a location in that
+  /// file is resolved. Files can be added and locations resolved from
+  /// multiple threads.
+  class Source_manager
+  {
+  public:
+    Source_manager();
+    ~Source_manager();
+
+    /// Opens the file at `path` and assigns it the next available range
+    /// of offsets.
+    const File& add_file(const std::string& path);
+
+    /// Returns the file containing `loc`, or nullptr if `loc` is invalid
+    /// or not in any registered file.
+    const File* get_file(Location loc) const;
+
+    /// Returns the file, line, and column of `loc`. The result is invalid
+    /// if `loc` is not in any registered file.
+    Source_location get_source_location(Location loc) const;
+
+  private:
+    struct Source_file;
+
+    const Source_file* find(Location loc) const;
+
+    /// The files, ordered by base offset.
+    std::vector<std::unique_ptr<Source_file>> m_files;
+
+    /// The base offset of the next file.
+    unsigned m_next;
+
+    /// Guards the list of files.
+    mutable std::mutex m_mutex;
+  };
+
+
+  /// An error that refers to a location in the source. The location is
+  /// formatted when the error is thrown, so that the error remains usable
+  /// after its source files have been closed.
+  class Source_error : public std::runtime_error
+  {
+  public:
+    Source_error(const Source_location& loc, const std::string& msg);
+
+    /// Returns the formatted location, which is empty if the location was
+    /// not resolved.
+    const std::string& get_location() const { return m_loc; }
+
+  private:
+    std::string m_loc;
+  };
+
+} // namespace beaker
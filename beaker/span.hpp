@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace beaker
+{
+  /// An immutable view of a contiguous sequence of objects. Syntax trees
+  /// use spans for their lists of children, which are copied into the
+  /// context's arena once complete, so that a node stores only a pointer
+  /// and a 32-bit count rather than a vector.
+  template<typename T>
+  class Span
+  {
+  public:
+    using value_type = T;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    /// Constructs an empty span.
+    Span()
+      : m_data(), m_size()
+    { }
+
+    /// Constructs a span of the `n` objects starting at `p`.
+    Span(const T* p, std::size_t n)
+      : m_data(p), m_size(n)
+    {
+      assert(m_size == n && "span too large");
+    }
+
+    /// Returns the number of objects in the span.
+    std::size_t size() const { return m_size; }
+
+    /// Returns true if the span has no objects.
+    bool empty() const { return m_size == 0; }
+
+    /// Returns the nth object in the span.
+    const T& operator[](std::size_t n) const { assert(n < m_size); return m_data[n]; }
+
+    /// Returns the first object in the span.
+    const T& front() const { assert(m_size); return m_data[0]; }
+
+    /// Returns the last object in the span.
+    const T& back() const { assert(m_size); return m_data[m_size - 1]; }
+
+    /// Returns an iterator to the first object in the span.
+    iterator begin() const { return m_data; }
+
+    /// Returns an iterator past the last object in the span.
+    iterator end() const { return m_data + m_size; }
+
+  private:
+    /// The first object.
+    const T* m_data;
+
+    /// The number of objects.
+    std::uint32_t m_size;
+  };
+
+} // namespace beaker
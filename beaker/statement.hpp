@@ -1,6 +1,7 @@
 #pragma once
 
 #include <beaker/common.hpp>
+#include <beaker/arena.hpp>
 #include <beaker/token.hpp>
 
 namespace beaker
@@ -65,21 +66,17 @@ namespace beaker
   class Block_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == block_kind; }
+
     Block_statement()
       : Statement(block_kind), m_braces{}
     { }
 
     /// Returns the sequence of statements.
-    const Statement_seq& get_statements() const { return m_stmts; }
-
-    /// Set the statements for the block scope.
-    void set_statements(const Statement_seq& ss) { m_stmts = ss; }
+    Statement_list get_statements() const { return m_stmts; }
 
     /// Set the statements for the block scope.
-    void set_statements(Statement_seq&& ss) { m_stmts = std::move(ss); }
-
-    /// Adds a statement to the current block.
-    void add_statement(Statement* s) { m_stmts.push_back(s); }
+    void set_statements(Statement_list ss) { m_stmts = ss; }
 
     /// Returns the start location of the this statement.
     Location get_start_location() const override { return m_braces[0]; }
@@ -91,11 +88,11 @@ namespace beaker
     void set_brace_locations(Location lbrace, Location rbrace);
   
   private:
-    /// The nested sequence of statements.
-    Statement_seq m_stmts;
-
     /// The opening and closing braces.
     Location m_braces[2];
+
+    /// The nested sequence of statements.
+    Statement_list m_stmts;
   };
 
   inline void
@@ -110,12 +107,14 @@ namespace beaker
   class When_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == when_kind; }
+
     When_statement(Expression* e, 
                    Statement* s, 
                    Location start, 
                    Location lp, 
                    Location rp)
-      : Statement(when_kind), m_cond(e), m_true(s), m_locs{start, lp, rp}
+      : Statement(when_kind), m_locs{start, lp, rp}, m_cond(e), m_true(s)
     { }
 
     /// Returns the condition.
@@ -125,14 +124,14 @@ namespace beaker
     Statement* get_true_branch() const { return m_true; }
 
   private:
+    /// The locations of 'if', '(', and ')', respectively.
+    Location m_locs[3];
+
     /// The condition.
     Expression* m_cond;
 
     /// The statement to execute when the condition is true.
     Statement* m_true;
-
-    /// The locations of 'if', '(', and ')', respectively.
-    Location m_locs[3];
   };
 
 
@@ -140,6 +139,8 @@ namespace beaker
   class If_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == if_kind; }
+
     If_statement(Expression* e, 
                  Statement* s1, 
                  Statement* s2, 
@@ -147,7 +148,7 @@ namespace beaker
                  Location lp, 
                  Location rp,
                  Location el)
-      : Statement(if_kind), m_cond(e), m_true(s1), m_false(s2), m_locs{start, lp, rp, el}
+      : Statement(if_kind), m_locs{start, lp, rp, el}, m_cond(e), m_true(s1), m_false(s2)
     { }
 
     /// Returns the condition.
@@ -160,6 +161,9 @@ namespace beaker
     Statement* get_false_branch() const { return m_false; }
 
   private:
+    /// The locations of 'if', '(', ')', and 'else' respectively.
+    Location m_locs[4];
+
     /// The condition.
     Expression* m_cond;
 
@@ -168,9 +172,6 @@ namespace beaker
 
     /// The statement to execute when the condition is false.
     Statement* m_false;
-
-    /// The locations of 'if', '(', ')', and 'else' respectively.
-    Location m_locs[5];
   };
 
 
@@ -178,12 +179,14 @@ namespace beaker
   class While_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == while_kind; }
+
     While_statement(Expression* e, 
                     Statement* s, 
                     Location start, 
                     Location lp, 
                     Location rp)
-      : Statement(while_kind), m_cond(e), m_body(s), m_locs{start, lp, rp}
+      : Statement(while_kind), m_locs{start, lp, rp}, m_cond(e), m_body(s)
     { }
 
     /// Returns the condition.
@@ -193,14 +196,14 @@ namespace beaker
     Statement* get_body() const { return m_body; }
 
   private:
+    /// The locations of 'while', '(', and ')', respectively.
+    Location m_locs[3];
+
     /// The condition.
     Expression* m_cond;
 
     /// The loop body.
     Statement* m_body;
-
-    /// The locations of 'while', '(', and ')', respectively.
-    Location m_locs[3];
   };
 
 
@@ -208,6 +211,8 @@ namespace beaker
   class Break_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == break_kind; }
+
     Break_statement(Location kw, Location semi)
       : Statement(break_kind), m_locs{kw, semi}
     { }
@@ -222,6 +227,8 @@ namespace beaker
   class Continue_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == cont_kind; }
+
     Continue_statement(Location kw, Location semi)
       : Statement(cont_kind), m_locs{kw, semi}
     { }
@@ -236,19 +243,21 @@ namespace beaker
   class Return_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == ret_kind; }
+
     Return_statement(Expression* e, Location kw, Location semi)
-      : Statement(ret_kind), m_expr(e), m_locs{kw, semi}
+      : Statement(ret_kind), m_locs{kw, semi}, m_expr(e)
     { }
 
     /// Returns the expression.
     Expression* get_return_value() const { return m_expr; }
 
   private:
-    /// The computed return value.
-    Expression* m_expr;
-
     /// The location of `return`  and ';', respectively.
     Location m_locs[2];
+
+    /// The computed return value.
+    Expression* m_expr;
   };
 
 
@@ -256,19 +265,21 @@ namespace beaker
   class Expression_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == expr_kind; }
+
     Expression_statement(Expression* e, Location semi)
-      : Statement(expr_kind), m_expr(e), m_loc(semi)
+      : Statement(expr_kind), m_loc(semi), m_expr(e)
     { }
 
     /// Returns the expression.
     Expression* get_expression() const { return m_expr; }
 
   private:
-    /// The computed return value.
-    Expression* m_expr;
-
     /// The location of the `;`.
     Location m_loc;
+
+    /// The computed return value.
+    Expression* m_expr;
   };
 
 
@@ -276,6 +287,8 @@ namespace beaker
   class Declaration_statement : public Statement
   {
   public:
+    static bool classof(const Statement* p) { return p->get_kind() == decl_kind; }
+
     Declaration_statement(Declaration* d)
       : Statement(decl_kind), m_decl(d)
     { }
@@ -287,4 +300,11 @@ namespace beaker
     Declaration* m_decl;
   };
 
+
+  /// Statements own no resources, so they are never destroyed by an arena.
+  template<typename T>
+  struct Arena_destroy<T, std::enable_if_t<std::is_base_of<Statement, T>::value>>
+    : std::false_type
+  { };
+
 } // namespace beaker
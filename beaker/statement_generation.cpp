@@ -43,11 +43,16 @@ namespace beaker
     assert(false);
   }
 
+  /// Statements following one that terminates the current block (e.g., a
+  /// return) are unreachable and are not generated.
   void
   Instruction_generator::generate_block_statement(const Block_statement* s)
   {
-    for (Statement* sub : s->get_statements())
+    for (Statement* sub : s->get_statements()) {
+      if (is_terminated())
+        break;
       generate_statement(sub);
+    }
   }
 
   void
@@ -61,11 +66,14 @@ namespace beaker
     llvm::IRBuilder<> ir1(get_current_block());
     ir1.CreateCondBr(v, true_block, end_block);
 
-    // Emit the true block and jump to end.
+    // Emit the true block and jump to end, unless the branch has already
+    // left the block.
     emit_block(true_block);
     generate_statement(s->get_true_branch());
-    llvm::IRBuilder<> ir2(get_current_block());
-    ir2.CreateBr(end_block);
+    if (!is_terminated()) {
+      llvm::IRBuilder<> ir2(get_current_block());
+      ir2.CreateBr(end_block);
+    }
 
     // Make the end block active.
     emit_block(end_block);
@@ -83,17 +91,22 @@ namespace beaker
     llvm::IRBuilder<> ir1(get_current_block());
     ir1.CreateCondBr(v, true_block, false_block);
 
-    // Emit the true block and jump to end.
+    // Emit the true block and jump to end, unless the branch has already
+    // left the block.
     emit_block(true_block);
     generate_statement(s->get_true_branch());
-    llvm::IRBuilder<> ir2(get_current_block());
-    ir2.CreateBr(end_block);
+    if (!is_terminated()) {
+      llvm::IRBuilder<> ir2(get_current_block());
+      ir2.CreateBr(end_block);
+    }
 
-    // Emit the false block and jump to end.
+    // Emit the false block and jump to end, likewise.
     emit_block(false_block);
     generate_statement(s->get_false_branch());
-    llvm::IRBuilder<> ir3(get_current_block());
-    ir3.CreateBr(end_block);
+    if (!is_terminated()) {
+      llvm::IRBuilder<> ir3(get_current_block());
+      ir3.CreateBr(end_block);
+    }
 
     // Make the end block active.
     emit_block(end_block);
@@ -116,11 +129,14 @@ namespace beaker
     llvm::IRBuilder<> ir2(get_current_block());
     ir2.CreateCondBr(cond, do_block, end_block);
 
-    // Emit the loop body and jump to the top.
+    // Emit the loop body and jump to the top, unless the body has already
+    // left the block.
     emit_block(do_block);
     generate_statement(s->get_body());
-    llvm::IRBuilder<> ir3(get_current_block());
-    ir3.CreateBr(if_block);
+    if (!is_terminated()) {
+      llvm::IRBuilder<> ir3(get_current_block());
+      ir3.CreateBr(if_block);
+    }
 
     // Make the end block active.
     emit_block(end_block);
@@ -193,8 +209,12 @@ namespace beaker
   void
   Instruction_generator::generate_variable_declaration(const Variable_declaration* d)
   {
-    // Create the storage for the variable in the entry block.
-    llvm::IRBuilder<> ir(get_entry_block());
+    // Create the storage for the variable in the entry block. If the entry
+    // block has been terminated, the storage precedes its terminator.
+    llvm::BasicBlock* entry = get_entry_block();
+    llvm::IRBuilder<> ir(entry);
+    if (llvm::Instruction* term = entry->getTerminator())
+      ir.SetInsertPoint(term);
     llvm::Type* type = generate_type(d);
     llvm::Value* addr = ir.CreateAlloca(type);
     declare(d, addr);
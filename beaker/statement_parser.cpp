@@ -182,7 +182,7 @@ namespace beaker
     default:
       break;
     }
-    throw std::runtime_error("expected local-declaration");
+    syntax_error("expected local-declaration");
   }
 
   /// FIXME: This is duplicated elsewhere.
@@ -14,7 +14,7 @@ namespace beaker
   Statement*
   Semantics::on_start_block_statement()
   {
-    return new Block_statement();
+    return m_cxt.make<Block_statement>();
   }
 
   Statement*
@@ -26,7 +26,7 @@ namespace beaker
     Block_statement* bs = static_cast<Block_statement*>(s);
 
     // Update the statement.
-    bs->set_statements(std::move(ss));
+    bs->set_statements(m_cxt.make_span(ss));
     bs->set_brace_locations(lbrace.get_location(), rbrace.get_location());
 
     return bs;
@@ -47,7 +47,7 @@ namespace beaker
     Location start = kw.get_location();
     Location lloc = lparen.get_location();
     Location rloc = rparen.get_location();
-    return new When_statement(e, s, start, lloc, rloc);
+    return m_cxt.make<When_statement>(e, s, start, lloc, rloc);
   }
 
   Statement*
@@ -68,7 +68,7 @@ namespace beaker
     Location lloc = lparen.get_location();
     Location rloc = rparen.get_location();
     Location eloc = kw2.get_location();
-    return new If_statement(e, s1, s2, start, lloc, rloc, eloc);
+    return m_cxt.make<If_statement>(e, s1, s2, start, lloc, rloc, eloc);
   }
 
   Statement*
@@ -86,7 +86,7 @@ namespace beaker
     Location start = kw.get_location();
     Location lloc = lparen.get_location();
     Location rloc = rparen.get_location();
-    return new While_statement(e, s, start, lloc, rloc);
+    return m_cxt.make<While_statement>(e, s, start, lloc, rloc);
   }
 
   Statement*
@@ -96,7 +96,7 @@ namespace beaker
     // FIXME: Verify that break is valid in this context.
     Location start = kw.get_location();
     Location end = semi.get_location();
-    return new Break_statement(start, end);
+    return m_cxt.make<Break_statement>(start, end);
   }
 
   Statement*
@@ -105,7 +105,7 @@ namespace beaker
   {
     Location start = kw.get_location();
     Location end = semi.get_location();
-    return new Continue_statement(start, end);
+    return m_cxt.make<Continue_statement>(start, end);
   }
 
   Statement*
@@ -120,14 +120,14 @@ namespace beaker
     // Create the statement.
     Location start = kw.get_location();
     Location end = semi.get_location();
-    return new Return_statement(e, start, end);
+    return m_cxt.make<Return_statement>(e, start, end);
   }
 
   Statement*
   Semantics::on_declaration_statement(Declaration* d)
   {
     // FIXME: Is there really nothing to do here?
-    return new Declaration_statement(d);
+    return m_cxt.make<Declaration_statement>(d);
   }
 
   Statement*
@@ -138,7 +138,7 @@ namespace beaker
     //
     // FIXME: Is there any analysis we need to do?
     Location end = semi.get_location();
-    return new Expression_statement(e, end);
+    return m_cxt.make<Expression_statement>(e, end);
   }
 
   // Conditions
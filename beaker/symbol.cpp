@@ -1,14 +1,91 @@
 #include "symbol.hpp"
+#include "hash.hpp"
+#include "arena.hpp"
+#include "factory.hpp"
 
 #include <iostream>
+#include <new>
 
 namespace beaker
 {
-  std::ostream& 
+  std::ostream&
+  operator<<(std::ostream& os, const Symbol_string& str)
+  {
+    return os.write(str.data(), str.size());
+  }
+
+  std::ostream&
   operator<<(std::ostream& os, Symbol sym)
   {
     return os << *sym;
   }
 
-} // namespace beaker
+  struct Symbol_table::Shard
+  {
+    Symbol allocate(const char* str, std::size_t n, std::size_t h, std::uint32_t id);
+
+    /// Guards the shard.
+    std::mutex mutex;
+
+    /// The symbols in the shard.
+    Intern_table<const Symbol_string> table;
+
+    /// Holds the spellings.
+    Arena arena;
+  };
+
+  /// Copies the spelling into the arena.
+  Symbol
+  Symbol_table::Shard::allocate(const char* str, std::size_t n, std::size_t h, std::uint32_t id)
+  {
+    void* p = arena.allocate(sizeof(Symbol_string) + n + 1, alignof(Symbol_string));
+    Symbol_string* sym = new (p) Symbol_string(h, n, id);
+    char* chars = static_cast<char*>(p) + sizeof(Symbol_string);
+    std::memcpy(chars, str, n);
+    chars[n] = 0;
+    return sym;
+  }
+
+  Symbol_table::Symbol_table()
+    : m_shards(new Shard[shard_count]), m_next_id(0)
+  { }
 
+  Symbol_table::~Symbol_table()
+  { }
+
+  Symbol
+  Symbol_table::get(const char* str, std::size_t n)
+  {
+    Hasher hash;
+    hash(str, n);
+    std::size_t h = static_cast<std::size_t>(hash);
+
+    // Select the shard by the high bits so that the low bits remain
+    // useful within the shard.
+    Shard& s = m_shards[h >> (sizeof(std::size_t) * 8 - shard_bits)];
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.table.get(h, [str, n](Symbol sym) {
+      return sym->size() == n && std::memcmp(sym->data(), str, n) == 0;
+    }, [this, &s, str, n, h]() {
+      return s.allocate(str, n, h, m_next_id++);
+    });
+  }
+
+  std::size_t
+  Symbol_table::size() const
+  {
+    return get_statistics().size;
+  }
+
+  Intern_statistics
+  Symbol_table::get_statistics() const
+  {
+    Intern_statistics stats = Intern_statistics();
+    for (std::size_t i = 0; i < shard_count; ++i) {
+      std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+      stats += m_shards[i].table.get_statistics();
+    }
+    return stats;
+  }
+
+} // namespace beaker
@@ -1,30 +1,131 @@
 #pragma once
 
+#include <beaker/factory.hpp>
+#include <beaker/hash.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iosfwd>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_set>
+#include <vector>
 
 namespace beaker
 {
+  /// The spelling of a symbol. Spellings are allocated in the arena of a
+  /// symbol table, immediately followed by their null-terminated
+  /// characters. The hash of the spelling is computed once, when the
+  /// symbol is created.
+  ///
+  /// Each symbol also has an id, which is unique within its table. Ids are
+  /// assigned densely from 0, so that information about symbols can be
+  /// kept in vectors indexed by id.
+  class Symbol_string
+  {
+    friend class Symbol_table;
+
+    Symbol_string(std::size_t h, std::size_t n, std::uint32_t id)
+      : m_hash(h), m_size(n), m_id(id)
+    { }
+
+  public:
+    Symbol_string(const Symbol_string&) = delete;
+    Symbol_string& operator=(const Symbol_string&) = delete;
+
+    /// Returns the number of characters in the spelling.
+    std::size_t size() const { return m_size; }
+
+    /// Returns true if the spelling is empty.
+    bool empty() const { return m_size == 0; }
+
+    /// Returns the characters of the spelling.
+    const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+
+    /// Returns the null-terminated spelling.
+    const char* c_str() const { return data(); }
+
+    /// Returns a copy of the spelling.
+    std::string str() const { return std::string(data(), m_size); }
+
+    /// Returns the precomputed hash of the spelling.
+    std::size_t hash() const { return m_hash; }
+
+    /// Returns the id of the symbol.
+    std::uint32_t id() const { return m_id; }
+
+    // Iterators
+    const char* begin() const { return data(); }
+    const char* end() const { return data() + m_size; }
+
+  private:
+    std::size_t m_hash;
+    std::uint32_t m_size;
+    std::uint32_t m_id;
+  };
+
+  std::ostream& operator<<(std::ostream& os, const Symbol_string& str);
+
+  /// Appends the spelling of `str` to `h`. Only the precomputed hash of
+  /// the spelling is appended, so the characters are never reread.
+  template<typename H>
+  inline void
+  hash_append(H& h, const Symbol_string& str)
+  {
+    hash_append(h, str.hash());
+  }
+
+
   /// Represents a symbol in the language. Because all symbols have unique
-  /// values, the value of a symbol is its identity. 
-  using Symbol = const std::string*;
+  /// values, the value of a symbol is its identity.
+  using Symbol = const Symbol_string*;
 
   std::ostream& operator<<(std::ostream& os, Symbol sym);
 
 
   /// Ensures that all symbols having the same spelling are unique.
+  ///
+  /// The table is divided into shards, selected by the high bits of a
+  /// spelling's hash. Each shard is an open-addressing hash table guarded
+  /// by its own lock, with an append-only arena for its spellings. Symbols
+  /// can be created concurrently from any number of threads, and remain
+  /// valid for the lifetime of the table.
   class Symbol_table
   {
   public:
+    Symbol_table();
+    ~Symbol_table();
+
+    Symbol_table(const Symbol_table&) = delete;
+    Symbol_table& operator=(const Symbol_table&) = delete;
+
+    /// Returns the symbol spelled by the `n` characters at `str`.
+    Symbol get(const char* str, std::size_t n);
+
     /// Returns the symbol corresponding to string.
-    Symbol get(const char* str) { return &*m_syms.insert(str).first; }
-  
+    Symbol get(const char* str) { return get(str, std::strlen(str)); }
+
     /// Returns the symbol corresponding to string.
-    Symbol get(const std::string& str) { return &*m_syms.insert(str).first; }
+    Symbol get(const std::string& str) { return get(str.data(), str.size()); }
+
+    /// Returns the number of symbols in the table.
+    std::size_t size() const;
+
+    /// Returns statistics about the table, summed over its shards.
+    Intern_statistics get_statistics() const;
 
   private:
-    std::unordered_set<std::string> m_syms;
+    struct Shard;
+
+    static constexpr int shard_bits = 6;
+    static constexpr std::size_t shard_count = std::size_t(1) << shard_bits;
+
+    std::unique_ptr<Shard[]> m_shards;
+
+    /// The id of the next symbol.
+    std::atomic<std::uint32_t> m_next_id;
   };
 
 
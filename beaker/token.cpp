@@ -172,7 +172,13 @@ namespace beaker
     case func_kw: return std::strlen("func");
     case goto_kw: return std::strlen("goto");
     case if_kw: return std::strlen("if");
+    case import_kw: return std::strlen("import");
     case int_kw: return std::strlen("int");
+    case int8_kw: return std::strlen("int8");
+    case int16_kw: return std::strlen("int16");
+    case int32_kw: return std::strlen("int32");
+    case int64_kw: return std::strlen("int64");
+    case int128_kw: return std::strlen("int128");
     case namespace_kw: return std::strlen("namespace");
     case new_kw: return std::strlen("new");
     case operator_kw: return std::strlen("operator");
@@ -264,6 +270,7 @@ namespace beaker
     case default_kw: return "default";
     case delete_kw: return "delete";
     case do_kw: return "do";
+    case double_kw: return "double";
     case else_kw: return "else";
     case enum_kw: return "enum";
     case export_kw: return "export";
@@ -274,7 +281,13 @@ namespace beaker
     case func_kw: return "func";
     case goto_kw: return "goto";
     case if_kw: return "if";
+    case import_kw: return "import";
     case int_kw: return "int";
+    case int8_kw: return "int8";
+    case int16_kw: return "int16";
+    case int32_kw: return "int32";
+    case int64_kw: return "int64";
+    case int128_kw: return "int128";
     case namespace_kw: return "namespace";
     case new_kw: return "new";
     case operator_kw: return "operator";
@@ -5,6 +5,7 @@
 #include <beaker/location.hpp>
 
 #include <cassert>
+#include <cstdint>
 #include <iosfwd>
 #include <utility>
 
@@ -101,6 +102,7 @@ namespace beaker
       func_kw,
       goto_kw,
       if_kw,
+      import_kw,
       int_kw,
       int8_kw,
       int16_kw,
@@ -317,6 +319,93 @@ namespace beaker
 
   using Token_seq = std::vector<Token>;
 
+  // ------------------------------------------------------------------------ //
+  // Token buffer
+
+  /// A half-open range [begin, end) of indexes into a token buffer.
+  struct Token_range
+  {
+    std::size_t size() const { return end - begin; }
+    bool empty() const { return begin == end; }
+
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  /// Stores the tokens of a file as parallel arrays of names, offsets, and
+  /// symbols. Tokens are reconstructed on access. Scanning the names for
+  /// lookahead touches a single byte per token.
+  ///
+  /// The last token in a complete buffer is the end-of-file token.
+  class Token_buffer
+  {
+  public:
+    /// Returns the number of tokens in the buffer.
+    std::size_t size() const { return m_names.size(); }
+
+    /// Returns true if the buffer is empty.
+    bool empty() const { return m_names.empty(); }
+
+    /// Reserves space for `n` tokens.
+    void reserve(std::size_t n);
+
+    /// Appends `tok` to the buffer.
+    void push_back(const Token& tok);
+
+    /// Returns the name of the ith token.
+    Token::Name get_name(std::size_t i) const { return (Token::Name)m_names[i]; }
+
+    /// Returns the location of the ith token.
+    Location get_location(std::size_t i) const { return Location(m_offsets[i]); }
+
+    /// Returns the ith token.
+    Token get_token(std::size_t i) const;
+
+    /// Appends the tokens in `buf` to the buffer.
+    void append(const Token_buffer& buf);
+
+  private:
+    static_assert(Token::raw_string <= UINT8_MAX, "token names must fit in a byte");
+
+    std::vector<std::uint8_t> m_names;
+    std::vector<unsigned> m_offsets;
+    std::vector<Symbol> m_syms;
+  };
+
+  inline void
+  Token_buffer::reserve(std::size_t n)
+  {
+    m_names.reserve(n);
+    m_offsets.reserve(n);
+    m_syms.reserve(n);
+  }
+
+  inline void
+  Token_buffer::push_back(const Token& tok)
+  {
+    m_names.push_back(tok.get_name());
+    m_offsets.push_back(tok.get_location().get_offset());
+    m_syms.push_back(tok.is_basic() ? nullptr : tok.get_symbol());
+  }
+
+  inline void
+  Token_buffer::append(const Token_buffer& buf)
+  {
+    m_names.insert(m_names.end(), buf.m_names.begin(), buf.m_names.end());
+    m_offsets.insert(m_offsets.end(), buf.m_offsets.begin(), buf.m_offsets.end());
+    m_syms.insert(m_syms.end(), buf.m_syms.begin(), buf.m_syms.end());
+  }
+
+  inline Token
+  Token_buffer::get_token(std::size_t i) const
+  {
+    Token::Name n = get_name(i);
+    if (Symbol sym = m_syms[i])
+      return Token(n, get_location(i), sym);
+    else
+      return Token(n, get_location(i));
+  }
+
   // ------------------------------------------------------------------------ //
   // Token factory
 
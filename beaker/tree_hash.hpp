@@ -0,0 +1,90 @@
+#pragma once
+
+#include <beaker/hash.hpp>
+#include <beaker/type.hpp>
+#include <beaker/expression.hpp>
+#include <beaker/conversion.hpp>
+#include <beaker/initializer.hpp>
+
+namespace beaker
+{
+  /// Appends the structure of `e` to `h`. Operands are appended
+  /// recursively, while types and declarations, which are unique, are
+  /// appended by identity. Tokens and locations are not appended, so the
+  /// same expression written in two places has the same hash code.
+  template<typename H>
+  void
+  hash_append(H& h, const Expression& e)
+  {
+    hash_append(h, e.get_kind());
+    hash_append(h, e.get_type());
+    switch (e.get_kind()) {
+    case Expression::bool_kind:
+      return hash_append(h, static_cast<const Bool_literal&>(e).get_value());
+    case Expression::int_kind:
+      return hash_append(h, static_cast<const Int_literal&>(e).get_value());
+    case Expression::id_kind:
+    case Expression::init_kind:
+      return hash_append(h, static_cast<const Id_expression&>(e).get_declaration());
+    case Expression::fold_kind: {
+      const Folded_expression& f = static_cast<const Folded_expression&>(e);
+      hash_append(h, f.get_value().get_int());
+      return hash_append(h, *f.get_expression());
+    }
+
+    case Expression::neg_kind:
+    case Expression::rec_kind:
+    case Expression::bit_not_kind:
+    case Expression::not_kind:
+      return hash_append(h, *static_cast<const Unary_expression&>(e).get_operand());
+
+    case Expression::add_kind:
+    case Expression::sub_kind:
+    case Expression::mul_kind:
+    case Expression::quo_kind:
+    case Expression::rem_kind:
+    case Expression::div_kind:
+    case Expression::bit_and_kind:
+    case Expression::bit_ior_kind:
+    case Expression::bit_xor_kind:
+    case Expression::bit_shl_kind:
+    case Expression::bit_shr_kind:
+    case Expression::and_kind:
+    case Expression::or_kind:
+    case Expression::eq_kind:
+    case Expression::ne_kind:
+    case Expression::lt_kind:
+    case Expression::gt_kind:
+    case Expression::ng_kind:
+    case Expression::nl_kind:
+    case Expression::assign_kind: {
+      const Binary_expression& b = static_cast<const Binary_expression&>(e);
+      hash_append(h, *b.get_lhs());
+      return hash_append(h, *b.get_rhs());
+    }
+
+    case Expression::cond_kind: {
+      const Ternary_expression& t = static_cast<const Ternary_expression&>(e);
+      hash_append(h, *t.get_first());
+      hash_append(h, *t.get_second());
+      return hash_append(h, *t.get_third());
+    }
+
+    case Expression::imp_conv: {
+      const Conversion& c = static_cast<const Conversion&>(e);
+      hash_append(h, c.get_conversion_kind());
+      return hash_append(h, *c.get_source());
+    }
+
+    case Expression::empty_init:
+    case Expression::def_init:
+      return hash_append(h, *static_cast<const Initializer&>(e).get_object());
+    case Expression::val_init: {
+      const Value_initializer& i = static_cast<const Value_initializer&>(e);
+      hash_append(h, *i.get_object());
+      return hash_append(h, *i.get_value());
+    }
+    }
+  }
+
+} // namespace beaker
@@ -80,67 +80,28 @@ namespace beaker
     return equal_types(this, &t);
   }
 
-  static void hash_type(Hasher& h, const Type* t);
-
-  static void
-  hash_int(Hasher& h, const Int_type* t)
-  {
-    hash_append(h, t->get_rank());
-  }
-
-  static void
-  hash_float(Hasher& h, const Float_type* t)
-  {
-    hash_append(h, t->get_rank());    
-  }
-
-  static void
-  hash_function(Hasher& h, const Function_type* t)
-  {
-    hash_append(h, t->get_return_type());
-    const Type_seq& parms = t->get_parameter_types();
-    std::for_each(parms.begin(), parms.end(), [&h](const Type* t) {
-      hash_append(h, t);
-    });
-  }
-
-  static void
-  hash_reference(Hasher& h, const Reference_type* t)
-  {
-    hash_append(h, t->get_object_type());
-  }
-
-  static void
-  hash_type(Hasher& h, const Type* t)
+  std::size_t
+  hash_type(Type::Kind k, int rank)
   {
-    hash_append(h, t->get_kind());
-    switch (t->get_kind()) {
-    case Type::unit_kind:
-    case Type::bool_kind:
-    case Type::auto_kind:
-      return;
-    case Type::int_kind:
-      return hash_int(h, static_cast<const Int_type*>(t));
-    case Type::float_kind:
-      return hash_float(h, static_cast<const Float_type*>(t));
-    case Type::func_kind:
-      return hash_function(h, static_cast<const Function_type*>(t));
-    case Type::ref_kind:
-      return hash_reference(h, static_cast<const Reference_type*>(t));
-    }
+    Hasher h;
+    hash_append_type(h, k, rank);
+    return static_cast<std::size_t>(h);
   }
 
   std::size_t
-  Type::hash() const
+  hash_function_type(Type* const* parms, std::size_t n, const Type* ret)
   {
-    Hash<const Type*> h;
-    return h(this);
+    Hasher h;
+    hash_append_function_type(h, parms, n, ret);
+    return static_cast<std::size_t>(h);
   }
 
-  void
-  Type::hash(Hasher& h)
+  std::size_t
+  hash_reference_type(const Type* t)
   {
-    return hash_type(h, this);
+    Hasher h;
+    hash_append_reference_type(h, t);
+    return static_cast<std::size_t>(h);
   }
 
   void
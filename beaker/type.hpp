@@ -22,8 +22,8 @@ namespace beaker
     };
 
   protected:
-    /// Constructs a type with the given kind.
-    Type(Kind k) : m_kind(k) { }
+    /// Constructs a type with the given kind and hash code.
+    Type(Kind k, std::size_t h) : m_kind(k), m_hash(h) { }
 
   public:
     virtual ~Type() = default;
@@ -74,11 +74,9 @@ namespace beaker
 
     // Hashing
 
-    /// Returns the hash code for this type.
-    std::size_t hash() const;
-
-    /// Appends a hash code to the current object.
-    void hash(Hasher& h);
+    /// Returns the hash code for this type. This is computed once, when
+    /// the type is created.
+    std::size_t hash() const { return m_hash; }
 
     // Debugging
 
@@ -86,14 +84,73 @@ namespace beaker
 
   private:
     Kind m_kind;
+    std::size_t m_hash;
   };
 
 
+  // ------------------------------------------------------------------------ //
+  // Hashing
+  //
+  // The hash code of a type is determined by its structure. Types are
+  // unique, so the types that comprise a type are hashed by identity. The
+  // hash code of a function or reference type can be computed from its
+  // components, without creating the type.
+
+  /// Appends the structure of a type of kind `k` with the given rank (if
+  /// any) to `h`.
+  template<typename H>
+  inline void
+  hash_append_type(H& h, Type::Kind k, int rank = 0)
+  {
+    hash_append(h, k);
+    hash_append(h, rank);
+  }
+
+  /// Appends the structure of the function type `(t1, ..., tn) -> ret`,
+  /// whose parameter types are the `n` types at `parms`, to `h`.
+  template<typename H>
+  inline void
+  hash_append_function_type(H& h, Type* const* parms, std::size_t n, const Type* ret)
+  {
+    hash_append(h, Type::func_kind);
+    hash_append_range(h, parms, parms + n);
+    hash_append(h, ret);
+  }
+
+  /// Appends the structure of the reference type `t&` to `h`.
+  template<typename H>
+  inline void
+  hash_append_reference_type(H& h, const Type* t)
+  {
+    hash_append(h, Type::ref_kind);
+    hash_append(h, t);
+  }
+
+  /// Returns the hash code of a type of kind `k` with the given rank.
+  std::size_t hash_type(Type::Kind k, int rank = 0);
+
+  /// Returns the hash code of the function type `(t1, ..., tn) -> ret`.
+  std::size_t hash_function_type(Type* const* parms, std::size_t n, const Type* ret);
+
+  /// Returns the hash code of the reference type `t&`.
+  std::size_t hash_reference_type(const Type* t);
+
+  /// Appends the hash code of `t` to `h`.
+  template<typename H>
+  inline void
+  hash_append(H& h, const Type& t)
+  {
+    hash_append(h, t.hash());
+  }
+
+
   /// Represents the singleton type `unit`.
   class Unit_type : public Type
   {
   public:
-    Unit_type() : Type(unit_kind) { }
+    static bool classof(const Type* p) { return p->get_kind() == unit_kind; }
+
+    Unit_type() : Type(unit_kind, hash_type(unit_kind)) { }
   };
 
 
@@ -101,7 +158,9 @@ namespace beaker
   class Bool_type : public Type
   {
   public:
-    Bool_type() : Type(bool_kind) { }
+    static bool classof(const Type* p) { return p->get_kind() == bool_kind; }
+
+    Bool_type() : Type(bool_kind, hash_type(bool_kind)) { }
   };
 
 
@@ -109,6 +168,8 @@ namespace beaker
   class Int_type : public Type
   {
   public:
+    static bool classof(const Type* p) { return p->get_kind() == int_kind; }
+
     enum Rank
     {
       int8 = 8,
@@ -119,7 +180,7 @@ namespace beaker
     };
 
     /// Construct an integer type with the given precision.
-    Int_type(Rank r) : Type(int_kind), m_rank(r) { }
+    Int_type(Rank r) : Type(int_kind, hash_type(int_kind, r)), m_rank(r) { }
 
     /// Returns the rank of the integer type.
     Rank get_rank() const { return m_rank; }
@@ -133,6 +194,8 @@ namespace beaker
   class Float_type : public Type
   {
   public:
+    static bool classof(const Type* p) { return p->get_kind() == float_kind; }
+
     enum Rank
     {
       float16 = 16,
@@ -142,7 +205,7 @@ namespace beaker
     };
 
     /// Construct a float type with the given precision.
-    Float_type(Rank r) : Type(float_kind), m_rank(r) { }
+    Float_type(Rank r) : Type(float_kind, hash_type(float_kind, r)), m_rank(r) { }
 
     /// Returns the rank of the floating point type.
     Rank get_rank() const { return m_rank; }
@@ -156,7 +219,9 @@ namespace beaker
   class Auto_type : public Type
   {
   public:
-    Auto_type() : Type(auto_kind) { }
+    static bool classof(const Type* p) { return p->get_kind() == auto_kind; }
+
+    Auto_type() : Type(auto_kind, hash_type(auto_kind)) { }
   };
 
 
@@ -164,12 +229,16 @@ namespace beaker
   class Function_type : public Type
   {
   public:
+    static bool classof(const Type* p) { return p->get_kind() == func_kind; }
+
     Function_type(const Type_seq& parms, Type* ret)
-      : Type(func_kind), m_parms(parms), m_ret(ret)
+      : Type(func_kind, hash_function_type(parms.data(), parms.size(), ret)),
+        m_parms(parms), m_ret(ret)
     { }
 
     Function_type(Type_seq&& parms, Type* ret)
-      : Type(func_kind), m_parms(std::move(parms)), m_ret(ret)
+      : Type(func_kind, hash_function_type(parms.data(), parms.size(), ret)),
+        m_parms(std::move(parms)), m_ret(ret)
     { }
 
     /// Returns the list of parameter types.
@@ -194,8 +263,10 @@ namespace beaker
   class Reference_type : public Type
   {
   public:
+    static bool classof(const Type* p) { return p->get_kind() == ref_kind; }
+
     Reference_type(Type* t)
-      : Type(ref_kind), m_obj(t)
+      : Type(ref_kind, hash_reference_type(t)), m_obj(t)
     { }
 
     Type* get_object_type() const { return m_obj; }
@@ -205,4 +276,5 @@ namespace beaker
     Type* m_obj;
   };
 
+
 } // namespace beaker
@@ -86,11 +86,11 @@ namespace beaker
 
       std::stringstream ss;
       ss << "unexpected type-specifier-list";
-      throw std::runtime_error(ss.str());
+      syntax_error(ss.str());
     }
 
     default:
-      throw std::runtime_error("expected basic-type");
+      syntax_error("expected basic-type");
     }
   }
 
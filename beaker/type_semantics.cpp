@@ -15,31 +15,31 @@ namespace beaker
   Semantics::on_reference_type(Type_specifier* ts, const Token& tok)
   {
     Type* t = m_cxt.get_reference_type(ts->get_type());
-    return new Reference_type_specifier(t, ts, tok.get_location());
+    return m_cxt.make<Reference_type_specifier>(t, ts, tok.get_location());
   }
 
   Type_specifier*
   Semantics::on_unit_type(const Token& tok)
   {
-    return new Simple_type_specifier(m_cxt.get_unit_type(), tok.get_location());
+    return m_cxt.get_simple_type_specifier(m_cxt.get_unit_type());
   }
   
   Type_specifier*
   Semantics::on_bool_type(const Token& tok)
   {
-    return new Simple_type_specifier(m_cxt.get_bool_type(), tok.get_location());
+    return m_cxt.get_simple_type_specifier(m_cxt.get_bool_type());
   }
   
   Type_specifier*
   Semantics::on_int_type(const Token& tok)
   {
-    return new Simple_type_specifier(m_cxt.get_int_type(), tok.get_location());
+    return m_cxt.get_simple_type_specifier(m_cxt.get_int_type());
   }
   
   Type_specifier*
   Semantics::on_float_type(const Token& tok)
   {
-    return new Simple_type_specifier(m_cxt.get_float_type(), tok.get_location());
+    return m_cxt.get_simple_type_specifier(m_cxt.get_float_type());
   }
   
   Type_specifier*
@@ -64,10 +64,10 @@ namespace beaker
     Type* t = m_cxt.get_function_type(std::move(ptypes), rtype);
 
     /// Construct the type specifier.
-    return new Function_type_specifier(t, std::move(parms), ret, 
-                                       lparen.get_location(), 
-                                       rparen.get_location(), 
-                                       arrow.get_location());
+    return m_cxt.make<Function_type_specifier>(t, m_cxt.make_span(parms), ret, 
+                                               lparen.get_location(), 
+                                               rparen.get_location(), 
+                                               arrow.get_location());
   }
 
   Type_specifier*
@@ -90,7 +90,7 @@ namespace beaker
     
     std::stringstream ss;
     ss << *t << " is not a reference type";
-    throw std::runtime_error(ss.str());
+    error(e->get_location(), ss.str());
   }
 
   Expression*
@@ -105,7 +105,7 @@ namespace beaker
     
     std::stringstream ss;
     ss << *t << " is not a reference to " << *t;
-    throw std::runtime_error(ss.str());
+    error(e->get_location(), ss.str());
   }
 
   Expression*
@@ -120,7 +120,7 @@ namespace beaker
     
     std::stringstream ss;
     ss << *t << " is not an integer type";
-    throw std::runtime_error(ss.str());
+    error(e->get_location(), ss.str());
   }
 
   Expression_pair
@@ -135,7 +135,7 @@ namespace beaker
 
     std::stringstream ss;
     ss << "common type " << *t << " is not an integer type";
-    throw std::runtime_error(ss.str());
+    error(e1->get_location(), ss.str());
   }
 
   Expression_pair
@@ -148,7 +148,7 @@ namespace beaker
     
     std::stringstream ss;
     ss << "" << *e1->get_type() << " is not the same as " << *e2->get_type();
-    throw std::runtime_error(ss.str());
+    error(e1->get_location(), ss.str());
   }
 
 } // namespace beaker
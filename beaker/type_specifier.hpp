@@ -2,6 +2,7 @@
 
 #include <beaker/common.hpp>
 #include <beaker/location.hpp>
+#include <beaker/arena.hpp>
 
 namespace beaker
 {
@@ -52,22 +53,17 @@ namespace beaker
   };
 
 
-  /// Represents a simple type specifier.
+  /// Represents a simple type specifier. These are unique within a context:
+  /// every spelling of e.g., `int` denotes the same specifier, which has
+  /// no location.
   class Simple_type_specifier : public Type_specifier
   {
   public:
-    Simple_type_specifier(Type* t, Location loc)
+    static bool classof(const Type_specifier* p) { return p->get_kind() == simple_kind; }
+
+    Simple_type_specifier(Type* t)
       : Type_specifier(simple_kind, t)
     { }
-
-    /// Returns the start location of the this statement.
-    Location get_start_location() const override { return m_loc; }
-    
-    /// Returns the end location of the this statement.
-    Location get_end_location() const override { return m_loc; }
-
-  private:
-    Location m_loc;
   };
 
 
@@ -75,6 +71,8 @@ namespace beaker
   class Reference_type_specifier : public Type_specifier
   {
   public:
+    static bool classof(const Type_specifier* p) { return p->get_kind() == ref_kind; }
+
     Reference_type_specifier(Type* t, Type_specifier* ts, Location loc)
       : Type_specifier(ref_kind, t), m_ts(ts), m_loc(loc)
     { }
@@ -101,25 +99,17 @@ namespace beaker
   class Function_type_specifier : public Type_specifier
   {
   public:
-    Function_type_specifier(Type* t,
-                            const Type_specifier_seq& parms,
-                            Type_specifier* ret, 
-                            Location lparen, 
-                            Location rparen, 
-                            Location arrow);
+    static bool classof(const Type_specifier* p) { return p->get_kind() == func_kind; }
 
     Function_type_specifier(Type* t,
-                            Type_specifier_seq&& parms,
+                            Type_specifier_list parms,
                             Type_specifier* ret, 
                             Location lparen, 
                             Location rparen, 
                             Location arrow);
 
     /// Returns the parameter types of the specifier.
-    const Type_specifier_seq& get_parameter_types() const { return m_parms; }
-
-    /// Returns the parameter types of the specifier.
-    Type_specifier_seq& get_parameter_types() { return m_parms; }
+    Type_specifier_list get_parameter_types() const { return m_parms; }
 
     /// Returns the return type specifier.
     Type_specifier* get_return_type() const { return m_ret; }
@@ -133,43 +123,37 @@ namespace beaker
     Location get_end_location() const override { return m_ret->get_end_location(); }
 
   private:
+    /// The locations of the left paren, right paren, and arrow tokens,
+    /// respectively.
+    Location m_locs[3];
+
     /// The parameter type specifiers.
-    Type_specifier_seq m_parms;
+    Type_specifier_list m_parms;
     
     /// The return type specifier.
     Type_specifier* m_ret;
-    
-    /// The locations of the left paren, right paren, and arrow tokens,
-    /// respectively.
-    Location m_locs[3];
   };
 
   inline
   Function_type_specifier::
   Function_type_specifier(Type* t,
-                          const Type_specifier_seq& parms,
+                          Type_specifier_list parms,
                           Type_specifier* ret, 
                           Location lparen, 
                           Location rparen, 
                           Location arrow)
     : Type_specifier(func_kind, t), 
+      m_locs{lparen, rparen, arrow},
       m_parms(parms), 
-      m_ret(ret),
-      m_locs{lparen, rparen, arrow}
+      m_ret(ret)
   { }
 
-  inline
-  Function_type_specifier::
-  Function_type_specifier(Type* t,
-                          Type_specifier_seq&& parms,
-                          Type_specifier* ret, 
-                          Location lparen, 
-                          Location rparen, 
-                          Location arrow)
-    : Type_specifier(func_kind, t), 
-      m_parms(std::move(parms)), 
-      m_ret(ret),
-      m_locs{lparen, rparen, arrow}
-  { }
+
+  /// Type specifiers own no resources, so they are never destroyed by an
+  /// arena.
+  template<typename T>
+  struct Arena_destroy<T, std::enable_if_t<std::is_base_of<Type_specifier, T>::value>>
+    : std::false_type
+  { };
 
 } // namespace beaker
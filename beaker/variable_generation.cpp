@@ -6,6 +6,7 @@
 #include "initializer.hpp"
 #include "declaration.hpp"
 #include "evaluation.hpp"
+#include "context.hpp"
 
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -93,6 +94,16 @@ namespace beaker
     assert(false);
   }
 
+  /// Throws an exception explaining that `d` could not be initialized
+  /// because of `err`. The error is reported at the name of `d`.
+  [[noreturn]] static void
+  initialization_error(Context& cxt, const Data_declaration* d, const std::runtime_error& err)
+  {
+    std::stringstream ss;
+    ss << "cannot initialize '" << *d->get_name() << "' (" << err.what() << ')';
+    throw Source_error(cxt.get_source_location(d->get_name_location()), ss.str());
+  }
+
   void
   Variable_context::generate_variable(const Variable_declaration* d)
   {
@@ -118,22 +129,28 @@ namespace beaker
     // to worry about until we have classes, however.
   }
 
+  /// Uses of the value are replaced by its constant. The constant is also
+  /// emitted as read-only data whose address is not significant.
   void
   Variable_context::generate_value(const Value_declaration* d)
   {
-    // Evaluate the initializer as a constant and associate with the 
-    // declaration. Note that no storage is associated with the value.
+    Constant_evaluator eval(get_beaker_context());
     Value v;
     try {
-      v = evaluate(get_beaker_context(), d->get_initializer());
+      v = eval.evaluate(d->get_initializer());
     }
     catch (std::runtime_error& err) {
-      std::stringstream ss;
-      ss << "cannot initialize constant " << '(' << err.what() << ')';
-      throw std::runtime_error(ss.str());
+      initialization_error(get_beaker_context(), d, err);
     }
     llvm::Constant* c = generate_constant(d->get_type(), v);
     get_module_context().declare(d, c);
+
+    // FIXME: Implement internal and other forms of linkage.
+    llvm::Module* mod = get_llvm_module();
+    std::string name = generate_external_name(d);
+    auto link = llvm::GlobalValue::ExternalLinkage;
+    m_llvm = new llvm::GlobalVariable(*mod, c->getType(), true, link, c, name);
+    m_llvm->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
   }
 
   // FIXME: Can we clean this up a bit?
@@ -141,15 +158,15 @@ namespace beaker
   Variable_context::generate_reference(const Reference_declaration* d)
   {
     // Evaluate the initializer as a constant and associate with the 
-    // declaration. Note that no storage is associated with the value.
+    // declaration. Note that no storage is associated with the value. The
+    // referenced object is owned by the evaluator.
+    Constant_evaluator eval(get_beaker_context());
     Value val;
     try {
-      val = evaluate(get_beaker_context(), d->get_initializer());
+      val = eval.evaluate(d->get_initializer());
     }
     catch (std::runtime_error& err) {
-      std::stringstream ss;
-      ss << "cannot initialize constant " << '(' << err.what() << ')';
-      throw std::runtime_error(ss.str());
+      initialization_error(get_beaker_context(), d, err);
     }
 
     // The value of the reference is the address of the corresponding
@@ -165,48 +182,21 @@ namespace beaker
     get_module_context().declare(d, c);
   }
 
+  /// Variables read by the initializer are elaborated by the evaluator, so
+  /// their initial values are known.
   llvm::Constant*
   Variable_context::generate_static_initializer(const Variable_declaration* d)
   {
-    if (llvm::Constant* init = generate_constant_initializer(d))
-      return init;
-
-    // Request the construction of a dynamic constructor.
-    assert(d->is_variable());
-    const auto* var = static_cast<const Variable_declaration*>(d);
-    get_module_context().add_constructor(var);
-    
-    // The static object is zero-initialized.
-    return generate_zero_initializer(d);
-  }
-
-  llvm::Constant*
-  Variable_context::generate_constant_initializer(const Variable_declaration* d)
-  {
-    llvm::Constant* init;
+    Static_evaluator eval(get_beaker_context());
+    Value val;
     try {
-      // Elaborate the declaration in order to generate a constant.
-      Constant_evaluator eval(get_beaker_context());
       eval.elaborate(d);
-      Value val = eval.fetch(d);
-
-      // For variables, generate the constant from the stored value. Otherwise,
-      // the value is just the associated constant.
-      if (const auto* var = dynamic_cast<const Variable_declaration*>(d))
-        init = generate_constant(val.get_reference());
-      else
-        init = generate_constant(d->get_type(), val);
+      val = eval.fetch(d);
     }
     catch (std::runtime_error& err) {
-      init = nullptr;
+      initialization_error(get_beaker_context(), d, err);
     }
-    return init;
-  }
-
-  llvm::Constant*
-  Variable_context::generate_zero_initializer(const Variable_declaration* d)
-  {
-    return get_llvm_zero(generate_type(d->get_type()));
+    return generate_constant(val.get_reference());
   }
 
 } // namespace beaker
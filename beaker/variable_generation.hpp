@@ -65,11 +65,9 @@ namespace beaker
     void generate_value(const Value_declaration* d);
     void generate_reference(const Reference_declaration* d);
 
+    /// Generates the initial value of the variable `d`. The initializer is
+    /// evaluated statically; no code runs to initialize a variable.
     llvm::Constant* generate_static_initializer(const Variable_declaration* d);
-    llvm::Constant* generate_constant_initializer(const Variable_declaration* d);
-    llvm::Constant* generate_zero_initializer(const Variable_declaration* d);
-
-    void generate_dynamic_initializer(const Variable_declaration* d);
 
   private:
     /// The parent context.
@@ -0,0 +1,21 @@
+#!/usr/bin/env bash
+#
+# Writes a copy of a file with one byte inverted to stdout. Usage:
+#
+#     flip_byte.sh <file> <offset> [<value>]
+#
+# If a value is given, the byte is replaced by that value instead.
+#
+# Tests use this to check that corrupted binary files are diagnosed rather
+# than crashing the compiler.
+
+set -e
+
+file=$1
+off=$2
+
+byte=$(od -An -tu1 -j "$off" -N1 "$file")
+val=${3:-$((255 - byte))}
+head -c "$off" "$file"
+printf "\\$(printf '%03o' "$val")"
+tail -c +$((off + 2)) "$file"
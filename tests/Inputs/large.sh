@@ -0,0 +1,26 @@
+#!/usr/bin/env bash
+#
+# Writes a generated module of <n> globals and functions to stdout. Usage:
+#
+#     large.sh <n>
+#
+# Tests use this to check that parallel lexing, parsing, and compilation
+# of large inputs produce the same output as doing so serially.
+
+set -e
+
+seq 1 "$1" | awk '{
+  printf "# Declarations %d.\n", $1
+  printf "var g%d : int = %d;\n", $1, $1
+  printf "val k%d : bool = %d > 100;\n\n", $1, $1
+  printf "func f%d(a : int) -> int {\n", $1
+  printf "  var x : int = a * %d + g%d;\n", $1 % 97, $1
+  printf "  while (x > 100) {\n"
+  printf "    if (k%d)\n", $1
+  printf "      x = 0;\n"
+  printf "    else\n"
+  printf "      x = x - 7;\n"
+  printf "  }\n"
+  printf "  return x;\n"
+  printf "}\n\n"
+}'
@@ -0,0 +1,49 @@
+#!/usr/bin/env bash
+#
+# Runs a single test. Usage:
+#
+#     run_test.sh <test> <bin-dir> <FileCheck> <not> <temp-dir>
+#
+# Each line of <test> containing "RUN:" holds a shell command. The commands
+# are run in order, and the test fails when any of them fails. Before a
+# command is run, these substitutions are made:
+#
+#     %s          the path of the test
+#     %S          the directory containing the test
+#     %t          a scratch directory for the test, created empty
+#     %compile    beaker.compile
+#     %run        beaker.run
+#     %FileCheck  FileCheck
+#     %not        not, which inverts the status of a command
+
+set -e
+
+test=$1
+bin=$2
+filecheck=$3
+not=$4
+temp=$5
+
+rm -rf "$temp"
+mkdir -p "$temp"
+
+script="$temp.sh"
+{
+  echo "set -e -o pipefail"
+  echo "cd \"$temp\""
+  grep 'RUN:' "$test" | sed -e 's/^.*RUN: *//' \
+    -e "s|%compile|$bin/beaker.compile|g" \
+    -e "s|%run|$bin/beaker.run|g" \
+    -e "s|%FileCheck|$filecheck|g" \
+    -e "s|%not|$not|g" \
+    -e "s|%s|$test|g" \
+    -e "s|%S|$(dirname "$test")|g" \
+    -e "s|%t|$temp|g"
+} > "$script"
+
+if ! grep -q 'RUN:' "$test"; then
+  echo "$test: no RUN lines" >&2
+  exit 1
+fi
+
+exec bash -x "$script"